@@ -77,6 +77,9 @@ BUILD_SRC = \
     source/build/src/pragmas.cpp \
     source/build/src/scriptfile.cpp \
     source/build/src/mutex.cpp \
+    source/build/src/threadpool.cpp \
+    source/build/src/pvs.cpp \
+    source/build/src/sectgrid.cpp \
     source/build/src/xxhash.c \
     source/build/src/voxmodel.cpp \
     source/build/src/rev.cpp \
@@ -132,6 +135,7 @@ AUDIOLIB_SRC = \
     source/audiolib/src/multivoc.cpp \
     source/audiolib/src/mix.cpp \
     source/audiolib/src/mixst.cpp \
+    source/audiolib/src/stream.cpp \
     source/audiolib/src/pitch.cpp \
     source/audiolib/src/formats.cpp \
     source/audiolib/src/vorbis.cpp \
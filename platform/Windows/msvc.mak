@@ -245,6 +245,7 @@ AUDIOLIB_OBJS=$(AUDIOLIB_OBJ)\drivers.$o \
 	$(AUDIOLIB_OBJ)\multivoc.$o \
 	$(AUDIOLIB_OBJ)\mix.$o \
 	$(AUDIOLIB_OBJ)\mixst.$o \
+	$(AUDIOLIB_OBJ)\stream.$o \
 	$(AUDIOLIB_OBJ)\pitch.$o \
 	$(AUDIOLIB_OBJ)\formats.$o \
 	$(AUDIOLIB_OBJ)\vorbis.$o \
@@ -36,6 +36,10 @@ typedef enum
 
 extern int32_t ASS_SoundDriver;
 
+// Frames the driver is asked to buffer ahead of the sound card, 0 for its own
+// default. SoundDriver_Init() replaces it with the number actually used.
+extern int32_t ASS_BufferFrames;
+
 int32_t SoundDriver_IsSupported(int32_t driver);
 
 int32_t SoundDriver_GetError(void);
@@ -109,10 +109,23 @@ static FORCE_INLINE int32_t FX_Pan3D(int32_t handle, int32_t angle, int32_t dist
 {
     return FX_CheckMVErr(MV_Pan3D(handle, angle, distance));
 }
+static FORCE_INLINE int32_t FX_Pan3DVoices(int32_t const *handles, int32_t const *angles, int32_t const *distances, int32_t count)
+{
+    return FX_CheckMVErr(MV_Pan3DVoices(handles, angles, distances, count));
+}
 static FORCE_INLINE int32_t FX_SoundActive(int32_t handle) { return MV_VoicePlaying(handle); }
 static FORCE_INLINE int32_t FX_SoundsPlaying(void) { return MV_VoicesPlaying(); }
 static FORCE_INLINE int32_t FX_StopSound(int32_t handle) { return FX_CheckMVErr(MV_Kill(handle)); }
 static FORCE_INLINE int32_t FX_StopAllSounds(void) { return FX_CheckMVErr(MV_KillAllVoices()); }
+static FORCE_INLINE int32_t FX_ConvertSound(char const *ptr, uint32_t length, int32_t pitchoffset, char *dest)
+{
+    return MV_ConvertSound(ptr, length, pitchoffset, dest);
+}
+static FORCE_INLINE int32_t FX_MixBenchmark(int32_t numvoices, int32_t numbuffers) { return MV_MixBenchmark(numvoices, numbuffers); }
+static FORCE_INLINE void FX_SetBufferFrames(int32_t frames, int32_t adaptive) { MV_SetBufferFrames(frames, adaptive); }
+static FORCE_INLINE int32_t FX_Update(void) { return MV_Update(); }
+static FORCE_INLINE int32_t FX_GetStats(mvstats_t *stats) { return FX_CheckMVErr(MV_GetStats(stats)); }
+static FORCE_INLINE void FX_ResetStats(void) { MV_ResetStats(); }
 
 #ifdef __cplusplus
 }
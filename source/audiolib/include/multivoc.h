@@ -66,6 +66,17 @@ enum MV_Errors
     MV_InvalidFile,
 };
 
+typedef struct
+{
+    int32_t pages;         // pages mixed since the last reset
+    int32_t underruns;     // times the driver asked for audio after running dry
+    double  mixms;         // total time spent mixing those pages
+    double  maxmixms;      // longest time spent on one of them
+    int32_t bufferframes;  // frames the driver buffers ahead of the sound card
+    int32_t pageframes;    // frames mixed at a time
+    int32_t mixrate;
+} mvstats_t;
+
 extern void (*MV_Printf)(const char *fmt, ...);
 const char *MV_ErrorString(int32_t ErrorNumber);
 int32_t MV_VoicePlaying(int32_t handle);
@@ -79,6 +90,7 @@ int32_t MV_PauseVoice(int32_t handle, int32_t pause);
 int32_t MV_EndLooping(int32_t handle);
 int32_t MV_SetPan(int32_t handle, int32_t vol, int32_t left, int32_t right);
 int32_t MV_Pan3D(int32_t handle, int32_t angle, int32_t distance);
+int32_t MV_Pan3DVoices(int32_t const *handles, int32_t const *angles, int32_t const *distances, int32_t count);
 void MV_SetReverb(int32_t reverb);
 int32_t MV_GetMaxReverbDelay(void);
 int32_t MV_GetReverbDelay(void);
@@ -113,6 +125,8 @@ int32_t MV_PlayXMP(char *ptr, uint32_t length, int32_t loopstart, int32_t loopen
 
 int MV_IdentifyXMP(char const *ptr, uint32_t length);
 
+int32_t MV_ConvertSound(char const *ptr, uint32_t length, int32_t pitchoffset, char *dest);
+
 int32_t MV_GetPosition(int32_t handle, int32_t *position);
 int32_t MV_SetPosition(int32_t handle, int32_t position);
 
@@ -126,6 +140,15 @@ int32_t MV_Init(int32_t soundcard, int32_t MixRate, int32_t Voices, int32_t numc
                 void *initdata);
 int32_t MV_Shutdown(void);
 void MV_SetPrintf(void (*function)(const char *fmt, ...));
+int32_t MV_MixBenchmark(int32_t numvoices, int32_t numbuffers);
+
+// frames: how much the driver should buffer, 0 for its default. Applies from
+// the next MV_Init(). With adaptive set, MV_Update() resizes the buffer as
+// playback runs dry or stays healthy, never going below frames.
+void MV_SetBufferFrames(int32_t frames, int32_t adaptive);
+int32_t MV_Update(void);
+int32_t MV_GetStats(mvstats_t *stats);
+void MV_ResetStats(void);
 
 #ifdef __cplusplus
 }
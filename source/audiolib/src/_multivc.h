@@ -40,8 +40,6 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #define T_MONO         2
 #define T_16BITSOURCE  4
 #define T_STEREOSOURCE 8
-#define T_LEFTQUIET    16
-#define T_RIGHTQUIET   32
 #define T_DEFAULT      T_SIXTEENBIT_STEREO
 
 #define MV_MAXPANPOSITION  127  /* formerly 31 */
@@ -116,8 +114,8 @@ typedef struct VoiceNode
 
     const char *sound;
 
-    const int16_t *LeftVolume;
-    const int16_t *RightVolume;
+    float LeftVolume;
+    float RightVolume;
 
     void *rawdataptr;
 
@@ -214,7 +212,38 @@ void MV_ReleaseFLACVoice(VoiceNode *voice);
 void MV_ReleaseXAVoice(VoiceNode *voice);
 void MV_ReleaseXMPVoice(VoiceNode *voice);
 
+// implemented in stream.c
+// Moves the decoding of a voice set up by one of the compressed formats onto
+// the decoder thread. Called just before MV_PlayVoice(); the decoder's pointer
+// back to its voice, if it keeps one, is passed in owner to be redirected.
+void MV_StartStream(VoiceNode *voice, VoiceNode **owner);
+void MV_ReleaseStream(VoiceNode *voice);
+int32_t MV_GetStreamPosition(VoiceNode *voice);
+void MV_SetStreamPosition(VoiceNode *voice, int32_t position);
+void MV_EndStreamLooping(VoiceNode *voice);
+void MV_ShutdownStreams(void);
+playbackstatus MV_GetNextStreamBlock(VoiceNode *voice);
+
+static inline bool MV_IsStreamVoice(VoiceNode const *voice) { return voice->GetSound == MV_GetNextStreamBlock; }
+
+// Voices are mixed into a float bus of MV_MIXBUFFERSIZE frames, which is
+// clamped into the 16-bit mix buffer once all of them are in.
+#define MV_KERNELS_SCALAR 0
+#define MV_KERNELS_VEC4   1  // SSE2 or NEON
+#define MV_KERNELS_AVX2   2
+
+extern int32_t MV_MixKernels;
+
+int32_t MV_DetectMixKernels(void);
+char const *MV_MixKernelName(int32_t kernels);
+
 // implemented in mix.c
+void MV_AccumulateMono(float const *src, uint32_t length);
+void MV_AccumulateMonoToStereo(float const *src, uint32_t length);
+void MV_AccumulateStereo(float const *src, uint32_t length);
+void MV_ClampMixBus(float const *bus, int16_t *dest, int32_t count);
+void MV_ConvertSamples16Bit(int16_t const *src, float *dest, uint32_t count);
+
 uint32_t MV_Mix16BitMono(struct VoiceNode const *voice, uint32_t length);
 uint32_t MV_Mix16BitStereo(struct VoiceNode const *voice, uint32_t length);
 uint32_t MV_Mix16BitMono16(struct VoiceNode const *voice, uint32_t length);
@@ -227,9 +256,9 @@ uint32_t MV_Mix16BitStereo8Stereo(struct VoiceNode const *voice, uint32_t length
 uint32_t MV_Mix16BitMono16Stereo(struct VoiceNode const *voice, uint32_t length);
 uint32_t MV_Mix16BitStereo16Stereo(struct VoiceNode const *voice, uint32_t length);
 
-extern char *MV_MixDestination;  // pointer to the next output sample
-extern const int16_t *MV_LeftVolume;
-extern const int16_t *MV_RightVolume;
+extern float *MV_MixDestination;  // pointer to the next sample on the bus
+extern float MV_LeftVolume;  // gains of the voice being mixed
+extern float MV_RightVolume;
 extern int32_t MV_SampleSize;
 extern int32_t MV_RightChannelOffset;
 
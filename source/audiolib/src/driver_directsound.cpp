@@ -29,6 +29,7 @@
 #include "compat.h"
 
 #include "driver_directsound.h"
+#include "drivers.h"
 #include "multivoc.h"
 
 enum {
@@ -352,7 +353,11 @@ int32_t DirectSoundDrv_PCM_Init(int32_t *mixrate, int32_t *numchannels, void * i
                       DSBCAPS_CTRLPOSITIONNOTIFY |
                       DSBCAPS_GETCURRENTPOSITION2 |
                       DSBCAPS_STICKYFOCUS ;
-    bufdesc.dwBufferBytes = wfex.nBlockAlign * 2560 * 2;
+    if (ASS_BufferFrames <= 0)
+        ASS_BufferFrames = 2560;
+
+    // two halves, each refilled as the other one plays
+    bufdesc.dwBufferBytes = wfex.nBlockAlign * ASS_BufferFrames * 2;
     bufdesc.lpwfxFormat = &wfex;
 
     err = IDirectSound_CreateSoundBuffer(lpds, &bufdesc, &lpdsbsec, 0);
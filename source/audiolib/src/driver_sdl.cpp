@@ -26,6 +26,7 @@
 #include "compat.h"
 #include "sdl_inc.h"
 #include "driver_sdl.h"
+#include "drivers.h"
 #include "multivoc.h"
 
 #ifdef __ANDROID__
@@ -172,13 +173,25 @@ int32_t SDLDrv_PCM_Init(int32_t *mixrate, int32_t *numchannels, void * initdata)
         return SDLErr_Error;
     }
 
-    chunksize = 512;
+    if (ASS_BufferFrames > 0)
+    {
+        // SDL wants a power of two
+        chunksize = 64;
+        while (chunksize < ASS_BufferFrames && chunksize < 8192)
+            chunksize *= 2;
+    }
+    else
+    {
+        chunksize = 512;
 #ifdef __ANDROID__
-    chunksize = droidinfo.audio_buffer_size;
+        chunksize = droidinfo.audio_buffer_size;
 #endif
 
-    if (*mixrate >= 16000) chunksize *= 2;
-    if (*mixrate >= 32000) chunksize *= 2;
+        if (*mixrate >= 16000) chunksize *= 2;
+        if (*mixrate >= 32000) chunksize *= 2;
+    }
+
+    ASS_BufferFrames = chunksize;
 
     err = Mix_OpenAudio(*mixrate, AUDIO_S16SYS, *numchannels, chunksize);
 
@@ -237,6 +250,7 @@ void SDLDrv_PCM_Shutdown(void)
     Mix_CloseAudio();
 
     SDL_DestroyMutex(EffectFence);
+    EffectFence = NULL;
 
     if (StartedSDL > 0) {
         SDL_QuitSubSystem(SDL_INIT_AUDIO);
@@ -34,6 +34,7 @@
 #endif
 
 int32_t ASS_SoundDriver = -1;
+int32_t ASS_BufferFrames = 0;
 
 #define UNSUPPORTED { 0,0,0,0,0,0,0,0, },
 
@@ -628,6 +628,7 @@ int32_t MV_PlayFLAC(char *ptr, uint32_t length, int32_t loopstart, int32_t loope
     MV_SetVoiceMixMode(voice);
 
     MV_SetVoiceVolume(voice, vol, left, right, volume);
+    MV_StartStream(voice, &fd->owner);
     MV_PlayVoice(voice);
 
     return voice->handle;
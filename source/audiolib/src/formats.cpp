@@ -321,12 +321,9 @@ int32_t MV_PlayWAV3D(char *ptr, uint32_t length, int32_t loophow, int32_t pitcho
         MV_PanTable[ angle ][ vol ].left, MV_PanTable[ angle ][ vol ].right, priority, volume, callbackval);
 }
 
-int32_t MV_PlayWAV(char *ptr, uint32_t length, int32_t loopstart, int32_t loopend, int32_t pitchoffset, int32_t vol,
-                   int32_t left, int32_t right, int32_t priority, float volume, uint32_t callbackval)
+// checks that ptr holds a PCM WAV and reads its format and where its data starts
+static int32_t MV_ReadWAVHeader(char const *ptr, format_header *fmt, data_header *dat, char const **sound)
 {
-    if (!MV_Installed)
-        return MV_Error;
-
     riff_header   riff;
     memcpy(&riff, ptr, sizeof(riff_header));
     riff.file_size   = B_LITTLE32(riff.file_size);
@@ -338,7 +335,7 @@ int32_t MV_PlayWAV(char *ptr, uint32_t length, int32_t loopstart, int32_t loopen
         return MV_Error;
     }
 
-    format_header format;
+    format_header &format = *fmt;
     memcpy(&format, ptr + sizeof(riff_header), sizeof(format_header));
     format.wFormatTag      = B_LITTLE16(format.wFormatTag);
     format.nChannels       = B_LITTLE16(format.nChannels);
@@ -347,7 +344,7 @@ int32_t MV_PlayWAV(char *ptr, uint32_t length, int32_t loopstart, int32_t loopen
     format.nBlockAlign     = B_LITTLE16(format.nBlockAlign);
     format.nBitsPerSample  = B_LITTLE16(format.nBitsPerSample);
 
-    data_header   data;
+    data_header &data = *dat;
     memcpy(&data, ptr + sizeof(riff_header) + riff.format_size, sizeof(data_header));
     data.size = B_LITTLE32(data.size);
 
@@ -359,16 +356,14 @@ int32_t MV_PlayWAV(char *ptr, uint32_t length, int32_t loopstart, int32_t loopen
         return MV_Error;
     }
 
-    // Request a voice from the voice pool
+    *sound = ptr + sizeof(riff_header) + riff.format_size + sizeof(data_header);
 
-    VoiceNode     *voice = MV_AllocVoice(priority);
-
-    if (voice == NULL)
-    {
-        MV_SetErrorCode(MV_NoVoices);
-        return MV_Error;
-    }
+    return MV_Ok;
+}
 
+static void MV_SetupWAVVoice(VoiceNode *voice, char const *ptr, uint32_t length, format_header const &format, data_header data,
+                             char const *sound, int32_t loopstart, int32_t loopend, int32_t pitchoffset)
+{
     voice->wavetype    = FMT_WAV;
     voice->bits        = format.nBitsPerSample;
     voice->channels    = format.nChannels;
@@ -388,29 +383,76 @@ int32_t MV_PlayWAV(char *ptr, uint32_t length, int32_t loopstart, int32_t loopen
         blocklen    /= 2;
     }
 
-    voice->rawdataptr = (uint8_t *)ptr;
+    voice->rawdataptr = (void *)(intptr_t)ptr;
     voice->ptrlength  = length;
     voice->Paused      = FALSE;
     voice->LoopCount   = 0;
     voice->position    = 0;
     voice->length      = 0;
     voice->BlockLength = blocklen;
-    voice->NextBlock   = (char *)((intptr_t) ptr + sizeof(riff_header) + riff.format_size + sizeof(data_header));
-    voice->next        = NULL;
-    voice->prev        = NULL;
-    voice->priority    = priority;
-    voice->callbackval = callbackval;
+    voice->NextBlock   = sound;
     voice->LoopStart   = loopstart >= 0 ? voice->NextBlock : NULL;
     voice->LoopEnd     = NULL;
     voice->LoopSize    = loopend > 0 ? loopend - loopstart + 1 : blocklen;
 
     MV_SetVoicePitch(voice, format.nSamplesPerSec, pitchoffset);
+}
+
+int32_t MV_PlayWAV(char *ptr, uint32_t length, int32_t loopstart, int32_t loopend, int32_t pitchoffset, int32_t vol,
+                   int32_t left, int32_t right, int32_t priority, float volume, uint32_t callbackval)
+{
+    if (!MV_Installed)
+        return MV_Error;
+
+    format_header format;
+    data_header   data;
+    char const *  sound;
+
+    if (MV_ReadWAVHeader(ptr, &format, &data, &sound) != MV_Ok)
+        return MV_Error;
+
+    // Request a voice from the voice pool
+
+    VoiceNode     *voice = MV_AllocVoice(priority);
+
+    if (voice == NULL)
+    {
+        MV_SetErrorCode(MV_NoVoices);
+        return MV_Error;
+    }
+
+    MV_SetupWAVVoice(voice, ptr, length, format, data, sound, loopstart, loopend, pitchoffset);
+
+    voice->next        = NULL;
+    voice->prev        = NULL;
+    voice->priority    = priority;
+    voice->callbackval = callbackval;
+
     MV_SetVoiceVolume(voice, vol, left, right, volume);
     MV_PlayVoice(voice);
 
     return voice->handle;
 }
 
+static void MV_SetupVOCVoice(VoiceNode *voice, char const *ptr, uint32_t length, int32_t loopstart, int32_t loopend, int32_t pitchoffset)
+{
+    voice->rawdataptr = (void *)(intptr_t)ptr;
+    voice->ptrlength = length;
+    voice->Paused = FALSE;
+    voice->wavetype    = FMT_VOC;
+    voice->bits        = 8;
+    voice->channels    = 1;
+    voice->GetSound    = MV_GetNextVOCBlock;
+    voice->NextBlock   = ptr + B_LITTLE16(*(uint16_t const *)(ptr + 0x14));
+    voice->LoopCount   = 0;
+    voice->BlockLength = 0;
+    voice->PitchScale  = PITCH_GetScale(pitchoffset);
+    voice->length      = 0;
+    voice->LoopStart   = loopstart >= 0 ? voice->NextBlock : NULL;
+    voice->LoopEnd     = NULL;
+    voice->LoopSize    = loopend - loopstart + 1;
+}
+
 int32_t MV_PlayVOC3D(char *ptr, uint32_t length, int32_t loophow, int32_t pitchoffset, int32_t angle,
                      int32_t distance, int32_t priority, float volume, uint32_t callbackval)
 {
@@ -454,26 +496,12 @@ int32_t MV_PlayVOC(char *ptr, uint32_t length, int32_t loopstart, int32_t loopen
         return MV_Error;
     }
 
-    voice->rawdataptr = (uint8_t *)ptr;
-    voice->ptrlength = length;
-    voice->Paused = FALSE;
-    voice->wavetype    = FMT_VOC;
-    voice->bits        = 8;
-    voice->channels    = 1;
-    voice->GetSound    = MV_GetNextVOCBlock;
-    voice->NextBlock   = ptr + B_LITTLE16(*(uint16_t *)(ptr + 0x14));
-    voice->LoopCount   = 0;
-    voice->BlockLength = 0;
-    voice->PitchScale  = PITCH_GetScale(pitchoffset);
-    voice->length      = 0;
+    MV_SetupVOCVoice(voice, ptr, length, loopstart, loopend, pitchoffset);
+
     voice->next        = NULL;
     voice->prev        = NULL;
     voice->priority    = priority;
     voice->callbackval = callbackval;
-    voice->LoopStart   = loopstart >= 0 ? voice->NextBlock : NULL;
-    voice->LoopEnd     = NULL;
-    voice->LoopSize    = loopend - loopstart + 1;
-
     voice->volume      = volume;
 
     MV_SetVoiceVolume(voice, vol, left, right, volume);
@@ -482,3 +510,132 @@ int32_t MV_PlayVOC(char *ptr, uint32_t length, int32_t loopstart, int32_t loopen
     return voice->handle;
 }
 
+// about 90 seconds at 48kHz
+#define MV_MAXCONVERTFRAMES (1 << 22)
+
+// reads the sample or frame at voice->position into dest as 16-bit PCM
+static inline void MV_ConvertFrame(VoiceNode const *voice, int16_t *dest)
+{
+    uint32_t const index = (voice->position >> 16) * voice->channels;
+
+    for (int c = 0; c < voice->channels; c++)
+    {
+        int16_t const sample = (voice->bits == 16) ? (int16_t)B_LITTLE16(((int16_t const *)voice->sound)[index + c])
+                                                   : (int16_t)(((int32_t)((uint8_t const *)voice->sound)[index + c] - 128) << 8);
+        dest[c] = B_LITTLE16(sample);
+    }
+}
+
+// Steps through the sound set up in voice the way MV_Mix() would, writing
+// what the mixer would read to dest if it isn't NULL. Returns the number of
+// frames, or 0 if the sound can't be converted.
+static uint32_t MV_ConvertVoice(VoiceNode *voice, int32_t channels, int16_t *dest)
+{
+    uint32_t numframes = 0;
+
+    if (voice->GetSound(voice) != KeepPlaying)
+        return 0;
+
+    do
+    {
+        // a VOC repeat block: what gets played depends on how it was started
+        if (voice->LoopStart != NULL || voice->channels != channels || voice->RateScale == 0)
+            return 0;
+
+        for (; voice->position < voice->length; voice->position += voice->RateScale)
+        {
+            if (++numframes > MV_MAXCONVERTFRAMES)
+                return 0;
+
+            if (dest)
+            {
+                MV_ConvertFrame(voice, dest);
+                dest += channels;
+            }
+        }
+    }
+    while (voice->GetSound(voice) == KeepPlaying);
+
+    return numframes;
+}
+
+/*---------------------------------------------------------------------
+   Function: MV_ConvertSound
+
+   Converts a WAV or VOC file to a 16-bit PCM WAV at the mixing rate
+   with the pitch offset applied, which plays back at a pitch offset of
+   0 with no resampling. Returns the size of the converted file, which
+   is only written to dest if that isn't NULL, or 0 if the sound isn't
+   one that can or needs to be converted.
+---------------------------------------------------------------------*/
+int32_t MV_ConvertSound(char const *ptr, uint32_t length, int32_t pitchoffset, char *dest)
+{
+    if (!MV_Installed)
+        return 0;
+
+    VoiceNode voice;
+    Bmemset(&voice, 0, sizeof(VoiceNode));
+
+    if (length > 0x1a && memcmp(ptr, "Creative Voice File", 19) == 0)
+        MV_SetupVOCVoice(&voice, ptr, length, -1, 0, pitchoffset);
+    else
+    {
+        format_header format;
+        data_header   data;
+        char const *  sound;
+
+        if (length < sizeof(riff_header) + sizeof(format_header) + sizeof(data_header))
+            return 0;
+
+        // not being able to convert a sound isn't an error
+        int32_t const status = MV_ErrorCode;
+
+        if (MV_ReadWAVHeader(ptr, &format, &data, &sound) != MV_Ok)
+        {
+            MV_SetErrorCode(status);
+            return 0;
+        }
+
+        // already 16-bit at the mixing rate
+        if (format.nBitsPerSample == 16 && format.nSamplesPerSec == (uint32_t)MV_MixRate && pitchoffset == 0)
+            return 0;
+
+        MV_SetupWAVVoice(&voice, ptr, length, format, data, sound, -1, 0, pitchoffset);
+    }
+
+    VoiceNode const start = voice;
+
+    if (voice.GetSound(&voice) != KeepPlaying)
+        return 0;
+
+    int32_t const channels = voice.channels;
+
+    voice = start;
+
+    uint32_t const numframes = MV_ConvertVoice(&voice, channels, NULL);
+
+    if (numframes == 0)
+        return 0;
+
+    uint32_t const datasize = numframes * channels * sizeof(int16_t);
+    uint32_t const size     = sizeof(riff_header) + sizeof(format_header) + sizeof(data_header) + datasize;
+
+    if (dest == NULL)
+        return size;
+
+    riff_header const riff = { { 'R', 'I', 'F', 'F' }, B_LITTLE32(size - 8), { 'W', 'A', 'V', 'E' },
+                               { 'f', 'm', 't', ' ' }, B_LITTLE32((uint32_t)sizeof(format_header)) };
+    format_header const format = { B_LITTLE16(1), B_LITTLE16((uint16_t)channels), B_LITTLE32((uint32_t)MV_MixRate),
+                                   B_LITTLE32((uint32_t)(MV_MixRate * channels * 2)), B_LITTLE16((uint16_t)(channels * 2)),
+                                   B_LITTLE16(16) };
+    data_header const data = { { 'd', 'a', 't', 'a' }, B_LITTLE32(datasize) };
+
+    Bmemcpy(dest, &riff, sizeof(riff_header));
+    Bmemcpy(dest + sizeof(riff_header), &format, sizeof(format_header));
+    Bmemcpy(dest + sizeof(riff_header) + sizeof(format_header), &data, sizeof(data_header));
+
+    voice = start;
+    MV_ConvertVoice(&voice, channels, (int16_t *)(dest + sizeof(riff_header) + sizeof(format_header) + sizeof(data_header)));
+
+    return size;
+}
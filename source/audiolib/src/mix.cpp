@@ -20,127 +20,367 @@
 
 #include "_multivc.h"
 
-/*
- length = count of samples to mix
- position = offset of starting sample in source
- rate = resampling increment
- volume = direct volume adjustment, 1.0 = no change
- */
+// Each mixing function below reads a voice's samples into a float array and
+// hands it to one of the accumulators, which scale it by the voice's gains and
+// add it to the bus. Resampling means the reads are scalar gathers; the
+// accumulators and the final clamp into the mix buffer are where the vector
+// kernels come in. They do the same float operations in the same order as the
+// scalar loops, so every kernel set produces the same output.
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define MV_SSE2
+# define MV_VEC4
+# define MV_VEC4_NAME "sse2"
+# if EDUKE32_GCC_PREREQ(4,9) || defined __clang__ || (defined _MSC_VER && _MSC_VER >= 1700)
+#  include <immintrin.h>
+#  define MV_AVX2
+#  ifdef _MSC_VER
+#   define MV_AVX2_TARGET
+#  else
+#   define MV_AVX2_TARGET __attribute__((target("avx2")))
+#  endif
+# endif
+#elif defined __ARM_NEON__ || defined __ARM_NEON
+# include <arm_neon.h>
+# define MV_NEON
+# define MV_VEC4
+# define MV_VEC4_NAME "neon"
+#else
+# define MV_VEC4_NAME "vec4"
+#endif
 
-// 8-bit mono source, 16-bit mono output
-uint32_t MV_Mix16BitMono(struct VoiceNode const * const voice, uint32_t length)
+int32_t MV_MixKernels = MV_KERNELS_SCALAR;
+
+int32_t MV_DetectMixKernels(void)
 {
-    auto const source = (uint8_t const *)voice->sound;
-    auto       dest   = (int16_t *)MV_MixDestination;
+#ifdef MV_AVX2
+    if (Bcpuhasavx2())
+        return MV_KERNELS_AVX2;
+#endif
 
-    uint32_t       position = voice->position;
-    uint32_t const rate     = voice->RateScale;
-    float const    volume   = voice->volume;
+#ifdef MV_VEC4
+    return MV_KERNELS_VEC4;
+#else
+    return MV_KERNELS_SCALAR;
+#endif
+}
 
-    do
+char const *MV_MixKernelName(int32_t kernels)
+{
+    static char const *const names[] = { "scalar", MV_VEC4_NAME, "avx2" };
+    return names[clamp(kernels, MV_KERNELS_SCALAR, MV_KERNELS_AVX2)];
+}
+
+#ifdef MV_AVX2
+// dest[i] += src[i] * gain[i & 1] for count floats, count a multiple of 8
+static MV_AVX2_TARGET void MV_Accumulate_AVX2(float const *src, float *dest, uint32_t count, float left, float right)
+{
+    __m256 const gain = _mm256_setr_ps(left, right, left, right, left, right, left, right);
+
+    for (uint32_t i = 0; i < count; i += 8)
+        _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), gain)));
+}
+
+// dest[2i] += src[i] * left, dest[2i+1] += src[i] * right for count samples, count a multiple of 8
+static MV_AVX2_TARGET void MV_AccumulateMonoToStereo_AVX2(float const *src, float *dest, uint32_t count, float left, float right)
+{
+    __m256 const gain = _mm256_setr_ps(left, right, left, right, left, right, left, right);
+
+    for (uint32_t i = 0; i < count; i += 8, dest += 16)
     {
-        uint8_t const usample0 = SCALE_SAMPLE(source[position >> 16], volume);
+        __m256 const s  = _mm256_loadu_ps(src + i);
+        __m256 const lo = _mm256_unpacklo_ps(s, s);  // 0 0 1 1 | 4 4 5 5
+        __m256 const hi = _mm256_unpackhi_ps(s, s);  // 2 2 3 3 | 6 6 7 7
+
+        _mm256_storeu_ps(dest, _mm256_add_ps(_mm256_loadu_ps(dest), _mm256_mul_ps(_mm256_permute2f128_ps(lo, hi, 0x20), gain)));
+        _mm256_storeu_ps(dest + 8, _mm256_add_ps(_mm256_loadu_ps(dest + 8), _mm256_mul_ps(_mm256_permute2f128_ps(lo, hi, 0x31), gain)));
+    }
+}
+#endif
 
-        position += rate;
+// dest[i] += src[i] * gain[i & 1] for count floats, returns how many were done
+static uint32_t MV_AccumulateVector(float const *src, float *dest, uint32_t count, float left, float right)
+{
+    uint32_t i = 0;
 
-        *dest = (int16_t)clamp(SCALE_SAMPLE(MV_LeftVolume[usample0], MV_GlobalVolume) + *dest, INT16_MIN, INT16_MAX);
-        dest += MV_SampleSize >> 1;
+#ifdef MV_AVX2
+    if (MV_MixKernels == MV_KERNELS_AVX2)
+    {
+        i = count & ~7u;
+        MV_Accumulate_AVX2(src, dest, i, left, right);
     }
-    while (--length);
+#endif
 
-    MV_MixDestination = (char *)dest;
+#if defined MV_SSE2
+    if (MV_MixKernels != MV_KERNELS_SCALAR)
+    {
+        __m128 const gain = _mm_setr_ps(left, right, left, right);
 
-    return position;
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_mul_ps(_mm_loadu_ps(src + i), gain)));
+    }
+#elif defined MV_NEON
+    if (MV_MixKernels != MV_KERNELS_SCALAR)
+    {
+        float const gains[4] = { left, right, left, right };
+        float32x4_t const gain = vld1q_f32(gains);
+
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(dest + i, vaddq_f32(vld1q_f32(dest + i), vmulq_f32(vld1q_f32(src + i), gain)));
+    }
+#else
+    UNREFERENCED_PARAMETER(src);
+    UNREFERENCED_PARAMETER(dest);
+    UNREFERENCED_PARAMETER(count);
+    UNREFERENCED_PARAMETER(left);
+    UNREFERENCED_PARAMETER(right);
+#endif
+
+    return i;
 }
 
-// 8-bit mono source, 16-bit stereo output
-uint32_t MV_Mix16BitStereo(struct VoiceNode const * const voice, uint32_t length)
+void MV_AccumulateMono(float const *src, uint32_t length)
 {
-    auto const source = (uint8_t const *)voice->sound;
-    auto       dest   = (int16_t *)MV_MixDestination;
+    auto       dest = MV_MixDestination;
+    auto const gain = MV_LeftVolume;
 
-    uint32_t       position = voice->position;
-    uint32_t const rate     = voice->RateScale;
-    float const    volume   = voice->volume;
+    for (uint32_t i = MV_AccumulateVector(src, dest, length, gain, gain); i < length; i++)
+        dest[i] += src[i] * gain;
 
-    do
+    MV_MixDestination = dest + length;
+}
+
+void MV_AccumulateStereo(float const *src, uint32_t length)
+{
+    auto       dest  = MV_MixDestination;
+    auto const left  = MV_LeftVolume;
+    auto const right = MV_RightVolume;
+
+    // always even, so the gains stay in step
+    for (uint32_t i = MV_AccumulateVector(src, dest, length << 1, left, right); i < (length << 1); i += 2)
+    {
+        dest[i]     += src[i] * left;
+        dest[i + 1] += src[i + 1] * right;
+    }
+
+    MV_MixDestination = dest + (length << 1);
+}
+
+void MV_AccumulateMonoToStereo(float const *src, uint32_t length)
+{
+    auto       dest  = MV_MixDestination;
+    auto const left  = MV_LeftVolume;
+    auto const right = MV_RightVolume;
+
+    uint32_t i = 0;
+
+#ifdef MV_AVX2
+    if (MV_MixKernels == MV_KERNELS_AVX2)
+    {
+        i = length & ~7u;
+        MV_AccumulateMonoToStereo_AVX2(src, dest, i, left, right);
+    }
+#endif
+
+#if defined MV_SSE2
+    if (MV_MixKernels != MV_KERNELS_SCALAR)
     {
-        uint8_t const usample0 = SCALE_SAMPLE(source[position >> 16], volume);
+        __m128 const gain = _mm_setr_ps(left, right, left, right);
 
-        position += rate;
+        for (; i + 4 <= length; i += 4)
+        {
+            __m128 const s = _mm_loadu_ps(src + i);
 
-        *dest = (int16_t)clamp(SCALE_SAMPLE(MV_LeftVolume[usample0], MV_GlobalVolume) + *dest, INT16_MIN, INT16_MAX);
-        *(dest + (MV_RightChannelOffset >> 1))
-            = (int16_t)clamp(SCALE_SAMPLE(MV_RightVolume[usample0], MV_GlobalVolume) + *(dest + (MV_RightChannelOffset >> 1)), INT16_MIN, INT16_MAX);
-        dest += MV_SampleSize >> 1;
+            _mm_storeu_ps(dest + 2*i, _mm_add_ps(_mm_loadu_ps(dest + 2*i), _mm_mul_ps(_mm_unpacklo_ps(s, s), gain)));
+            _mm_storeu_ps(dest + 2*i + 4, _mm_add_ps(_mm_loadu_ps(dest + 2*i + 4), _mm_mul_ps(_mm_unpackhi_ps(s, s), gain)));
+        }
     }
-    while (--length);
+#elif defined MV_NEON
+    if (MV_MixKernels != MV_KERNELS_SCALAR)
+    {
+        float const gains[4] = { left, right, left, right };
+        float32x4_t const gain = vld1q_f32(gains);
 
-    MV_MixDestination = (char *)dest;
+        for (; i + 4 <= length; i += 4)
+        {
+            float32x4_t const s = vld1q_f32(src + i);
+            float32x4x2_t const ss = vzipq_f32(s, s);
 
-    return position;
+            vst1q_f32(dest + 2*i, vaddq_f32(vld1q_f32(dest + 2*i), vmulq_f32(ss.val[0], gain)));
+            vst1q_f32(dest + 2*i + 4, vaddq_f32(vld1q_f32(dest + 2*i + 4), vmulq_f32(ss.val[1], gain)));
+        }
+    }
+#endif
+
+    for (; i < length; i++)
+    {
+        dest[2*i]     += src[i] * left;
+        dest[2*i + 1] += src[i] * right;
+    }
+
+    MV_MixDestination = dest + (length << 1);
 }
 
-// 16-bit mono source, 16-bit mono output
-uint32_t MV_Mix16BitMono16(struct VoiceNode const * const voice, uint32_t length)
+// dest[i] = dest[i] + bus[i], rounded and clamped to 16 bits
+void MV_ClampMixBus(float const *bus, int16_t *dest, int32_t count)
 {
-    auto const source = (int16_t const *)voice->sound;
-    auto       dest   = (int16_t *)MV_MixDestination;
+    int32_t i = 0;
 
-    uint32_t       position = voice->position;
-    uint32_t const rate     = voice->RateScale;
-    float const    volume   = voice->volume;
+#if defined MV_SSE2
+    if (MV_MixKernels != MV_KERNELS_SCALAR)
+    {
+        __m128 const lo = _mm_set1_ps(INT16_MIN), hi = _mm_set1_ps(INT16_MAX);
 
-    do
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i const d = _mm_loadu_si128((__m128i const *)(dest + i));
+
+            __m128 const s0 = _mm_add_ps(_mm_loadu_ps(bus + i), _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(d, d), 16)));
+            __m128 const s1 = _mm_add_ps(_mm_loadu_ps(bus + i + 4), _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(d, d), 16)));
+
+            __m128i const r0 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(s0, lo), hi));
+            __m128i const r1 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(s1, lo), hi));
+
+            _mm_storeu_si128((__m128i *)(dest + i), _mm_packs_epi32(r0, r1));
+        }
+    }
+#elif defined MV_NEON && defined __aarch64__
+    if (MV_MixKernels != MV_KERNELS_SCALAR)
     {
-        int16_t const isample0 = B_LITTLE16(source[position >> 16]);
-        split16_t const usample0{FLIP_SIGN(SCALE_SAMPLE(isample0, volume))};
+        float32x4_t const lo = vdupq_n_f32(INT16_MIN), hi = vdupq_n_f32(INT16_MAX);
+
+        for (; i + 8 <= count; i += 8)
+        {
+            int16x8_t const d = vld1q_s16(dest + i);
 
-        position += rate;
+            float32x4_t const s0 = vaddq_f32(vld1q_f32(bus + i), vcvtq_f32_s32(vmovl_s16(vget_low_s16(d))));
+            float32x4_t const s1 = vaddq_f32(vld1q_f32(bus + i + 4), vcvtq_f32_s32(vmovl_s16(vget_high_s16(d))));
 
-        int32_t const sample0 = (SCALE_SAMPLE(MV_LeftVolume[usample0.l()], MV_GlobalVolume) >> 8) +
-                                 SCALE_SAMPLE(MV_LeftVolume[usample0.h()], MV_GlobalVolume) + 128;
+            int32x4_t const r0 = vcvtnq_s32_f32(vminq_f32(vmaxq_f32(s0, lo), hi));
+            int32x4_t const r1 = vcvtnq_s32_f32(vminq_f32(vmaxq_f32(s1, lo), hi));
 
-        *dest = (int16_t)clamp(sample0 + *dest, INT16_MIN, INT16_MAX);
-        dest += MV_SampleSize >> 1;
+            vst1q_s16(dest + i, vcombine_s16(vqmovn_s32(r0), vqmovn_s32(r1)));
+        }
     }
-    while (--length);
+#endif
 
-    MV_MixDestination = (char *)dest;
+    for (; i < count; i++)
+        dest[i] = (int16_t)Blrintf(clamp(bus[i] + (float)dest[i], (float)INT16_MIN, (float)INT16_MAX));
+}
+
+// dest[i] = src[i] for count little-endian 16-bit samples, for sources that
+// are already at the mixing rate and need no resampling
+void MV_ConvertSamples16Bit(int16_t const *src, float *dest, uint32_t count)
+{
+    uint32_t i = 0;
+
+#if defined MV_SSE2 && B_LITTLE_ENDIAN == 1
+    if (MV_MixKernels != MV_KERNELS_SCALAR)
+    {
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i const s = _mm_loadu_si128((__m128i const *)(src + i));
+
+            _mm_storeu_ps(dest + i, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16)));
+            _mm_storeu_ps(dest + i + 4, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16)));
+        }
+    }
+#elif defined MV_NEON && B_LITTLE_ENDIAN == 1
+    if (MV_MixKernels != MV_KERNELS_SCALAR)
+    {
+        for (; i + 8 <= count; i += 8)
+        {
+            int16x8_t const s = vld1q_s16(src + i);
+
+            vst1q_f32(dest + i, vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))));
+            vst1q_f32(dest + i + 4, vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))));
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+        dest[i] = (float)(int16_t)B_LITTLE16(src[i]);
+}
+
+/*
+ length = count of samples to mix
+ position = offset of starting sample in source
+ rate = resampling increment
+ */
+
+static inline uint32_t MV_GetSamples8Bit(struct VoiceNode const * const voice, float *samples, uint32_t length)
+{
+    auto const source = (uint8_t const *)voice->sound;
+
+    uint32_t       position = voice->position;
+    uint32_t const rate     = voice->RateScale;
+
+    for (uint32_t i = 0; i < length; i++, position += rate)
+        samples[i] = (float)(((int32_t)source[position >> 16] - 128) << 8);
 
     return position;
 }
 
-// 16-bit mono source, 16-bit stereo output
-uint32_t MV_Mix16BitStereo16(struct VoiceNode const * const voice, uint32_t length)
+static inline uint32_t MV_GetSamples16Bit(struct VoiceNode const * const voice, float *samples, uint32_t length)
 {
     auto const source = (int16_t const *)voice->sound;
-    auto       dest   = (int16_t *)MV_MixDestination;
 
     uint32_t       position = voice->position;
     uint32_t const rate     = voice->RateScale;
-    float const    volume   = voice->volume;
 
-    do
+    if (rate == 1u << 16)
     {
-        int16_t const isample0 = B_LITTLE16(source[position >> 16]);
-        split16_t const usample0{FLIP_SIGN(SCALE_SAMPLE(isample0, volume))};
+        MV_ConvertSamples16Bit(source + (position >> 16), samples, length);
+        return position + (length << 16);
+    }
 
-        position += rate;
+    for (uint32_t i = 0; i < length; i++, position += rate)
+        samples[i] = (float)(int16_t)B_LITTLE16(source[position >> 16]);
 
-        int32_t const sample0 = (SCALE_SAMPLE(MV_LeftVolume[usample0.l()], MV_GlobalVolume) >> 8) +
-                                 SCALE_SAMPLE(MV_LeftVolume[usample0.h()], MV_GlobalVolume) + 128;
-        int32_t const sample1 = (SCALE_SAMPLE(MV_RightVolume[usample0.l()], MV_GlobalVolume) >> 8) +
-                                 SCALE_SAMPLE(MV_RightVolume[usample0.h()], MV_GlobalVolume) + 128;
+    return position;
+}
 
-        *dest = (int16_t)clamp(sample0 + *dest, INT16_MIN, INT16_MAX);
-        *(dest + (MV_RightChannelOffset >> 1))
-            = (int16_t)clamp(sample1 + *(dest + (MV_RightChannelOffset >> 1)), INT16_MIN, INT16_MAX);
-        dest += MV_SampleSize >> 1;
-    }
-    while (--length);
+// 8-bit mono source, 16-bit mono output
+uint32_t MV_Mix16BitMono(struct VoiceNode const * const voice, uint32_t length)
+{
+    float samples[MV_MIXBUFFERSIZE];
+
+    uint32_t const position = MV_GetSamples8Bit(voice, samples, length);
+    MV_AccumulateMono(samples, length);
+
+    return position;
+}
+
+// 8-bit mono source, 16-bit stereo output
+uint32_t MV_Mix16BitStereo(struct VoiceNode const * const voice, uint32_t length)
+{
+    float samples[MV_MIXBUFFERSIZE];
+
+    uint32_t const position = MV_GetSamples8Bit(voice, samples, length);
+    MV_AccumulateMonoToStereo(samples, length);
+
+    return position;
+}
+
+// 16-bit mono source, 16-bit mono output
+uint32_t MV_Mix16BitMono16(struct VoiceNode const * const voice, uint32_t length)
+{
+    float samples[MV_MIXBUFFERSIZE];
+
+    uint32_t const position = MV_GetSamples16Bit(voice, samples, length);
+    MV_AccumulateMono(samples, length);
+
+    return position;
+}
+
+// 16-bit mono source, 16-bit stereo output
+uint32_t MV_Mix16BitStereo16(struct VoiceNode const * const voice, uint32_t length)
+{
+    float samples[MV_MIXBUFFERSIZE];
 
-    MV_MixDestination = (char *)dest;
+    uint32_t const position = MV_GetSamples16Bit(voice, samples, length);
+    MV_AccumulateMonoToStereo(samples, length);
 
     return position;
 }
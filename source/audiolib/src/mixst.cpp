@@ -24,96 +24,85 @@
  length = count of samples to mix
  position = offset of starting sample in source
  rate = resampling increment
- volume = direct volume adjustment, 1.0 = no change
  */
 
-// 8-bit stereo source, 16-bit mono output
-uint32_t MV_Mix16BitMono8Stereo(struct VoiceNode const * const voice, uint32_t length)
+// interleaved, two floats per frame
+static inline uint32_t MV_GetSamples8BitStereo(struct VoiceNode const * const voice, float *samples, uint32_t length)
 {
     auto const source = (uint8_t const *)voice->sound;
-    auto       dest   = (int16_t *)MV_MixDestination;
 
     uint32_t       position = voice->position;
     uint32_t const rate     = voice->RateScale;
-    float const    volume   = voice->volume;
 
-    do
+    for (uint32_t i = 0; i < length; i++, position += rate)
     {
-        uint8_t const usample0 = SCALE_SAMPLE(source[(position >> 16) << 1], volume);
-        uint8_t const usample1 = SCALE_SAMPLE(source[((position >> 16) << 1) + 1], volume);
-
-        position += rate;
-
-        *dest = (int16_t)clamp(((SCALE_SAMPLE(MV_LeftVolume[usample0], MV_GlobalVolume) +
-                                 SCALE_SAMPLE(MV_LeftVolume[usample1], MV_GlobalVolume)) >> 1) + *dest, INT16_MIN, INT16_MAX);
-        dest += MV_SampleSize >> 1;
+        samples[2*i]     = (float)(((int32_t)source[(position >> 16) << 1] - 128) << 8);
+        samples[2*i + 1] = (float)(((int32_t)source[((position >> 16) << 1) + 1] - 128) << 8);
     }
-    while (--length);
-
-    MV_MixDestination = (char *)dest;
 
     return position;
 }
 
-// 8-bit stereo source, 16-bit stereo output
-uint32_t MV_Mix16BitStereo8Stereo(struct VoiceNode const * const voice, uint32_t length)
+static inline uint32_t MV_GetSamples16BitStereo(struct VoiceNode const * const voice, float *samples, uint32_t length)
 {
-    auto const source = (uint8_t const *)voice->sound;
-    auto       dest   = (int16_t *)MV_MixDestination;
+    auto const source = (int16_t const *)voice->sound;
 
     uint32_t       position = voice->position;
     uint32_t const rate     = voice->RateScale;
-    float const    volume   = voice->volume;
 
-    do
+    if (rate == 1u << 16)
     {
-        uint8_t const usample0 = SCALE_SAMPLE(source[(position >> 16) << 1], volume);
-        uint8_t const usample1 = SCALE_SAMPLE(source[((position >> 16) << 1) + 1], volume);
-
-        position += rate;
-
-        *dest = (int16_t)clamp(SCALE_SAMPLE(MV_LeftVolume[usample0], MV_GlobalVolume) + *dest, INT16_MIN, INT16_MAX);
-        *(dest + (MV_RightChannelOffset >> 1))
-            = (int16_t)clamp(SCALE_SAMPLE(MV_RightVolume[usample1], MV_GlobalVolume) + *(dest + (MV_RightChannelOffset >> 1)), INT16_MIN, INT16_MAX);
-        dest += MV_SampleSize >> 1;
+        MV_ConvertSamples16Bit(source + ((position >> 16) << 1), samples, length << 1);
+        return position + (length << 16);
     }
-    while (--length);
 
-    MV_MixDestination = (char *)dest;
+    for (uint32_t i = 0; i < length; i++, position += rate)
+    {
+        samples[2*i]     = (float)(int16_t)B_LITTLE16(source[(position >> 16) << 1]);
+        samples[2*i + 1] = (float)(int16_t)B_LITTLE16(source[((position >> 16) << 1) + 1]);
+    }
 
     return position;
 }
 
-// 16-bit stereo source, 16-bit mono output
-uint32_t MV_Mix16BitMono16Stereo(struct VoiceNode const * const voice, uint32_t length)
+// averages each frame's channels in place, leaving length mono samples
+static inline void MV_DownmixStereo(float *samples, uint32_t length)
 {
-    auto const source = (int16_t const *)voice->sound;
-    auto       dest   = (int16_t *)MV_MixDestination;
+    for (uint32_t i = 0; i < length; i++)
+        samples[i] = (samples[2*i] + samples[2*i + 1]) * 0.5f;
+}
 
-    uint32_t       position = voice->position;
-    uint32_t const rate     = voice->RateScale;
-    float const    volume   = voice->volume;
+// 8-bit stereo source, 16-bit mono output
+uint32_t MV_Mix16BitMono8Stereo(struct VoiceNode const * const voice, uint32_t length)
+{
+    float samples[MV_MIXBUFFERSIZE * 2];
 
-    do
-    {
-        int16_t const isample0 = B_LITTLE16(source[(position >> 16) << 1]);
-        int16_t const isample1 = B_LITTLE16(source[((position >> 16) << 1) + 1]);
-        split16_t const usample0{FLIP_SIGN(SCALE_SAMPLE(isample0, volume))};
-        split16_t const usample1{FLIP_SIGN(SCALE_SAMPLE(isample1, volume))};
+    uint32_t const position = MV_GetSamples8BitStereo(voice, samples, length);
+    MV_DownmixStereo(samples, length);
+    MV_AccumulateMono(samples, length);
 
-        position += rate;
+    return position;
+}
 
-        int32_t const sample0 = (SCALE_SAMPLE(MV_LeftVolume[usample0.l()], MV_GlobalVolume)>> 8) +
-                                 SCALE_SAMPLE(MV_LeftVolume[usample0.h()], MV_GlobalVolume) + 128;
-        int32_t const sample1 = (SCALE_SAMPLE(MV_LeftVolume[usample1.l()], MV_GlobalVolume) >> 8) +
-                                 SCALE_SAMPLE(MV_LeftVolume[usample1.h()], MV_GlobalVolume) + 128;
+// 8-bit stereo source, 16-bit stereo output
+uint32_t MV_Mix16BitStereo8Stereo(struct VoiceNode const * const voice, uint32_t length)
+{
+    float samples[MV_MIXBUFFERSIZE * 2];
 
-        *dest = (int16_t)clamp(((sample0 + sample1) >> 1) + *dest, INT16_MIN, INT16_MAX);
-        dest += MV_SampleSize >> 1;
-    }
-    while (--length);
+    uint32_t const position = MV_GetSamples8BitStereo(voice, samples, length);
+    MV_AccumulateStereo(samples, length);
 
-    MV_MixDestination = (char *)dest;
+    return position;
+}
+
+// 16-bit stereo source, 16-bit mono output
+uint32_t MV_Mix16BitMono16Stereo(struct VoiceNode const * const voice, uint32_t length)
+{
+    float samples[MV_MIXBUFFERSIZE * 2];
+
+    uint32_t const position = MV_GetSamples16BitStereo(voice, samples, length);
+    MV_DownmixStereo(samples, length);
+    MV_AccumulateMono(samples, length);
 
     return position;
 }
@@ -121,35 +110,10 @@ uint32_t MV_Mix16BitMono16Stereo(struct VoiceNode const * const voice, uint32_t
 // 16-bit stereo source, 16-bit stereo output
 uint32_t MV_Mix16BitStereo16Stereo(struct VoiceNode const * const voice, uint32_t length)
 {
-    auto const source = (int16_t const *)voice->sound;
-    auto       dest   = (int16_t *)MV_MixDestination;
-
-    uint32_t       position = voice->position;
-    uint32_t const rate     = voice->RateScale;
-    float const    volume   = voice->volume;
-
-    do
-    {
-        int16_t const isample0 = B_LITTLE16(source[(position >> 16) << 1]);
-        int16_t const isample1 = B_LITTLE16(source[((position >> 16) << 1) + 1]);
-        split16_t const usample0{FLIP_SIGN(SCALE_SAMPLE(isample0, volume))};
-        split16_t const usample1{FLIP_SIGN(SCALE_SAMPLE(isample1, volume))};
-
-        position += rate;
-
-        int32_t const sample0 = (SCALE_SAMPLE(MV_LeftVolume[usample0.l()], MV_GlobalVolume)>> 8) +
-                                 SCALE_SAMPLE(MV_LeftVolume[usample0.h()], MV_GlobalVolume) + 128;
-        int32_t const sample1 = (SCALE_SAMPLE(MV_LeftVolume[usample1.l()], MV_GlobalVolume) >> 8) +
-                                 SCALE_SAMPLE(MV_LeftVolume[usample1.h()], MV_GlobalVolume) + 128;
-
-        *dest = (int16_t)clamp(sample0 + *dest, INT16_MIN, INT16_MAX);
-        *(dest + (MV_RightChannelOffset >> 1))
-            = (int16_t)clamp(sample1 + *(dest + (MV_RightChannelOffset >> 1)), INT16_MIN, INT16_MAX);
-        dest += MV_SampleSize >> 1;
-    }
-    while (--length);
+    float samples[MV_MIXBUFFERSIZE * 2];
 
-    MV_MixDestination = (char *)dest;
+    uint32_t const position = MV_GetSamples16BitStereo(voice, samples, length);
+    MV_AccumulateStereo(samples, length);
 
     return position;
 }
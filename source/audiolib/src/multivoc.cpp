@@ -39,16 +39,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "multivoc.h"
 #include "_multivc.h"
 #include "fx_man.h"
+#include "baselayer.h"
 
 static void MV_StopVoice(VoiceNode *voice);
 static void MV_ServiceVoc(void);
 
 static VoiceNode *MV_GetVoice(int32_t handle);
 
-static const int16_t *MV_GetVolumeTable(int32_t vol);
-
-#define IS_QUIET(ptr) ((void const *)(ptr) == (void *)&MV_VolumeTable[0])
-
 static int32_t MV_ReverbLevel;
 static int32_t MV_ReverbDelay;
 static int16_t *MV_ReverbTable = NULL;
@@ -84,9 +81,38 @@ static int32_t MV_MixPage = 0;
 void (*MV_Printf)(const char *fmt, ...) = NULL;
 static void (*MV_CallBackFunc)(uint32_t) = NULL;
 
-char *MV_MixDestination;
-const int16_t *MV_LeftVolume;
-const int16_t *MV_RightVolume;
+static float MV_MixBus[MV_MIXBUFFERSIZE * 2];
+
+static void *MV_InitData;
+
+// buffer sizing: what was asked for, what the driver started with, what it is
+// using now, and the state of the adaptive mode, which is driven from MV_Update()
+static int32_t MV_RequestedFrames;
+static int32_t MV_InitialFrames;
+static int32_t MV_BufferFrames;
+static int32_t MV_AdaptiveBuffer;
+static int32_t MV_AdaptUnderruns;
+static double  MV_AdaptTime;
+static double  MV_AdaptQuietTime;
+static double  MV_AdaptHold;
+
+#define MV_MAXBUFFERFRAMES  8192
+#define MV_ADAPTINTERVAL    1000.0
+#define MV_ADAPTHOLD        30000.0
+#define MV_ADAPTMAXHOLD     480000.0
+
+// timing of MV_ServiceVoc(), kept under the driver lock
+static mvstats_t MV_Stats;
+static int32_t MV_TotalUnderruns;
+static double  MV_ClockStart = -1.0;
+static double  MV_ClockBaseline;
+static int32_t MV_ClockPages;
+
+#define MV_UNDERRUNGRACE 250.0
+
+float *MV_MixDestination;
+float MV_LeftVolume;
+float MV_RightVolume;
 int32_t MV_SampleSize = 1;
 int32_t MV_RightChannelOffset;
 
@@ -135,7 +161,7 @@ const char *MV_ErrorString(int32_t ErrorNumber)
     }
 }
 
-static bool MV_Mix(VoiceNode *voice, int const buffer)
+static bool MV_Mix(VoiceNode *voice)
 {
     /* cheap fix for a crash under 64-bit linux */
     /*                            v  v  v  v    */
@@ -145,15 +171,11 @@ static bool MV_Mix(VoiceNode *voice, int const buffer)
     int32_t length = MV_MIXBUFFERSIZE;
     uint32_t FixedPointBufferSize = voice->FixedPointBufferSize;
 
-    MV_MixDestination = MV_MixBuffer[buffer];
-    MV_LeftVolume = voice->LeftVolume;
-    MV_RightVolume = voice->RightVolume;
+    float const gv = (voice->priority == FX_MUSIC_PRIORITY) ? 1.f : MV_GlobalVolume;
 
-    if ((MV_Channels == 2) && (IS_QUIET(MV_LeftVolume)))
-    {
-        MV_LeftVolume = MV_RightVolume;
-        MV_MixDestination += MV_RightChannelOffset;
-    }
+    MV_MixDestination = MV_MixBus;
+    MV_LeftVolume = voice->LeftVolume * voice->volume * gv;
+    MV_RightVolume = voice->RightVolume * voice->volume * gv;
 
     // Add this voice to the mix
     do
@@ -177,15 +199,8 @@ static bool MV_Mix(VoiceNode *voice, int const buffer)
         else
             voclength = length;
 
-        float const gv = MV_GlobalVolume;
-
-        if (voice->priority == FX_MUSIC_PRIORITY)
-            MV_GlobalVolume = 1.f;
-
         voice->position = voice->mix(voice, voclength);
 
-        MV_GlobalVolume = gv;
-
         length -= voclength;
 
         if (voice->position >= voice->length)
@@ -217,20 +232,8 @@ static void MV_CleanupVoice(VoiceNode *voice)
     if (MV_CallBackFunc)
         MV_CallBackFunc(voice->callbackval);
 
-    switch (voice->wavetype)
-    {
-#ifdef HAVE_VORBIS
-        case FMT_VORBIS: MV_ReleaseVorbisVoice(voice); break;
-#endif
-#ifdef HAVE_FLAC
-        case FMT_FLAC: MV_ReleaseFLACVoice(voice); break;
-#endif
-        case FMT_XA: MV_ReleaseXAVoice(voice); break;
-#ifdef HAVE_XMP
-        case FMT_XMP: MV_ReleaseXMPVoice(voice); break;
-#endif
-        default: break;
-    }
+    if (MV_IsStreamVoice(voice))
+        MV_ReleaseStream(voice);
 
     voice->handle = 0;
 }
@@ -253,7 +256,7 @@ static void MV_StopVoice(VoiceNode *voice)
         locking in the user-space functions of MultiVoc. The call
         to MV_ServiceVoc is synchronised in the driver.
 ---------------------------------------------------------------------*/
-static void MV_ServiceVoc(void)
+static void MV_MixNextPage(void)
 {
     // Toggle which buffer we'll mix next
     if (++MV_MixPage >= MV_NumberOfBuffers)
@@ -302,9 +305,12 @@ static void MV_ServiceVoc(void)
     if (!VoiceList.next || VoiceList.next == &VoiceList)
         return;
 
+    Bmemset(MV_MixBus, 0, MV_MIXBUFFERSIZE * MV_Channels * sizeof(float));
+
     VoiceNode *voice = VoiceList.next;
 
     int iter = 0;
+    bool mixed = false;
 
     VoiceNode *next;
 
@@ -319,9 +325,10 @@ static void MV_ServiceVoc(void)
             continue;
 
         MV_BufferEmpty[ MV_MixPage ] = FALSE;
+        mixed = true;
 
         // Is this voice done?
-        if (!MV_Mix(voice, MV_MixPage))
+        if (!MV_Mix(voice))
         {
             MV_CleanupVoice(voice);
 
@@ -331,9 +338,67 @@ static void MV_ServiceVoc(void)
     }
     while ((voice = next) != &VoiceList);
 
+    if (mixed)
+        MV_ClampMixBus(MV_MixBus, (int16_t *)MV_MixBuffer[MV_MixPage], MV_MIXBUFFERSIZE * MV_Channels);
+
     //RestoreInterrupts();
 }
 
+/*---------------------------------------------------------------------
+   Function: MV_RecordPage
+
+   Accounts for the time taken to mix a page, and for whether the
+   driver asked for it so late that playback must have run dry.
+
+   The driver pulls pages in bursts of a device period each, so how
+   far the pages asked for lag behind the wall clock swings by up to a
+   period less a page. Past that, the lag only grows when the device
+   was starved and played silence in the meantime, by at least a whole
+   period, so half of one more is taken to be an underrun.
+---------------------------------------------------------------------*/
+static void MV_RecordPage(double start, double end)
+{
+    double const mixms = end - start;
+
+    MV_Stats.pages++;
+    MV_Stats.mixms += mixms;
+    MV_Stats.maxmixms = max(MV_Stats.maxmixms, mixms);
+
+    if (MV_ClockStart < 0.0)
+    {
+        MV_ClockStart = start;
+        MV_ClockPages = 0;
+    }
+
+    double const pagems = MV_MIXBUFFERSIZE * 1000.0 / MV_MixRate;
+    double const lag    = start - MV_ClockStart - MV_ClockPages++ * pagems;
+
+    if (start - MV_ClockStart < MV_UNDERRUNGRACE)
+    {
+        MV_ClockBaseline = lag;
+        return;
+    }
+
+    // creep upwards so that a sound card running slightly slow isn't
+    // eventually taken for an underrun
+    MV_ClockBaseline = min(MV_ClockBaseline + pagems * (1.0 / 1024.0), lag);
+
+    if (lag - MV_ClockBaseline > MV_BufferFrames * 1500.0 / MV_MixRate - pagems)
+    {
+        MV_Stats.underruns++;
+        MV_TotalUnderruns++;
+        MV_ClockBaseline = lag;
+    }
+}
+
+static void MV_ServiceVoc(void)
+{
+    double const start = timerGetHiTicks();
+
+    MV_MixNextPage();
+    MV_RecordPage(start, timerGetHiTicks());
+}
+
 static VoiceNode *MV_GetVoice(int32_t handle)
 {
     if (handle < MV_MINVOICEHANDLE || handle > MV_MaxVoices)
@@ -556,7 +621,7 @@ int32_t MV_SetFrequency(int32_t handle, int32_t frequency)
     return MV_Ok;
 }
 
-static inline const int16_t *MV_GetVolumeTable(int32_t vol) { return MV_VolumeTable[MIX_VOLUME(vol)]; }
+static inline float MV_GetVolumeGain(int32_t vol) { return (float)MIX_VOLUME(vol) * (1.f / MV_MAXVOLUME); }
 
 /*---------------------------------------------------------------------
    Function: MV_SetVoiceMixMode
@@ -584,36 +649,18 @@ void MV_SetVoiceMixMode(VoiceNode *voice)
 
     if (MV_Channels == 1)
         type |= T_MONO;
-    else
-    {
-        if (IS_QUIET(voice->RightVolume))
-            type |= T_RIGHTQUIET;
-        else if (IS_QUIET(voice->LeftVolume))
-            type |= T_LEFTQUIET;
-    }
 
     if (voice->bits == 16)
         type |= T_16BITSOURCE;
 
     if (voice->channels == 2)
-    {
         type |= T_STEREOSOURCE;
-        type &= ~(T_RIGHTQUIET | T_LEFTQUIET);
-    }
 
     switch (type)
     {
-        case T_16BITSOURCE | T_LEFTQUIET:
-            MV_LeftVolume = MV_RightVolume;
-            fallthrough__;
-        case T_16BITSOURCE | T_MONO:
-        case T_16BITSOURCE | T_RIGHTQUIET: voice->mix = MV_Mix16BitMono16; break;
+        case T_16BITSOURCE | T_MONO: voice->mix = MV_Mix16BitMono16; break;
 
-        case T_LEFTQUIET:
-            MV_LeftVolume = MV_RightVolume;
-            fallthrough__;
-        case T_MONO:
-        case T_RIGHTQUIET: voice->mix = MV_Mix16BitMono; break;
+        case T_MONO: voice->mix = MV_Mix16BitMono; break;
 
         case T_16BITSOURCE: voice->mix = MV_Mix16BitStereo16; break;
 
@@ -636,16 +683,16 @@ void MV_SetVoiceVolume(VoiceNode *voice, int32_t vol, int32_t left, int32_t righ
     if (MV_Channels == 1)
         left = right = vol;
 
-    voice->LeftVolume = MV_GetVolumeTable(left);
+    voice->LeftVolume = MV_GetVolumeGain(left);
 
     if (left == right)
         voice->RightVolume = voice->LeftVolume;
     else
     {
-        voice->RightVolume = MV_GetVolumeTable(right);
+        voice->RightVolume = MV_GetVolumeGain(right);
 
         if (MV_ReverseStereo)
-            swapptr(&voice->LeftVolume, &voice->RightVolume);
+            swapfloat(&voice->LeftVolume, &voice->RightVolume);
     }
 
     voice->volume = volume;
@@ -673,20 +720,8 @@ int32_t MV_GetPosition(int32_t handle, int32_t *position)
     if (voice == NULL)
         return MV_Error;
 
-    switch (voice->wavetype)
-    {
-#ifdef HAVE_VORBIS
-        case FMT_VORBIS: *position = MV_GetVorbisPosition(voice); break;
-#endif
-#ifdef HAVE_FLAC
-        case FMT_FLAC: *position = MV_GetFLACPosition(voice); break;
-#endif
-        case FMT_XA: *position = MV_GetXAPosition(voice); break;
-#ifdef HAVE_XMP
-        case FMT_XMP: *position = MV_GetXMPPosition(voice); break;
-#endif
-        default: break;
-    }
+    if (MV_IsStreamVoice(voice))
+        *position = MV_GetStreamPosition(voice);
 
     MV_EndService();
 
@@ -700,20 +735,8 @@ int32_t MV_SetPosition(int32_t handle, int32_t position)
     if (voice == NULL)
         return MV_Error;
 
-    switch (voice->wavetype)
-    {
-#ifdef HAVE_VORBIS
-        case FMT_VORBIS: MV_SetVorbisPosition(voice, position); break;
-#endif
-#ifdef HAVE_FLAC
-        case FMT_FLAC: MV_SetFLACPosition(voice, position); break;
-#endif
-        case FMT_XA: MV_SetXAPosition(voice, position); break;
-#ifdef HAVE_XMP
-        case FMT_XMP: MV_SetXMPPosition(voice, position); break;
-#endif
-        default: break;
-    }
+    if (MV_IsStreamVoice(voice))
+        MV_SetStreamPosition(voice, position);
 
     MV_EndService();
 
@@ -731,6 +754,9 @@ int32_t MV_EndLooping(int32_t handle)
     voice->LoopStart = NULL;
     voice->LoopEnd = NULL;
 
+    if (MV_IsStreamVoice(voice))
+        MV_EndStreamLooping(voice);
+
     MV_EndService();
 
     return MV_Ok;
@@ -748,7 +774,7 @@ int32_t MV_SetPan(int32_t handle, int32_t vol, int32_t left, int32_t right)
     return MV_Ok;
 }
 
-int32_t MV_Pan3D(int32_t handle, int32_t angle, int32_t distance)
+static void MV_SetVoicePan3D(VoiceNode *voice, int32_t angle, int32_t distance)
 {
     if (distance < 0)
     {
@@ -760,9 +786,43 @@ int32_t MV_Pan3D(int32_t handle, int32_t angle, int32_t distance)
 
     angle &= MV_MAXPANPOSITION;
 
-    return MV_SetPan(handle, max(0, 255 - distance),
+    MV_SetVoiceVolume(voice, max(0, 255 - distance),
         MV_PanTable[ angle ][ volume ].left,
-        MV_PanTable[ angle ][ volume ].right);
+        MV_PanTable[ angle ][ volume ].right, voice->volume);
+}
+
+int32_t MV_Pan3D(int32_t handle, int32_t angle, int32_t distance)
+{
+    VoiceNode *voice = MV_BeginService(handle);
+
+    if (voice == NULL)
+        return MV_Error;
+
+    MV_SetVoicePan3D(voice, angle, distance);
+    MV_EndService();
+    return MV_Ok;
+}
+
+// MV_Pan3D() for count voices under a single lock of the mixer. Voices that
+// are no longer playing are skipped.
+int32_t MV_Pan3DVoices(int32_t const *handles, int32_t const *angles, int32_t const *distances, int32_t count)
+{
+    if (!MV_Installed)
+        return MV_Error;
+
+    DisableInterrupts();
+
+    for (int i = 0; i < count; i++)
+    {
+        VoiceNode *voice = MV_GetVoice(handles[i]);
+
+        if (voice != NULL)
+            MV_SetVoicePan3D(voice, angles[i], distances[i]);
+    }
+
+    RestoreInterrupts();
+
+    return MV_Ok;
 }
 
 void MV_SetReverb(int32_t reverb)
@@ -806,6 +866,7 @@ static int32_t MV_StartPlayback(void)
         MV_BufferEmpty[buffer] = TRUE;
 
     MV_MixPage = 1;
+    MV_ClockStart = -1.0;
 
     if (SoundDriver_BeginPlayback(MV_MixBuffer[0], MV_BufferSize, MV_NumberOfBuffers, MV_ServiceVoc) != MV_Ok)
     {
@@ -922,7 +983,10 @@ int32_t MV_Init(int32_t soundcard, int32_t MixRate, int32_t Voices, int32_t numc
 
     MV_SetReverseStereo(FALSE);
 
-    ASS_SoundDriver = soundcard;
+    MV_MixKernels = MV_DetectMixKernels();
+
+    ASS_SoundDriver  = soundcard;
+    ASS_BufferFrames = MV_RequestedFrames;
 
     // Initialize the sound card
 
@@ -944,6 +1008,15 @@ int32_t MV_Init(int32_t soundcard, int32_t MixRate, int32_t Voices, int32_t numc
     // Set the sampling rate
     MV_MixRate = MixRate;
 
+    MV_InitData      = initdata;
+    MV_InitialFrames = ASS_BufferFrames;
+    MV_BufferFrames  = ASS_BufferFrames;
+
+    MV_ResetStats();
+    MV_AdaptUnderruns = MV_TotalUnderruns = 0;
+    MV_AdaptTime = MV_AdaptQuietTime = timerGetHiTicks();
+    MV_AdaptHold = MV_ADAPTHOLD;
+
     // Set Mixer to play stereo digitized sound
     MV_SetMixMode(numchannels);
     MV_ReverbDelay = MV_BufferSize * 3;
@@ -985,6 +1058,8 @@ int32_t MV_Shutdown(void)
     // Stop the sound playback engine
     MV_StopPlayback();
 
+    MV_ShutdownStreams();
+
     // Shutdown the sound card
     SoundDriver_Shutdown();
 
@@ -1007,6 +1082,270 @@ int32_t MV_Shutdown(void)
 
 void MV_SetPrintf(void (*function)(const char *, ...)) { MV_Printf = function; }
 
+void MV_SetBufferFrames(int32_t frames, int32_t adaptive)
+{
+    MV_RequestedFrames = clamp(frames, 0, MV_MAXBUFFERFRAMES);
+    MV_AdaptiveBuffer  = adaptive;
+}
+
+int32_t MV_GetStats(mvstats_t *stats)
+{
+    if (!MV_Installed)
+        return MV_Error;
+
+    DisableInterrupts();
+    *stats = MV_Stats;
+    RestoreInterrupts();
+
+    stats->bufferframes = MV_BufferFrames;
+    stats->pageframes   = MV_MIXBUFFERSIZE;
+    stats->mixrate      = MV_MixRate;
+
+    return MV_Ok;
+}
+
+void MV_ResetStats(void)
+{
+    if (!MV_Installed)
+        return;
+
+    DisableInterrupts();
+    Bmemset(&MV_Stats, 0, sizeof(MV_Stats));
+    RestoreInterrupts();
+}
+
+/*---------------------------------------------------------------------
+   Function: MV_RestartDriver
+
+   Reopens the sound card with a different buffer size, keeping the
+   voices that are playing. Falls back to the old size if the driver
+   won't take the new one, or comes back in a different format.
+---------------------------------------------------------------------*/
+static int32_t MV_RestartDriver(int32_t frames)
+{
+    int32_t const oldframes = MV_BufferFrames;
+
+    SoundDriver_StopPlayback();
+    SoundDriver_Shutdown();
+
+    for (int32_t const tryframes : { frames, oldframes })
+    {
+        int32_t mixrate = MV_MixRate, numchannels = MV_Channels;
+
+        ASS_BufferFrames = tryframes;
+
+        if (SoundDriver_Init(&mixrate, &numchannels, MV_InitData) != MV_Ok)
+            continue;
+
+        if (mixrate == MV_MixRate && 1 + (numchannels == 2) == MV_Channels)
+        {
+            MV_BufferFrames = ASS_BufferFrames;
+
+            if (MV_StartPlayback() == MV_Ok)
+                return MV_BufferFrames != oldframes;
+
+            SoundDriver_StopPlayback();
+        }
+
+        SoundDriver_Shutdown();
+    }
+
+    if (MV_Printf)
+        MV_Printf("MV_RestartDriver(): %s\n", SoundDriver_ErrorString(SoundDriver_GetError()));
+
+    // the driver is gone: take Multivoc down with it
+    MV_Shutdown();
+
+    return FALSE;
+}
+
+/*---------------------------------------------------------------------
+   Function: MV_Update
+
+   Called regularly from the main thread. In adaptive mode, doubles the
+   driver's buffer when it keeps running dry, and halves it back towards
+   the size the driver started with once it has gone a while without
+   doing so. It never goes below that size, so a buffer that was never
+   grown is never shrunk. Each
+   time it has to grow, it waits longer before trying to shrink again.
+   Returns TRUE when the driver was restarted with a different size.
+---------------------------------------------------------------------*/
+int32_t MV_Update(void)
+{
+    if (!MV_Installed || !MV_AdaptiveBuffer)
+        return FALSE;
+
+    double const now = timerGetHiTicks();
+
+    if (now - MV_AdaptTime < MV_ADAPTINTERVAL)
+        return FALSE;
+
+    DisableInterrupts();
+    int32_t const underruns = MV_TotalUnderruns - MV_AdaptUnderruns;
+    MV_AdaptUnderruns = MV_TotalUnderruns;
+    RestoreInterrupts();
+
+    MV_AdaptTime = now;
+
+    int32_t frames = MV_BufferFrames;
+
+    if (underruns > 0)
+    {
+        if (underruns >= 2 && frames < MV_MAXBUFFERFRAMES)
+        {
+            frames = min(frames * 2, MV_MAXBUFFERFRAMES);
+            MV_AdaptHold = min(MV_AdaptHold * 2.0, MV_ADAPTMAXHOLD);
+        }
+
+        MV_AdaptQuietTime = now;
+    }
+    else if (now - MV_AdaptQuietTime >= MV_AdaptHold)
+    {
+        if (frames > MV_InitialFrames)
+            frames = max(frames / 2, MV_InitialFrames);
+
+        MV_AdaptQuietTime = now;
+    }
+
+    if (frames == MV_BufferFrames)
+        return FALSE;
+
+    if (MV_Printf)
+        MV_Printf("Sound: %s buffer to %d frames\n", frames > MV_BufferFrames ? "growing" : "shrinking", frames);
+
+    return MV_RestartDriver(frames);
+}
+
+static char *MV_MakeBenchmarkWAV(int32_t bits, int32_t channels, int32_t rate, int32_t numframes, uint32_t *length)
+{
+    int32_t const datasize = numframes * channels * (bits >> 3);
+
+    *length = sizeof(riff_header) + sizeof(format_header) + sizeof(data_header) + datasize;
+
+    auto const ptr = (char *)Xmalloc(*length);
+
+    riff_header const riff = { { 'R', 'I', 'F', 'F' }, B_LITTLE32(*length - 8), { 'W', 'A', 'V', 'E' },
+                               { 'f', 'm', 't', ' ' }, B_LITTLE32((uint32_t)sizeof(format_header)) };
+    format_header const format = { B_LITTLE16(1), B_LITTLE16((uint16_t)channels), B_LITTLE32((uint32_t)rate),
+                                   B_LITTLE32((uint32_t)(rate * channels * (bits >> 3))), B_LITTLE16((uint16_t)(channels * (bits >> 3))),
+                                   B_LITTLE16((uint16_t)bits) };
+    data_header const data = { { 'd', 'a', 't', 'a' }, B_LITTLE32((uint32_t)datasize) };
+
+    Bmemcpy(ptr, &riff, sizeof(riff_header));
+    Bmemcpy(ptr + sizeof(riff_header), &format, sizeof(format_header));
+    Bmemcpy(ptr + sizeof(riff_header) + sizeof(format_header), &data, sizeof(data_header));
+
+    char *const samples = ptr + sizeof(riff_header) + sizeof(format_header) + sizeof(data_header);
+    uint32_t seed = bits * 7 + channels;
+
+    for (int32_t i = 0; i < numframes * channels; i++)
+    {
+        seed = seed * 1664525 + 1013904223;
+
+        if (bits == 16)
+        {
+            int16_t const sample = B_LITTLE16((int16_t)(seed >> 16));
+            Bmemcpy(samples + i * 2, &sample, 2);
+        }
+        else
+            samples[i] = (char)(seed >> 24);
+    }
+
+    return ptr;
+}
+
+/*---------------------------------------------------------------------
+   Function: MV_MixBenchmark
+
+   Mixes numbuffers buffers of numvoices looping voices through the
+   no-sound driver once with each set of mix kernels, and reports the
+   time taken and whether the output matched that of the scalar ones.
+   Multivoc must not be installed.
+---------------------------------------------------------------------*/
+int32_t MV_MixBenchmark(int32_t numvoices, int32_t numbuffers)
+{
+    if (MV_Installed)
+    {
+        if (MV_Printf)
+            MV_Printf("MV_MixBenchmark(): sound must be shut down first.\n");
+        return MV_Error;
+    }
+
+    int32_t const mixrate = 44100;
+
+    if (MV_Init(ASS_NoSound, mixrate, numvoices, 2, NULL) != MV_Ok)
+        return MV_Error;
+
+    MV_SetVolume(MV_MAXTOTALVOLUME);
+
+    // the formats of the sounds a game plays: 8-bit and 16-bit, mono and stereo, 11-44kHz
+    static struct { int32_t bits, channels, rate; } const formats[] = {
+        { 8, 1, 11025 }, { 16, 1, 22050 }, { 16, 2, 44100 }, { 8, 2, 22050 },
+    };
+
+    char *    wavs[ARRAY_SIZE(formats)];
+    uint32_t  lengths[ARRAY_SIZE(formats)];
+
+    for (int i = 0; i < ARRAY_SSIZE(formats); i++)
+        wavs[i] = MV_MakeBenchmarkWAV(formats[i].bits, formats[i].channels, formats[i].rate, formats[i].rate, &lengths[i]);
+
+    int32_t const maxkernels = MV_DetectMixKernels();
+    uint32_t refhash = 0;
+    double scalarms = 0.0;
+
+    if (MV_Printf)
+        MV_Printf("Mixer benchmark, %d voices, %d buffers of %d frames at %d Hz:\n", numvoices, numbuffers, MV_MIXBUFFERSIZE, mixrate);
+
+    for (int32_t kernels = MV_KERNELS_SCALAR; kernels <= maxkernels; kernels++)
+    {
+        MV_MixKernels = kernels;
+
+        for (int32_t i = 0; i < numvoices; i++)
+        {
+            int const f = i % ARRAY_SSIZE(formats);
+            MV_PlayWAV3D(wavs[f], lengths[f], FX_LOOP, (i * 97) % 1200 - 600, i * 13, (i * 7) % 128, 0, 1.f, 0);
+        }
+
+        uint32_t hash = 2166136261u;
+        double ms = 0.0;
+
+        for (int32_t n = 0; n < numbuffers; n++)
+        {
+            double const t0 = timerGetHiTicks();
+            MV_MixNextPage();
+            ms += timerGetHiTicks() - t0;
+
+            auto const buf = (uint8_t const *)MV_MixBuffer[MV_MixPage];
+
+            for (int32_t i = 0; i < MV_BufferSize; i++)
+                hash = (hash ^ buf[i]) * 16777619u;
+        }
+
+        MV_KillAllVoices();
+
+        if (kernels == MV_KERNELS_SCALAR)
+        {
+            refhash  = hash;
+            scalarms = ms;
+        }
+
+        // milliseconds of audio mixed per millisecond spent
+        double const realtime = (double)numbuffers * MV_MIXBUFFERSIZE * 1000.0 / mixrate / max(ms, 0.001);
+
+        if (MV_Printf)
+            MV_Printf("  %-7s %8.2f us/buffer %8.3f us/voice %7.1fx realtime %6.2fx%s\n", MV_MixKernelName(kernels),
+                      ms * 1000.0 / numbuffers, ms * 1000.0 / ((double)numbuffers * numvoices), realtime,
+                      scalarms / max(ms, 0.001), hash == refhash ? "" : "  OUTPUT MISMATCH");
+    }
+
+    MV_Shutdown();
+
+    for (auto &wav : wavs)
+        Bfree(wav);
+
+    return MV_Ok;
+}
+
 const char *loopStartTags[loopStartTagCount] = { "LOOP_START", "LOOPSTART", "LOOP" };
 const char *loopEndTags[loopEndTagCount] = { "LOOP_END", "LOOPEND" };
 const char *loopLengthTags[loopLengthTagCount] = { "LOOP_LENGTH", "LOOPLENGTH" };
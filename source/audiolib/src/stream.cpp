@@ -0,0 +1,463 @@
+/*
+ Copyright (C) 2019 EDuke32 developers and contributors
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+ See the GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+ */
+
+/**
+ * Streaming voices
+ *
+ * Vorbis, FLAC, XA and XMP voices are decoded ahead of time on a decoder
+ * thread shared by all of them, so that the mixer running in the audio
+ * callback only reads PCM that is already there.
+ *
+ * The decoders run unmodified on a private copy of the voice. What they
+ * produce is gathered into a ring of fixed-size slots per stream, with the
+ * decoder thread as the only producer and MV_GetNextStreamBlock() in the
+ * mixer as the only consumer, handing slots over through the head and tail
+ * counters alone. Everything else touching the copy of the voice (seeking,
+ * ending loops, freeing) holds MV_StreamMutex, as the decoder thread does.
+ *
+ * If the thread cannot be started, the mixer decodes one slot at a time
+ * itself, as it used to.
+ */
+
+#include "compat.h"
+#include "multivoc.h"
+#include "_multivc.h"
+#include "threadpool.h"
+#include "mutex.h"
+
+#ifdef _WIN32
+# include "windows_inc.h"
+#endif
+
+#include <atomic>
+
+#define MV_STREAMSLOTS    16  // must be a power of two
+#define MV_STREAMSLOTSIZE 4096
+#define MV_STREAMPREFILL  2   // slots decoded up front before the voice starts playing
+#define MV_STREAMIDLEMS   2
+
+// A decoder that gives nothing back this many times in a row is treated as
+// having reached its end.
+#define MV_STREAMMAXEMPTY 16
+
+typedef struct
+{
+    char data[MV_STREAMSLOTSIZE];
+    uint32_t bytes;
+    uint32_t rate;
+    int32_t position;  // of the source when the slot was started
+    char bits;
+    char channels;
+} mvstreamslot_t;
+
+typedef struct mvstream_
+{
+    struct mvstream_ *next;
+
+    VoiceNode dec;  // what the decoder sees as its voice
+    playbackstatus (*decode)(VoiceNode *);
+
+    // unused part of the block last decoded
+    char const *pending;
+    uint32_t pendingbytes;
+    int32_t pendingposition;
+
+    std::atomic<uint32_t> head, tail;
+    std::atomic<bool> ended, released;
+
+    bool playing;  // the mixer is reading slot[tail]
+    bool inlinedecode;
+
+    mvstreamslot_t slot[MV_STREAMSLOTS];
+} mvstream_t;
+
+static mvstream_t *MV_Streams;
+static mutex_t MV_StreamMutex;
+static bool MV_StreamMutexInited;
+static void *MV_StreamThread;
+static std::atomic<bool> MV_StreamQuit;
+
+static void MV_StreamSleep(void)
+{
+#ifdef _WIN32
+    Sleep(MV_STREAMIDLEMS);
+#else
+    usleep(MV_STREAMIDLEMS * 1000);
+#endif
+}
+
+static int32_t MV_GetSourcePosition(VoiceNode *voice)
+{
+    switch (voice->wavetype)
+    {
+#ifdef HAVE_VORBIS
+        case FMT_VORBIS: return MV_GetVorbisPosition(voice);
+#endif
+#ifdef HAVE_FLAC
+        case FMT_FLAC: return MV_GetFLACPosition(voice);
+#endif
+        case FMT_XA: return MV_GetXAPosition(voice);
+#ifdef HAVE_XMP
+        case FMT_XMP: return MV_GetXMPPosition(voice);
+#endif
+        default: return 0;
+    }
+}
+
+static void MV_SetSourcePosition(VoiceNode *voice, int32_t position)
+{
+    switch (voice->wavetype)
+    {
+#ifdef HAVE_VORBIS
+        case FMT_VORBIS: MV_SetVorbisPosition(voice, position); break;
+#endif
+#ifdef HAVE_FLAC
+        case FMT_FLAC: MV_SetFLACPosition(voice, position); break;
+#endif
+        case FMT_XA: MV_SetXAPosition(voice, position); break;
+#ifdef HAVE_XMP
+        case FMT_XMP: MV_SetXMPPosition(voice, position); break;
+#endif
+        default: break;
+    }
+}
+
+static void MV_FreeStream(mvstream_t *stream)
+{
+    VoiceNode *const voice = &stream->dec;
+
+    switch (voice->wavetype)
+    {
+#ifdef HAVE_VORBIS
+        case FMT_VORBIS: MV_ReleaseVorbisVoice(voice); break;
+#endif
+#ifdef HAVE_FLAC
+        case FMT_FLAC: MV_ReleaseFLACVoice(voice); break;
+#endif
+        case FMT_XA: MV_ReleaseXAVoice(voice); break;
+#ifdef HAVE_XMP
+        case FMT_XMP: MV_ReleaseXMPVoice(voice); break;
+#endif
+        default: break;
+    }
+
+    Bfree(stream);
+}
+
+// Must hold MV_StreamMutex.
+static void MV_FreeReleasedStreams(void)
+{
+    for (mvstream_t **prev = &MV_Streams, *stream; (stream = *prev) != NULL;)
+    {
+        if (stream->released.load(std::memory_order_acquire))
+        {
+            *prev = stream->next;
+            MV_FreeStream(stream);
+        }
+        else
+            prev = &stream->next;
+    }
+}
+
+// Decodes into the next free slot and hands it to the mixer. Returns false if
+// there was no free slot or nothing left to decode.
+static bool MV_FillStreamSlot(mvstream_t *stream)
+{
+    uint32_t const head = stream->head.load(std::memory_order_relaxed);
+
+    if (stream->ended.load(std::memory_order_relaxed) ||
+        head - stream->tail.load(std::memory_order_acquire) >= MV_STREAMSLOTS)
+        return false;
+
+    mvstreamslot_t *const slot = &stream->slot[head & (MV_STREAMSLOTS-1)];
+    VoiceNode *const dec = &stream->dec;
+    int32_t numempty = 0;
+
+    slot->bytes = 0;
+
+    while (slot->bytes < MV_STREAMSLOTSIZE)
+    {
+        if (stream->pendingbytes == 0)
+        {
+            stream->pendingposition = MV_GetSourcePosition(dec);
+
+            dec->length = 0;
+
+            if (stream->decode(dec) != KeepPlaying)
+            {
+                stream->ended.store(true, std::memory_order_release);
+                break;
+            }
+
+            stream->pending = dec->sound;
+            stream->pendingbytes = (dec->length >> 16) * dec->channels * (dec->bits >> 3);
+
+            if (stream->pendingbytes == 0)
+            {
+                if (++numempty == MV_STREAMMAXEMPTY)
+                {
+                    stream->ended.store(true, std::memory_order_release);
+                    break;
+                }
+
+                continue;
+            }
+
+            numempty = 0;
+        }
+
+        // A change of format starts a new slot.
+        if (slot->bytes == 0)
+        {
+            slot->position = stream->pendingposition;
+            slot->rate = dec->SamplingRate;
+            slot->bits = dec->bits;
+            slot->channels = dec->channels;
+        }
+        else if (slot->rate != dec->SamplingRate || slot->bits != dec->bits || slot->channels != dec->channels)
+            break;
+
+        uint32_t const framebytes = dec->channels * (dec->bits >> 3);
+        uint32_t const bytes = min(stream->pendingbytes, (MV_STREAMSLOTSIZE - slot->bytes) / framebytes * framebytes);
+
+        if (bytes == 0)
+            break;
+
+        Bmemcpy(slot->data + slot->bytes, stream->pending, bytes);
+        slot->bytes += bytes;
+        stream->pending += bytes;
+        stream->pendingbytes -= bytes;
+    }
+
+    if (slot->bytes == 0)
+        return false;
+
+    stream->head.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+static void MV_StreamWorker(int32_t part, int32_t numparts, void *data)
+{
+    UNREFERENCED_PARAMETER(part);
+    UNREFERENCED_PARAMETER(numparts);
+    UNREFERENCED_PARAMETER(data);
+
+    while (!MV_StreamQuit.load(std::memory_order_acquire))
+    {
+        bool busy = false;
+
+        mutex_lock(&MV_StreamMutex);
+
+        MV_FreeReleasedStreams();
+
+        // One slot per stream and pass, so that none of them waits on another
+        // one being filled up.
+        for (mvstream_t *stream = MV_Streams; stream != NULL; stream = stream->next)
+            if (!stream->inlinedecode)
+                busy |= MV_FillStreamSlot(stream);
+
+        mutex_unlock(&MV_StreamMutex);
+
+        if (!busy)
+            MV_StreamSleep();
+    }
+}
+
+// Must hold MV_StreamMutex, and the voice must not be mixed meanwhile.
+static void MV_PrefillStream(mvstream_t *stream, VoiceNode *voice)
+{
+    stream->head.store(0, std::memory_order_relaxed);
+    stream->tail.store(0, std::memory_order_relaxed);
+    stream->ended.store(false, std::memory_order_relaxed);
+    stream->playing = false;
+    stream->pendingbytes = 0;
+
+    voice->sound = NULL;
+    voice->length = 0;
+    voice->position = 0;
+    voice->BlockLength = 0;
+
+    for (int i = 0; i < MV_STREAMPREFILL; i++)
+        if (!MV_FillStreamSlot(stream))
+            break;
+}
+
+void MV_StartStream(VoiceNode *voice, VoiceNode **owner)
+{
+    auto stream = (mvstream_t *)Xcalloc(1, sizeof(mvstream_t));
+
+    stream->dec = *voice;
+    stream->decode = voice->GetSound;
+
+    if (owner)
+        *owner = &stream->dec;
+
+    voice->GetSound = MV_GetNextStreamBlock;
+    voice->rawdataptr = (void *)stream;
+
+    // Not every format knows its rate before decoding, so let the first slot
+    // set up the voice.
+    voice->SamplingRate = 0;
+
+    if (!MV_StreamMutexInited)
+        MV_StreamMutexInited = (mutex_init(&MV_StreamMutex) == 0);
+
+    mutex_lock(&MV_StreamMutex);
+
+    MV_PrefillStream(stream, voice);
+
+    if (MV_StreamThread == NULL)
+    {
+        MV_FreeReleasedStreams();
+
+        MV_StreamQuit.store(false, std::memory_order_relaxed);
+        MV_StreamThread = threadpool_spawn(MV_StreamWorker, NULL);
+    }
+
+    stream->inlinedecode = (MV_StreamThread == NULL);
+    stream->next = MV_Streams;
+    MV_Streams = stream;
+
+    mutex_unlock(&MV_StreamMutex);
+}
+
+// May be called from the mixer, so it only marks the stream for the decoder
+// thread (or the next MV_StartStream()) to free.
+void MV_ReleaseStream(VoiceNode *voice)
+{
+    auto stream = (mvstream_t *)voice->rawdataptr;
+
+    voice->rawdataptr = NULL;
+    stream->released.store(true, std::memory_order_release);
+}
+
+int32_t MV_GetStreamPosition(VoiceNode *voice)
+{
+    auto stream = (mvstream_t *)voice->rawdataptr;
+    uint32_t const tail = stream->tail.load(std::memory_order_relaxed);
+
+    if (tail != stream->head.load(std::memory_order_acquire))
+        return stream->slot[tail & (MV_STREAMSLOTS-1)].position;
+
+    mutex_lock(&MV_StreamMutex);
+    int32_t const position = MV_GetSourcePosition(&stream->dec);
+    mutex_unlock(&MV_StreamMutex);
+
+    return position;
+}
+
+void MV_SetStreamPosition(VoiceNode *voice, int32_t position)
+{
+    auto stream = (mvstream_t *)voice->rawdataptr;
+
+    mutex_lock(&MV_StreamMutex);
+    MV_SetSourcePosition(&stream->dec, position);
+    MV_PrefillStream(stream, voice);
+    mutex_unlock(&MV_StreamMutex);
+}
+
+void MV_EndStreamLooping(VoiceNode *voice)
+{
+    auto stream = (mvstream_t *)voice->rawdataptr;
+
+    mutex_lock(&MV_StreamMutex);
+    stream->dec.LoopCount = 0;
+    stream->dec.LoopStart = NULL;
+    stream->dec.LoopEnd = NULL;
+    mutex_unlock(&MV_StreamMutex);
+}
+
+// Called once no voice is playing any more.
+void MV_ShutdownStreams(void)
+{
+    if (MV_StreamThread)
+    {
+        MV_StreamQuit.store(true, std::memory_order_release);
+        threadpool_join(MV_StreamThread);
+        MV_StreamThread = NULL;
+    }
+
+    if (MV_StreamMutexInited)
+    {
+        mutex_lock(&MV_StreamMutex);
+        MV_FreeReleasedStreams();
+        mutex_unlock(&MV_StreamMutex);
+    }
+}
+
+/*---------------------------------------------------------------------
+Function: MV_GetNextStreamBlock
+
+Hands the next decoded slot of a stream to the mixer
+---------------------------------------------------------------------*/
+
+playbackstatus MV_GetNextStreamBlock(VoiceNode *voice)
+{
+    auto stream = (mvstream_t *)voice->rawdataptr;
+    uint32_t tail = stream->tail.load(std::memory_order_relaxed);
+
+    if (stream->playing)
+    {
+        stream->tail.store(++tail, std::memory_order_release);
+        stream->playing = false;
+    }
+
+    if (stream->inlinedecode)
+        MV_FillStreamSlot(stream);
+
+    bool const ended = stream->ended.load(std::memory_order_acquire);
+
+    if (tail == stream->head.load(std::memory_order_acquire))
+    {
+        if (ended)
+            return NoMoreData;
+
+        // The decoder is running behind: play nothing this time around
+        // instead of ending the voice.
+        voice->length = 0;
+        voice->position = 0;
+
+        return KeepPlaying;
+    }
+
+    mvstreamslot_t const *const slot = &stream->slot[tail & (MV_STREAMSLOTS-1)];
+
+    if (slot->rate != voice->SamplingRate || slot->bits != voice->bits || slot->channels != voice->channels)
+    {
+        voice->SamplingRate = slot->rate;
+        voice->bits = slot->bits;
+        voice->channels = slot->channels;
+
+        // CODEDUP multivoc.c MV_SetVoicePitch
+        voice->RateScale = (voice->SamplingRate * voice->PitchScale) / MV_MixRate;
+        voice->FixedPointBufferSize = (voice->RateScale * MV_MIXBUFFERSIZE) - voice->RateScale;
+        MV_SetVoiceMixMode(voice);
+    }
+
+    voice->sound = slot->data;
+    voice->length = (slot->bytes / (slot->channels * (slot->bits >> 3))) << 16;
+    voice->position = 0;
+    voice->BlockLength = 0;
+
+    stream->playing = true;
+
+    return KeepPlaying;
+}
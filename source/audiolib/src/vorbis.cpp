@@ -448,6 +448,7 @@ int32_t MV_PlayVorbis(char *ptr, uint32_t length, int32_t loopstart, int32_t loo
     MV_SetVoiceMixMode(voice);
 
     MV_SetVoiceVolume(voice, vol, left, right, volume);
+    MV_StartStream(voice, NULL);
     MV_PlayVoice(voice);
 
     return voice->handle;
@@ -469,6 +469,7 @@ int32_t MV_PlayXA(char *ptr, uint32_t length, int32_t loopstart, int32_t loopend
    voice->LoopSize    = (loopstart >= 0 ? 1 : 0);
 
    MV_SetVoiceVolume( voice, vol, left, right, volume );
+   MV_StartStream( voice, &xad->owner );
    MV_PlayVoice( voice );
 
    return voice->handle;
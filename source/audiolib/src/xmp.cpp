@@ -181,6 +181,7 @@ int32_t MV_PlayXMP(char *ptr, uint32_t length, int32_t loopstart, int32_t loopen
     MV_SetVoiceMixMode(voice);
 
     MV_SetVoiceVolume(voice, vol, left, right, volume);
+    MV_StartStream(voice, &xmpd->owner);
     MV_PlayVoice(voice);
 
     return voice->handle;
@@ -95,6 +95,17 @@ extern void __cdecl stretchhline(int32_t,int32_t,int32_t,int32_t,int32_t,int32_t
 
 #define prevlineasm1 vlineasm1
 
+// Instruction sets for the column and span loops, see a_c_setkernels().
+#define A_C_KERNELS_SCALAR 0
+#define A_C_KERNELS_VEC4   1  // SSE2 or NEON
+#define A_C_KERNELS_AVX2   2
+
+extern int32_t r_simd;
+
+int32_t a_c_setkernels(int32_t kernels);
+char const *a_c_kernelname(int32_t kernels);
+void a_c_benchmark(int32_t numframes);
+
 void setvlinebpl(int32_t dabpl);
 void fixtransluscence(intptr_t datransoff);
 void settransnormal(void);
@@ -42,9 +42,12 @@ extern int32_t startwin_run(void);
 extern int32_t r_usenewaspect, newaspect_enable;
 extern int32_t setaspect_new_use_dimen;
 extern uint32_t r_screenxy;
+extern int32_t r_blitthreads;
+extern int32_t r_pvs;
 extern int32_t xres, yres, bpp, fullscreen, bytesperline;
 extern intptr_t frameplace;
 extern char offscreenrendering;
+extern char headlessvideo;
 extern int32_t nofog;
 
 void calc_ylookup(int32_t bpl, int32_t lastyidx);
@@ -24,9 +24,28 @@ extern int32_t kpzbufsiz;
 extern int32_t kpzbufloadfil(int32_t);
 extern int32_t kpzbufload(const char *);
 
+typedef struct cactype_
+{
+    intptr_t *hand;
+    int32_t   leng;
+    char *    lock;
+
+    int32_t ofs;
+    struct cactype_ *prev, *next;          // neighbours in address order
+    struct cactype_ *freeprev, *freenext;  // size class list, free blocks only
+} cactype;
+
+typedef struct
+{
+    uint32_t allocs, hits, misses, evictions;
+    uint64_t evictedbytes;
+    int32_t  blocks, size, freebytes, lockedbytes;
+} cachestats_t;
+
 void	cacheInitBuffer(intptr_t dacachestart, int32_t dacachesize);
 void	cacheAllocateBlock(intptr_t *newhandle, int32_t newbytes, char *newlockptr);
 void	cacheAgeEntries(void);
+void	cacheGetStats(cachestats_t *stats);
 
 extern int32_t pathsearchmode;	// 0 = gamefs mode (default), 1 = localfs mode (editor's mode)
 char *listsearchpath(int32_t initp);
@@ -52,13 +71,9 @@ void	kclose(int32_t handle);
 
 void krename(int32_t crcval, int32_t filenum, const char *newname);
 char const * kfileparent(int32_t handle);
-
-typedef struct
-{
-    intptr_t *hand;
-    int32_t   leng;
-    char *    lock;
-} cactype;
+char const * kfilemapping(int32_t handle, int32_t *leng);	// read-only view of a whole GRP member, or NULL
+extern int32_t grpUseMmap;
+void kgroupbench(int32_t grpnum);
 
 enum {
     CACHE1D_FIND_FILE = 1,
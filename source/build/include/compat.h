@@ -1179,6 +1179,7 @@ char *Bstrupr(char *);
 int32_t Bfilelength(int32_t fd);
 
 uint32_t Bgetsysmemsize(void);
+int32_t Bcpuhasavx2(void);
 
 
 ////////// PANICKING ALLOCATION WRAPPERS //////////
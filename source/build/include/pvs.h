@@ -0,0 +1,30 @@
+#ifndef pvs_h_
+#define pvs_h_
+
+/* Potentially visible sector sets for pruning the renderers' portal walk */
+
+#include "compat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Row of the sector the current view starts in, or NULL if this view is not
+// pruned (r_pvs off, mirror, TROR, editor, camera outside its sector).
+extern uint8_t const *pvs_row;
+
+// Picks the row for a view from (x, y) in sectnum, building it on first use.
+// Pass sectnum < 0 to draw the next view unpruned.
+extern void pvs_beginframe(int32_t sectnum, int32_t x, int32_t y);
+extern void pvs_uninit(void);
+
+static FORCE_INLINE int32_t pvs_maysee(int32_t sectnum)
+{
+    return pvs_row == NULL || (pvs_row[sectnum>>3] & (1<<(sectnum&7)));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef sectgrid_h_
+#define sectgrid_h_
+
+/* Uniform grid over sector bounding boxes for point-in-sector lookups */
+
+#include "compat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sectors that may contain a point, highest index first so that lookups
+// return the same sector as a scan from numsectors-1 down: the ones registered
+// in the point's cell, merged with the ones that have left their cells since
+// the grid was built. Without a usable grid (editor), every sector is visited.
+typedef struct
+{
+    int16_t const *cell, *moved;
+    int32_t numcell, nummoved;
+    int32_t rest;
+} sectgrid_iter_t;
+
+extern void sectgrid_begin(int32_t x, int32_t y, sectgrid_iter_t *it);
+
+// Returns the next candidate, or -1 when there are none left.
+static FORCE_INLINE int32_t sectgrid_next(sectgrid_iter_t *it)
+{
+    if (it->nummoved > 0 && (it->numcell <= 0 || it->moved[0] >= it->cell[0]))
+        return it->nummoved--, *it->moved++;
+
+    if (it->numcell > 0)
+        return it->numcell--, *it->cell++;
+
+    return it->rest > 0 ? --it->rest : -1;
+}
+
+// To be called after wall[wallnum].x/y have been written to in place.
+// dragpoint() does this itself.
+extern void sectgrid_movedwall(int32_t wallnum);
+// Drops the grid after wall[] was replaced wholesale (map or savegame load).
+extern void sectgrid_invalidate(void);
+extern void sectgrid_uninit(void);
+
+extern void sectgrid_benchmark(int32_t numpoints);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
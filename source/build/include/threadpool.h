@@ -0,0 +1,40 @@
+#ifndef threadpool_h_
+#define threadpool_h_
+
+/* Fixed-size pool of worker threads for splitting a job into independent parts */
+
+#include "compat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAXWORKERTHREADS 16
+
+// Called once for each part in [0, numparts). Parts run concurrently, so a
+// job function must only write state that belongs to its own part.
+typedef void (*threadpool_job_t)(int32_t part, int32_t numparts, void *data);
+
+// (Re)creates the pool with the given number of workers; 0 runs every job on
+// the calling thread.
+extern void threadpool_init(int32_t numworkers);
+extern void threadpool_uninit(void);
+extern int32_t threadpool_numworkers(void);
+
+// Runs func for every part and returns once all of them have completed. The
+// calling thread takes a share of the parts itself. Must not be called from
+// inside a job.
+extern void threadpool_run(threadpool_job_t func, void *data, int32_t numparts);
+
+// Starts func(0, 1, data) on a thread of its own, outside the pool, and returns
+// at once. Returns NULL if no thread could be created, in which case func has
+// not been called. Every thread started must be passed to threadpool_join().
+extern void *threadpool_spawn(threadpool_job_t func, void *data);
+// Waits for a thread returned by threadpool_spawn() to finish.
+extern void threadpool_join(void *thread);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -12,6 +12,8 @@
 
 #include "a.h"
 #include "pragmas.h"
+#include "baselayer.h"
+#include "osd.h"
 
 #ifdef ENGINE_USING_A_C
 
@@ -59,12 +61,240 @@ void settransnormal(void) { A64_ASSIGN(a64_transmode, 0); transmode = 0; }
 void settransreverse(void) { A64_ASSIGN(a64_transmode, 1); transmode = 1; }
 
 
+///// Vector kernels /////
+
+// The column and span loops are bound by two dependent byte table lookups per
+// pixel, which no vector instruction set can do in registers. The vector
+// kernels compute the texel offsets of several pixels at once, fetch texels
+// with scalar loads and write each group of pixels with a single store. Their
+// output is identical to that of the scalar loops, which remain the reference.
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define A_C_SSE2
+# define A_C_VEC4
+# define A_C_VEC4_NAME "sse2"
+# if EDUKE32_GCC_PREREQ(4,9) || defined __clang__ || (defined _MSC_VER && _MSC_VER >= 1700)
+#  include <immintrin.h>
+#  define A_C_AVX2
+#  ifdef _MSC_VER
+#   define A_C_AVX2_TARGET
+#  else
+#   define A_C_AVX2_TARGET __attribute__((target("avx2")))
+#  endif
+# endif
+#elif defined __ARM_NEON__ || defined __ARM_NEON
+# include <arm_neon.h>
+# define A_C_NEON
+# define A_C_VEC4
+# define A_C_VEC4_NAME "neon"
+#else
+# define A_C_VEC4_NAME "vec4"
+#endif
+
+int32_t r_simd = A_C_KERNELS_AVX2;
+static int32_t a_c_kernels = A_C_KERNELS_SCALAR;
+
+static int32_t a_c_detectkernels(void)
+{
+#ifdef A_C_AVX2
+    if (Bcpuhasavx2())
+        return A_C_KERNELS_AVX2;
+#endif
+
+#ifdef A_C_VEC4
+    return A_C_KERNELS_VEC4;
+#else
+    return A_C_KERNELS_SCALAR;
+#endif
+}
+
+int32_t a_c_setkernels(int32_t kernels)
+{
+    static int32_t maxkernels = -1;
+
+    if (maxkernels < 0)
+        maxkernels = a_c_detectkernels();
+
+    return a_c_kernels = clamp(kernels, A_C_KERNELS_SCALAR, maxkernels);
+}
+
+char const *a_c_kernelname(int32_t kernels)
+{
+    static char const *const names[] = { "scalar", A_C_VEC4_NAME, "avx2" };
+    return names[clamp(kernels, A_C_KERNELS_SCALAR, A_C_KERNELS_AVX2)];
+}
+
+#if defined A_C_VEC4
+// Four lanes of uint32_t. The shift helpers take counts made by vec4_shiftr()
+// and vec4_shiftl(). Vector shifts by 32 yield zero where the scalar loops
+// would shift by 32 & 31, so callers leave counts outside 1..31 to the latter.
+# ifdef A_C_SSE2
+typedef __m128i vec4_t;
+typedef __m128i vec4shift_t;
+
+static FORCE_INLINE vec4_t vec4_set(uint32_t a, uint32_t b, uint32_t c, uint32_t d) { return _mm_set_epi32(d, c, b, a); }
+static FORCE_INLINE vec4_t vec4_dup(uint32_t a) { return _mm_set1_epi32(a); }
+static FORCE_INLINE vec4_t vec4_add(vec4_t a, vec4_t b) { return _mm_add_epi32(a, b); }
+static FORCE_INLINE vec4_t vec4_sub(vec4_t a, vec4_t b) { return _mm_sub_epi32(a, b); }
+static FORCE_INLINE vec4shift_t vec4_shiftr(int32_t n) { return _mm_cvtsi32_si128(n); }
+static FORCE_INLINE vec4shift_t vec4_shiftl(int32_t n) { return _mm_cvtsi32_si128(n); }
+static FORCE_INLINE vec4_t vec4_srl(vec4_t a, vec4shift_t n) { return _mm_srl_epi32(a, n); }
+static FORCE_INLINE vec4_t vec4_sll(vec4_t a, vec4shift_t n) { return _mm_sll_epi32(a, n); }
+static FORCE_INLINE void vec4_store(uint32_t *out, vec4_t a) { _mm_storeu_si128((__m128i *)out, a); }
+
+// ourmulscale32() of each lane with b
+static FORCE_INLINE vec4_t vec4_mulhi(vec4_t a, uint32_t b)
+{
+    vec4_t const bb = _mm_set1_epi32(b);
+    vec4_t const even = _mm_mul_epu32(a, bb);
+    vec4_t const odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), bb);
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+// vplc |= sat & (vplc < vinc), with an unsigned comparison
+static FORCE_INLINE vec4_t vec4_saturate(vec4_t vplc, vec4_t vinc, vec4_t sat)
+{
+    vec4_t const bias = _mm_set1_epi32(INT32_MIN);
+    vec4_t const lt = _mm_cmplt_epi32(_mm_xor_si128(vplc, bias), _mm_xor_si128(vinc, bias));
+    return _mm_or_si128(vplc, _mm_and_si128(sat, lt));
+}
+# else
+typedef uint32x4_t vec4_t;
+typedef int32x4_t vec4shift_t;
+
+static FORCE_INLINE vec4_t vec4_set(uint32_t a, uint32_t b, uint32_t c, uint32_t d) { uint32_t const v[4] = { a, b, c, d }; return vld1q_u32(v); }
+static FORCE_INLINE vec4_t vec4_dup(uint32_t a) { return vdupq_n_u32(a); }
+static FORCE_INLINE vec4_t vec4_add(vec4_t a, vec4_t b) { return vaddq_u32(a, b); }
+static FORCE_INLINE vec4_t vec4_sub(vec4_t a, vec4_t b) { return vsubq_u32(a, b); }
+static FORCE_INLINE vec4shift_t vec4_shiftr(int32_t n) { return vdupq_n_s32(-n); }
+static FORCE_INLINE vec4shift_t vec4_shiftl(int32_t n) { return vdupq_n_s32(n); }
+static FORCE_INLINE vec4_t vec4_srl(vec4_t a, vec4shift_t n) { return vshlq_u32(a, n); }
+static FORCE_INLINE vec4_t vec4_sll(vec4_t a, vec4shift_t n) { return vshlq_u32(a, n); }
+static FORCE_INLINE void vec4_store(uint32_t *out, vec4_t a) { vst1q_u32(out, a); }
+
+static FORCE_INLINE vec4_t vec4_mulhi(vec4_t a, uint32_t b)
+{
+    uint32x2_t const bb = vdup_n_u32(b);
+    return vcombine_u32(vshrn_n_u64(vmull_u32(vget_low_u32(a), bb), 32), vshrn_n_u64(vmull_u32(vget_high_u32(a), bb), 32));
+}
+
+static FORCE_INLINE vec4_t vec4_saturate(vec4_t vplc, vec4_t vinc, vec4_t sat)
+{
+    return vorrq_u32(vplc, vandq_u32(sat, vcltq_u32(vplc, vinc)));
+}
+# endif
+
+// Texel offsets for power-of-two (vplc>>logy) or arbitrary tile heights.
+template <bool pow2>
+static FORCE_INLINE vec4_t vec4_texofs(vec4_t vplc, vec4shift_t logy, uint32_t tilesizy)
+{
+    return pow2 ? vec4_srl(vplc, logy) : vec4_mulhi(vplc, tilesizy);
+}
+
+// Offsets into a 2^logx by 2^logy floor tile, ((u>>(32-logx))<<logy)+(v>>(32-logy)).
+static FORCE_INLINE vec4_t vec4_spanofs(vec4_t u, vec4_t v, vec4shift_t log32x, vec4shift_t logy, vec4shift_t log32y)
+{
+    return vec4_add(vec4_sll(vec4_srl(u, log32x), logy), vec4_srl(v, log32y));
+}
+#endif
+
+#ifdef A_C_AVX2
+static FORCE_INLINE A_C_AVX2_TARGET __m256i vec8_spanofs(__m256i u, __m256i v, __m128i log32x, __m128i logy, __m128i log32y)
+{
+    return _mm256_add_epi32(_mm256_sll_epi32(_mm256_srl_epi32(u, log32x), logy), _mm256_srl_epi32(v, log32y));
+}
+#endif
+
+// The span kernels shift by 32-logx and 32-logy, see vec4_srl().
+static FORCE_INLINE int32_t a_c_spanlogsok(int32_t logx, int32_t logy)
+{
+    return (unsigned)(logx-1) < 31 && (unsigned)(logy-1) < 31;
+}
+
+
 ///// Ceiling/floor horizontal line functions /////
 
 void sethlinesizes(int32_t logx, int32_t logy, intptr_t bufplc)
 { glogx = logx; glogy = logy; gbuf = (char *)bufplc; }
 void setpalookupaddress(char *paladdr) { ghlinepal = paladdr; }
 void setuphlineasm4(int32_t bxinc, int32_t byinc) { gbxinc = bxinc; gbyinc = byinc; }
+
+#ifdef A_C_VEC4
+# ifdef A_C_AVX2
+static A_C_AVX2_TARGET void hlineasm4_avx2(bssize_t &rcnt, const char *const A_C_RESTRICT palptr, const char *const A_C_RESTRICT buf,
+                                           vec2_t const inc, vec2_t const log, uint32_t &rby, uint32_t &rbx, char *&rpp)
+{
+    // Work on copies so that the byte stores cannot alias the loop state.
+    bssize_t cnt = rcnt;
+    uint32_t by = rby, bx = rbx;
+    char *pp = rpp;
+
+    __m128i const log32x = _mm_cvtsi32_si128(32-log.x), logy = _mm_cvtsi32_si128(log.y), log32y = _mm_cvtsi32_si128(32-log.y);
+    __m256i const step = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i const xofs = _mm256_mullo_epi32(_mm256_set1_epi32(inc.x), step);
+    __m256i const yofs = _mm256_mullo_epi32(_mm256_set1_epi32(inc.y), step);
+    uint32_t ofs[8];
+    char pix[8];
+
+    for (; cnt>=7; cnt-=8, pp-=8)
+    {
+        __m256i const u = _mm256_sub_epi32(_mm256_set1_epi32(bx), xofs);
+        __m256i const v = _mm256_sub_epi32(_mm256_set1_epi32(by), yofs);
+
+        _mm256_storeu_si256((__m256i *)ofs, vec8_spanofs(u, v, log32x, logy, log32y));
+
+        pix[7] = palptr[buf[ofs[0]]];
+        pix[6] = palptr[buf[ofs[1]]];
+        pix[5] = palptr[buf[ofs[2]]];
+        pix[4] = palptr[buf[ofs[3]]];
+        pix[3] = palptr[buf[ofs[4]]];
+        pix[2] = palptr[buf[ofs[5]]];
+        pix[1] = palptr[buf[ofs[6]]];
+        pix[0] = palptr[buf[ofs[7]]];
+
+        Bmemcpy(pp-7, pix, 8);
+
+        bx -= (uint32_t)inc.x<<3;
+        by -= (uint32_t)inc.y<<3;
+    }
+
+    rcnt = cnt; rby = by; rbx = bx; rpp = pp;
+}
+# endif
+
+static void hlineasm4_vec4(bssize_t &rcnt, const char *const A_C_RESTRICT palptr, const char *const A_C_RESTRICT buf,
+                           vec2_t const inc, vec2_t const log, uint32_t &rby, uint32_t &rbx, char *&rpp)
+{
+    bssize_t cnt = rcnt;
+    uint32_t by = rby, bx = rbx;
+    char *pp = rpp;
+
+    vec4shift_t const log32x = vec4_shiftr(32-log.x), logy = vec4_shiftl(log.y), log32y = vec4_shiftr(32-log.y);
+    vec4_t const xofs = vec4_set(0, inc.x, (uint32_t)inc.x*2, (uint32_t)inc.x*3);
+    vec4_t const yofs = vec4_set(0, inc.y, (uint32_t)inc.y*2, (uint32_t)inc.y*3);
+    uint32_t ofs[4];
+    char pix[4];
+
+    for (; cnt>=3; cnt-=4, pp-=4)
+    {
+        vec4_store(ofs, vec4_spanofs(vec4_sub(vec4_dup(bx), xofs), vec4_sub(vec4_dup(by), yofs), log32x, logy, log32y));
+
+        pix[3] = palptr[buf[ofs[0]]];
+        pix[2] = palptr[buf[ofs[1]]];
+        pix[1] = palptr[buf[ofs[2]]];
+        pix[0] = palptr[buf[ofs[3]]];
+
+        Bmemcpy(pp-3, pix, 4);
+
+        bx -= (uint32_t)inc.x<<2;
+        by -= (uint32_t)inc.y<<2;
+    }
+
+    rcnt = cnt; rby = by; rbx = bx; rpp = pp;
+}
+#endif
+
 void hlineasm4(bssize_t cnt, int32_t skiploadincs, int32_t paloffs, uint32_t by, uint32_t bx, intptr_t p)
 {
     Bassert(gbuf);
@@ -78,6 +308,17 @@ void hlineasm4(bssize_t cnt, int32_t skiploadincs, int32_t paloffs, uint32_t by,
     const vec2_t log32 = { 32-log.x, 32-log.y };
     char *pp = (char *)p;
 
+#ifdef A_C_VEC4
+    if (a_c_kernels != A_C_KERNELS_SCALAR && a_c_spanlogsok(log.x, log.y))
+    {
+# ifdef A_C_AVX2
+        if (a_c_kernels == A_C_KERNELS_AVX2)
+            hlineasm4_avx2(cnt, palptr, buf, inc, log, by, bx, pp);
+# endif
+        hlineasm4_vec4(cnt, palptr, buf, inc, log, by, bx, pp);
+    }
+#endif
+
 #ifdef CLASSIC_SLICE_BY_4
     for (; cnt>=4; cnt-=4, pp-=4)
     {
@@ -263,6 +504,38 @@ static void vlineasm4nlogy(bssize_t cnt, char *p, char *const A_C_RESTRICT * pal
 }
 #endif
 
+#ifdef A_C_VEC4
+// cnt >= 1
+template <bool pow2>
+static void vlineasm4_vec4(bssize_t cnt, char *p, char *const A_C_RESTRICT * pal, char *const A_C_RESTRICT * buf, int32_t logy)
+{
+    vec4_t vplc = vec4_set(vplce[0], vplce[1], vplce[2], vplce[3]);
+    vec4_t const vinc = vec4_set(vince[0], vince[1], vince[2], vince[3]);
+    vec4shift_t const shift = vec4_shiftr(logy);
+    uint32_t const tilesizy = globaltilesizy;
+    int32_t const ourbpl = bpl;
+    uint32_t ofs[4];
+    char pix[4];
+
+    do
+    {
+        vec4_store(ofs, vec4_texofs<pow2>(vplc, shift, tilesizy));
+
+        pix[0] = pal[0][buf[0][ofs[0]]];
+        pix[1] = pal[1][buf[1][ofs[1]]];
+        pix[2] = pal[2][buf[2][ofs[2]]];
+        pix[3] = pal[3][buf[3][ofs[3]]];
+
+        Bmemcpy(p, pix, 4);
+
+        vplc = vec4_add(vplc, vinc);
+        p += ourbpl;
+    } while (--cnt);
+
+    vec4_store(vplce, vplc);
+}
+#endif
+
 // cnt >= 1
 void vlineasm4(bssize_t cnt, char *p)
 {
@@ -277,6 +550,17 @@ void vlineasm4(bssize_t cnt, char *p)
 #endif
     const int32_t logy = glogy, ourbpl = bpl;
 
+#ifdef A_C_VEC4
+    if (a_c_kernels != A_C_KERNELS_SCALAR && (unsigned)logy < 32)
+    {
+        if (logy)
+            vlineasm4_vec4<true>(cnt, p, pal, buf, logy);
+        else
+            vlineasm4_vec4<false>(cnt, p, pal, buf, logy);
+        return;
+    }
+#endif
+
 #ifdef CLASSIC_NONPOW2_YSIZE_WALLS
     if (EDUKE32_PREDICT_FALSE(!logy))
     {
@@ -396,6 +680,55 @@ int32_t mvlineasm1(int32_t vinc, intptr_t paloffs, bssize_t cnt, uint32_t vplc,
     return vplc;
 }
 
+#ifdef A_C_VEC4
+// cnt >= 1
+template <bool pow2>
+static void mvlineasm4_vec4(bssize_t cnt, char *p, char *const A_C_RESTRICT * pal, char *const A_C_RESTRICT * buf, int32_t logy)
+{
+    vec4_t vplc = vec4_set(vplce[0], vplce[1], vplce[2], vplce[3]);
+    vec4_t const vinc = vec4_set(vince[0], vince[1], vince[2], vince[3]);
+    vec4shift_t const shift = vec4_shiftr(logy);
+# ifdef USE_SATURATE_VPLC
+    vec4_t const sat = vec4_dup(g_saturate);
+# endif
+    uint32_t const tilesizy = globaltilesizy;
+    int32_t const ourbpl = bpl;
+    uint32_t ofs[4];
+    char tex[4], pix[4];
+
+    do
+    {
+        vec4_store(ofs, vec4_texofs<pow2>(vplc, shift, tilesizy));
+
+        tex[0] = buf[0][ofs[0]];
+        tex[1] = buf[1][ofs[1]];
+        tex[2] = buf[2][ofs[2]];
+        tex[3] = buf[3][ofs[3]];
+
+        if ((tex[0] & tex[1] & tex[2] & tex[3]) != 255)
+        {
+            Bmemcpy(pix, p, 4);
+
+            if (tex[0] != 255) pix[0] = pal[0][tex[0]];
+            if (tex[1] != 255) pix[1] = pal[1][tex[1]];
+            if (tex[2] != 255) pix[2] = pal[2][tex[2]];
+            if (tex[3] != 255) pix[3] = pal[3][tex[3]];
+
+            Bmemcpy(p, pix, 4);
+        }
+
+        vplc = vec4_add(vplc, vinc);
+# ifdef USE_SATURATE_VPLC
+        vplc = vec4_saturate(vplc, vinc, sat);
+# endif
+        p += ourbpl;
+    }
+    while (--cnt);
+
+    vec4_store(vplce, vplc);
+}
+#endif
+
 // cnt >= 1
 void mvlineasm4(bssize_t cnt, char *p)
 {
@@ -411,6 +744,17 @@ void mvlineasm4(bssize_t cnt, char *p)
     const int32_t logy = glogy, ourbpl = bpl;
     char ch;
 
+#ifdef A_C_VEC4
+    if (a_c_kernels != A_C_KERNELS_SCALAR && (unsigned)logy < 32)
+    {
+        if (logy)
+            mvlineasm4_vec4<true>(cnt, p, pal, buf, logy);
+        else
+            mvlineasm4_vec4<false>(cnt, p, pal, buf, logy);
+        return;
+    }
+#endif
+
     if (logy)
     {
         do
@@ -594,6 +938,50 @@ void mhline(intptr_t bufplc, uint32_t bx, int32_t cntup16, int32_t junk, uint32_
 }
 
 void tsethlineshift(int32_t logx, int32_t logy) { glogx = logx; glogy = logy; }
+
+#ifdef A_C_VEC4
+static void thline_vec4(int32_t &rcnt, uint32_t &rbx, uint32_t &rby, int32_t const xinc, int32_t const yinc, uint8_t const shift, intptr_t &rp)
+{
+    int32_t cnt = rcnt;
+    uint32_t bx = rbx, by = rby;
+    intptr_t p = rp;
+
+    vec4shift_t const log32x = vec4_shiftr(32-glogx), logy = vec4_shiftl(glogy), log32y = vec4_shiftr(32-glogy);
+    vec4_t const xofs = vec4_set(0, xinc, (uint32_t)xinc*2, (uint32_t)xinc*3);
+    vec4_t const yofs = vec4_set(0, yinc, (uint32_t)yinc*2, (uint32_t)yinc*3);
+    const char *const A_C_RESTRICT buf = gbuf;
+    const char *const A_C_RESTRICT pal = gpal;
+    const char *const A_C_RESTRICT trans = gtrans;
+    uint32_t ofs[4];
+    char tex[4], pix[4];
+
+    // leave at least one pixel for the do-while loop in thline()
+    for (; cnt>4; cnt-=4, p+=4)
+    {
+        vec4_store(ofs, vec4_spanofs(vec4_add(vec4_dup(bx), xofs), vec4_add(vec4_dup(by), yofs), log32x, logy, log32y));
+
+        Bmemcpy(pix, (char *)p, 4);
+
+        tex[0] = buf[ofs[0]];
+        tex[1] = buf[ofs[1]];
+        tex[2] = buf[ofs[2]];
+        tex[3] = buf[ofs[3]];
+
+        if (tex[0] != 255) pix[0] = trans[(pix[0]<<(8-shift))|(pal[tex[0]]<<shift)];
+        if (tex[1] != 255) pix[1] = trans[(pix[1]<<(8-shift))|(pal[tex[1]]<<shift)];
+        if (tex[2] != 255) pix[2] = trans[(pix[2]<<(8-shift))|(pal[tex[2]]<<shift)];
+        if (tex[3] != 255) pix[3] = trans[(pix[3]<<(8-shift))|(pal[tex[3]]<<shift)];
+
+        Bmemcpy((char *)p, pix, 4);
+
+        bx += (uint32_t)xinc<<2;
+        by += (uint32_t)yinc<<2;
+    }
+
+    rcnt = cnt; rbx = bx; rby = by; rp = p;
+}
+#endif
+
 // cntup16>>16 + 1 iterations
 void thline(intptr_t bufplc, uint32_t bx, int32_t cntup16, int32_t junk, uint32_t by, intptr_t p)
 {
@@ -611,6 +999,11 @@ void thline(intptr_t bufplc, uint32_t bx, int32_t cntup16, int32_t junk, uint32_
 
     uint8_t const shift = transmode<<3;
 
+#ifdef A_C_VEC4
+    if (a_c_kernels != A_C_KERNELS_SCALAR && a_c_spanlogsok(glogx, glogy))
+        thline_vec4(cntup16, bx, by, xinc, yinc, shift, p);
+#endif
+
     do
     {
         ch = gbuf[((bx>>(32-glogx))<<glogy)+(by>>(32-glogy))];
@@ -722,6 +1115,224 @@ void stretchhline(intptr_t p0, int32_t u, bssize_t cnt, int32_t uinc, intptr_t r
 }
 #endif
 
+///// Kernel benchmark /////
+
+#define KBENCH_XDIM 512
+#define KBENCH_YDIM 256
+
+typedef struct
+{
+    char *frame, *tex, *pal, *trans;
+    intptr_t *slopal;
+} kbench_t;
+
+static void kbench_vlineasm4(kbench_t const *b)
+{
+    setupvlineasm(24);
+
+    for (int x = 0; x < KBENCH_XDIM; x += 4)
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            palookupoffse[k] = (intptr_t)b->pal;
+            bufplce[k] = (intptr_t)b->tex + (((x+k)*37)&255)*256;
+            vplce[k] = (x+k)*2654435761u;
+            vince[k] = (1<<23) + (x+k)*4099;
+        }
+
+        vlineasm4(KBENCH_YDIM, b->frame + x);
+    }
+}
+
+static void kbench_mvlineasm4(kbench_t const *b)
+{
+    setupmvlineasm(24, 1);
+
+    for (int x = 0; x < KBENCH_XDIM; x += 4)
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            palookupoffse[k] = (intptr_t)b->pal;
+            bufplce[k] = (intptr_t)b->tex + (((x+k)*37)&255)*256;
+            vplce[k] = (x+k)*2654435761u;
+            vince[k] = (1<<23) + (x+k)*4099;
+        }
+
+        mvlineasm4(KBENCH_YDIM, b->frame + x);
+    }
+}
+
+static void kbench_tvlineasm2(kbench_t const *b)
+{
+    setuptvlineasm2(24, (intptr_t)b->pal, (intptr_t)b->pal + 256);
+
+    for (int x = 0; x < KBENCH_XDIM; x += 2)
+    {
+        intptr_t const p = (intptr_t)b->frame + x;
+
+        asm1 = (1<<23) + (x+1)*4099;
+        asm2 = p + (KBENCH_YDIM-1)*KBENCH_XDIM + 1;
+        tvlineasm2((x+1)*2654435761u, (1<<23) + x*4099, (intptr_t)b->tex + ((x*37)&255)*256,
+                   (intptr_t)b->tex + (((x+1)*37)&255)*256, x*2654435761u, p);
+    }
+}
+
+static void kbench_hlineasm4(kbench_t const *b)
+{
+    sethlinesizes(8, 8, (intptr_t)b->tex);
+    setpalookupaddress(b->pal);
+
+    for (int y = 0; y < KBENCH_YDIM; y++)
+    {
+        asm1 = (1<<22) + y*1237;
+        asm2 = (1<<21) - y*3571;
+        hlineasm4(KBENCH_XDIM-1, 0, 0, y*2246822519u, y*2654435761u, (intptr_t)b->frame + y*KBENCH_XDIM + KBENCH_XDIM-1);
+    }
+}
+
+static void kbench_slopevlin(kbench_t const *b)
+{
+    sethlinesizes(8, 8, (intptr_t)b->tex);
+    gpinc = -KBENCH_XDIM;
+    globalx3 = 0x3c5;
+    globaly3 = -0x2a1;
+
+    for (int x = 0; x < KBENCH_XDIM; x++)
+    {
+        asm1 = 2000<<3;
+        asm3 = -400000 + x*256;
+        slopevlin((intptr_t)b->frame + (KBENCH_YDIM-1)*KBENCH_XDIM + x, 0, (intptr_t)&b->slopal[KBENCH_YDIM-1], KBENCH_YDIM,
+                  x*2654435761u, x*2246822519u);
+    }
+}
+
+static void kbench_thline(kbench_t const *b)
+{
+    tsethlineshift(8, 8);
+
+    for (int y = 0; y < KBENCH_YDIM; y++)
+    {
+        asm1 = (1<<22) + y*1237;
+        asm2 = (1<<21) - y*3571;
+        asm3 = (intptr_t)b->pal;
+        thline((intptr_t)b->tex, y*2654435761u, (KBENCH_XDIM-1)<<16, 0, y*2246822519u, (intptr_t)b->frame + y*KBENCH_XDIM);
+    }
+}
+
+static void kbench_clearframe(char *frame)
+{
+    for (int i = 0; i < KBENCH_XDIM*KBENCH_YDIM; i++)
+        frame[i] = (char)(i*13);
+}
+
+// Times each kernel with every instruction set the CPU supports and checks
+// that the vector kernels reproduce the output of the scalar ones.
+void a_c_benchmark(int32_t numframes)
+{
+    static struct { char const *name; void (*func)(kbench_t const *); } const routines[] =
+    {
+        { "vlineasm4", kbench_vlineasm4 },
+        { "mvlineasm4", kbench_mvlineasm4 },
+        { "tvlineasm2", kbench_tvlineasm2 },
+        { "hlineasm4", kbench_hlineasm4 },
+        { "slopevlin", kbench_slopevlin },
+        { "thline", kbench_thline },
+    };
+
+    // The kernels keep their setup in globals shared with the renderer.
+    int32_t const obpl = bpl, otransmode = transmode, oglogx = glogx, oglogy = glogy, ogpinc = gpinc;
+    int32_t const ogbxinc = gbxinc, ogbyinc = gbyinc, oglobalx3 = globalx3, oglobaly3 = globaly3;
+    char *const ogbuf = gbuf, *const ogpal = gpal, *const ogpal2 = gpal2, *const oghlinepal = ghlinepal, *const ogtrans = gtrans;
+    intptr_t const oasm1 = asm1, oasm2 = asm2, oasm3 = asm3;
+#ifdef USE_SATURATE_VPLC
+    int32_t const og_saturate = g_saturate;
+#endif
+
+    kbench_t b;
+    char *const ref = (char *)Xmalloc(KBENCH_XDIM*KBENCH_YDIM);
+
+    b.frame = (char *)Xmalloc(KBENCH_XDIM*KBENCH_YDIM);
+    b.tex = (char *)Xmalloc(256*256);
+    b.pal = (char *)Xmalloc(2*256);
+    b.trans = (char *)Xmalloc(256*256);
+    b.slopal = (intptr_t *)Xmalloc(KBENCH_YDIM*sizeof(intptr_t));
+
+    uint32_t seed = 1;
+
+    for (int i = 0; i < 256*256; i++)
+    {
+        seed = seed*1664525 + 1013904223;
+        b.tex[i] = (seed>>29) ? (char)(seed>>20) : 255;  // 1/8 transparent
+        b.trans[i] = (char)(seed>>12);
+    }
+
+    for (int i = 0; i < 2*256; i++)
+        b.pal[i] = (char)(i*7+3);
+
+    for (int i = 0; i < KBENCH_YDIM; i++)
+        b.slopal[i] = (intptr_t)b.pal + (i&1)*256;
+
+    setvlinebpl(KBENCH_XDIM);
+    fixtransluscence((intptr_t)b.trans);
+    settransnormal();
+
+    int32_t const maxkernels = a_c_setkernels(A_C_KERNELS_AVX2);
+
+    OSD_Printf("Kernel benchmark, %d frames of %dx%d:\n", numframes, KBENCH_XDIM, KBENCH_YDIM);
+
+    for (auto const &r : routines)
+    {
+        double scalarmpps = 0.0;
+
+        for (int32_t kernels = A_C_KERNELS_SCALAR; kernels <= maxkernels; kernels++)
+        {
+            a_c_setkernels(kernels);
+
+            kbench_clearframe(b.frame);
+            r.func(&b);
+
+            bool const match = (kernels == A_C_KERNELS_SCALAR) || !Bmemcmp(ref, b.frame, KBENCH_XDIM*KBENCH_YDIM);
+
+            if (kernels == A_C_KERNELS_SCALAR)
+                Bmemcpy(ref, b.frame, KBENCH_XDIM*KBENCH_YDIM);
+
+            double const t0 = timerGetHiTicks();
+
+            for (int32_t n = 0; n < numframes; n++)
+                r.func(&b);
+
+            double const ms = max(timerGetHiTicks() - t0, 0.001);
+            double const mpps = (double)numframes*KBENCH_XDIM*KBENCH_YDIM / (ms*1000.0);
+
+            if (kernels == A_C_KERNELS_SCALAR)
+                scalarmpps = mpps;
+
+            OSD_Printf("  %-11s %-7s %8.1f Mpix/s %6.2fx%s\n", r.name, a_c_kernelname(kernels), mpps, mpps/scalarmpps,
+                       match ? "" : "  OUTPUT MISMATCH");
+        }
+    }
+
+    a_c_setkernels(r_simd);
+
+    setvlinebpl(obpl);
+    fixtransluscence((intptr_t)ogtrans);
+    if (otransmode) settransreverse(); else settransnormal();
+    glogx = oglogx; glogy = oglogy; gpinc = ogpinc;
+    gbxinc = ogbxinc; gbyinc = ogbyinc; globalx3 = oglobalx3; globaly3 = oglobaly3;
+    gbuf = ogbuf; gpal = ogpal; gpal2 = ogpal2; ghlinepal = oghlinepal;
+    asm1 = oasm1; asm2 = oasm2; asm3 = oasm3;
+#ifdef USE_SATURATE_VPLC
+    g_saturate = og_saturate;
+#endif
+
+    Bfree(b.slopal);
+    Bfree(b.trans);
+    Bfree(b.pal);
+    Bfree(b.tex);
+    Bfree(b.frame);
+    Bfree(ref);
+}
+
 #endif
 /*
  * vim:ts=4:
@@ -8,6 +8,8 @@
 #include "a.h"
 #include "polymost.h"
 #include "cache1d.h"
+#include "threadpool.h"
+#include "sectgrid.h"
 
 // video
 #ifdef _WIN32
@@ -235,6 +237,9 @@ void makeasmwriteable(void)
 int32_t vsync=0;
 int32_t g_logFlushWindow = 1;
 
+// headlessvideo: render into the software surface only, never to a window or device (demo benchmarks)
+char headlessvideo = 0;
+
 #ifdef USE_OPENGL
 struct glinfo_t glinfo =
 {
@@ -406,6 +411,26 @@ int osdcmd_glinfo(osdcmdptr_t UNUSED(parm))
 }
 #endif
 
+#ifdef ENGINE_USING_A_C
+static int osdcmd_kernelbench(osdcmdptr_t parm)
+{
+    if (parm->numparms > 1) return OSDCMD_SHOWHELP;
+
+    a_c_benchmark(parm->numparms ? clamp(Batol(parm->parms[0]), 1, 1000) : 16);
+
+    return OSDCMD_OK;
+}
+#endif
+
+static int osdcmd_sectgridbench(osdcmdptr_t parm)
+{
+    if (parm->numparms > 1) return OSDCMD_SHOWHELP;
+
+    sectgrid_benchmark(parm->numparms ? clamp(Batol(parm->parms[0]), 1, 10000000) : 100000);
+
+    return OSDCMD_OK;
+}
+
 static int osdcmd_cvar_set_baselayer(osdcmdptr_t parm)
 {
     int32_t r = osdcmd_cvar_set(parm);
@@ -418,6 +443,20 @@ static int osdcmd_cvar_set_baselayer(osdcmdptr_t parm)
 
         return r;
     }
+    else if (!Bstrcasecmp(parm->name, "r_blitthreads"))
+    {
+        threadpool_init(r_blitthreads);
+
+        return r;
+    }
+#ifdef ENGINE_USING_A_C
+    else if (!Bstrcasecmp(parm->name, "r_simd"))
+    {
+        a_c_setkernels(r_simd);
+
+        return r;
+    }
+#endif
 
     return r;
 }
@@ -434,11 +473,17 @@ int32_t baselayer_init(void)
     static osdcvardata_t cvars_engine[] =
     {
         { "lz4compressionlevel","adjust LZ4 compression level used for savegames",(void *) &lz4CompressionLevel, CVAR_INT, 1, 32 },
+        { "grpmmap","enable/disable memory-mapped reads from group files",(void *) &grpUseMmap, CVAR_BOOL, 0, 1 },
         { "r_usenewaspect","enable/disable new screen aspect ratio determination code",(void *) &r_usenewaspect, CVAR_BOOL, 0, 1 },
         { "r_screenaspect","if using r_usenewaspect and in fullscreen, screen aspect ratio in the form XXYY, e.g. 1609 for 16:9",
           (void *) &r_screenxy, SCREENASPECT_CVAR_TYPE, 0, 9999 },
         { "r_novoxmips","turn off/on the use of mipmaps when rendering 8-bit voxels",(void *) &novoxmips, CVAR_BOOL, 0, 1 },
         { "r_voxels","enable/disable automatic sprite->voxel rendering",(void *) &usevoxels, CVAR_BOOL, 0, 1 },
+        { "r_pvs","enable/disable pruning of the renderers' sector walk with precomputed sector visibility",(void *) &r_pvs, CVAR_BOOL, 0, 1 },
+        { "r_blitthreads","number of worker threads used to copy the 8-bit frame to the window (0: off)",(void *) &r_blitthreads, CVAR_INT|CVAR_FUNCPTR, 0, MAXWORKERTHREADS },
+#ifdef ENGINE_USING_A_C
+        { "r_simd","vector kernels used by software rendering (0: scalar, 1: SSE2/NEON, 2: AVX2)",(void *) &r_simd, CVAR_INT|CVAR_FUNCPTR, A_C_KERNELS_SCALAR, A_C_KERNELS_AVX2 },
+#endif
 #ifdef YAX_ENABLE
         { "r_tror_nomaskpass", "enable/disable additional pass in TROR software rendering", (void *)&r_tror_nomaskpass, CVAR_BOOL, 0, 1 },
 #endif
@@ -458,6 +503,16 @@ int32_t baselayer_init(void)
     for (auto & i : cvars_engine)
         OSD_RegisterCvar(&i, (i.flags & CVAR_FUNCPTR) ? osdcmd_cvar_set_baselayer : osdcmd_cvar_set);
 
+#ifdef ENGINE_USING_A_C
+    a_c_setkernels(r_simd);
+
+    OSD_RegisterFunction("kernelbench","kernelbench [frames]: times the software rendering kernels with each supported instruction set",
+                         osdcmd_kernelbench);
+#endif
+
+    OSD_RegisterFunction("sectgridbench","sectgridbench [points]: times sector lookups at random points of the map with and without the sector grid",
+                         osdcmd_sectgridbench);
+
 #ifdef USE_OPENGL
     OSD_RegisterFunction("setrendermode","setrendermode <number>: sets the engine's rendering mode.\n"
                          "Mode numbers are:\n"
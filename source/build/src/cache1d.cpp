@@ -12,8 +12,14 @@
 // for FILENAME_CASE_CHECK
 # define NEED_SHELLAPI_H
 # include "windows_inc.h"
+# include <io.h>
+# define CACHE1D_MMAP
+#elif !defined GEKKO && !defined __PSP2__
+# include <sys/mman.h>
+# define CACHE1D_MMAP
 #endif
 #include "cache1d.h"
+#include "hash.h"
 #include "pragmas.h"
 #include "baselayer.h"
 #include "lz4.h"
@@ -98,16 +104,157 @@ int32_t kpzbufload(char const * const filnam)
 //           After calling uninitcache, it is still ok to call allocache
 //           without first calling initcache.
 
-#define MAXCACHEOBJECTS 9216
+//   Internally, the cache is a list of blocks in address order. Free space is
+//   additionally kept on segregated free lists (one per power-of-two size
+//   class), so most allocations are satisfied without touching any other
+//   block. Only when no free block is large enough do we look for the
+//   contiguous run of unlocked blocks that is cheapest to evict, in a single
+//   pass over the block list. Block descriptors come from a growable pool, so
+//   there is no upper limit on the number of objects in the cache.
+//
+//   Lock byte semantics are unchanged: 0 means the region may be reused
+//   without notice, 1..199 means evictable with the cost rising with the
+//   lock value, and 200+ means the region may not be removed.
 
 #if !defined DEBUG_ALLOCACHE_AS_MALLOC
+#define CACHE_NUMSIZECLASSES 28
+#define CACHE_DESCCHUNK 1024
+
 static int32_t cachesize = 0;
 static char zerochar = 0;
 static intptr_t cachestart = 0;
 static int32_t lockrecip[200];
 
 int32_t cacnum = 0;
-cactype cac[MAXCACHEOBJECTS];
+cactype *cacfirst, *caclast;
+
+static cactype *cacfree[CACHE_NUMSIZECLASSES];
+static cactype *cacdescfree;
+static cactype *cacagecursor;
+
+static cachestats_t cachestats;
+
+static FORCE_INLINE int cacheIsFree(cactype const *blk) { return blk->lock == &zerochar; }
+
+static inline int cacheSizeClass(int32_t leng)
+{
+    int c = 0;
+    for (leng >>= 5; leng && c < CACHE_NUMSIZECLASSES-1; leng >>= 1)
+        c++;
+    return c;
+}
+
+static cactype *cacheNewDesc(void)
+{
+    if (cacdescfree == NULL)
+    {
+        // descriptors are never returned to the heap, only to this pool
+        auto chunk = (cactype *)Xcalloc(CACHE_DESCCHUNK, sizeof(cactype));
+
+        for (int i = 0; i < CACHE_DESCCHUNK; i++)
+        {
+            chunk[i].next = cacdescfree;
+            cacdescfree = &chunk[i];
+        }
+    }
+
+    cactype *blk = cacdescfree;
+    cacdescfree = blk->next;
+    Bmemset(blk, 0, sizeof(cactype));
+    cacnum++;
+    return blk;
+}
+
+static void cacheFreeDesc(cactype *blk)
+{
+    if (cacagecursor == blk)
+        cacagecursor = blk->next;
+
+    blk->next = cacdescfree;
+    cacdescfree = blk;
+    cacnum--;
+}
+
+static void cacheLinkFree(cactype *blk)
+{
+    int const c = cacheSizeClass(blk->leng);
+
+    blk->lock = &zerochar;
+    blk->hand = NULL;
+    blk->freeprev = NULL;
+    blk->freenext = cacfree[c];
+
+    if (cacfree[c])
+        cacfree[c]->freeprev = blk;
+
+    cacfree[c] = blk;
+}
+
+static void cacheUnlinkFree(cactype *blk)
+{
+    if (blk->freeprev)
+        blk->freeprev->freenext = blk->freenext;
+    else
+        cacfree[cacheSizeClass(blk->leng)] = blk->freenext;
+
+    if (blk->freenext)
+        blk->freenext->freeprev = blk->freeprev;
+
+    blk->freeprev = blk->freenext = NULL;
+}
+
+// removes blk from the address-ordered list and returns its descriptor to the pool
+static void cacheRemoveBlock(cactype *blk)
+{
+    if (blk->prev) blk->prev->next = blk->next;
+    else cacfirst = blk->next;
+
+    if (blk->next) blk->next->prev = blk->prev;
+    else caclast = blk->prev;
+
+    cacheFreeDesc(blk);
+}
+
+// inserts a free block of sucklen bytes after blk, merging it with a free successor
+static void cacheInsertFreeAfter(cactype *blk, int32_t sucklen)
+{
+    if (sucklen <= 0)
+        return;
+
+    cactype *next = blk->next;
+
+    if (next && cacheIsFree(next))
+    {
+        cacheUnlinkFree(next);
+        next->ofs  -= sucklen;
+        next->leng += sucklen;
+        cacheLinkFree(next);
+        return;
+    }
+
+    cactype *nblk = cacheNewDesc();
+
+    nblk->ofs  = blk->ofs + blk->leng;
+    nblk->leng = sucklen;
+    nblk->prev = blk;
+    nblk->next = next;
+
+    if (next) next->prev = nblk;
+    else caclast = nblk;
+
+    blk->next = nblk;
+
+    cacheLinkFree(nblk);
+}
+
+static FORCE_INLINE int32_t cacheEvictCost(cactype const *blk)
+{
+    // Potential for eviction increases with
+    //  - smaller item size
+    //  - smaller lock byte value (but in [1 .. 199])
+    return (cacheIsFree(blk) || *blk->lock == 0) ? 0 : mulscale32(blk->leng + 65536, lockrecip[*blk->lock]);
+}
+
 #endif
 
 char toupperlookup[256] =
@@ -147,9 +294,16 @@ void cacheInitBuffer(intptr_t dacachestart, int32_t dacachesize)
     cachestart = ((uintptr_t)dacachestart+15)&~(uintptr_t)0xf;
     cachesize = (dacachesize-(((uintptr_t)(dacachestart))&0xf))&~(uintptr_t)0xf;
 
-    cac[0].leng = cachesize;
-    cac[0].lock = &zerochar;
-    cacnum = 1;
+    while (cacfirst)
+        cacheRemoveBlock(cacfirst);
+
+    Bmemset(cacfree, 0, sizeof(cacfree));
+    Bmemset(&cachestats, 0, sizeof(cachestats));
+
+    cactype *blk = cacheNewDesc();
+    blk->leng = cachesize;
+    cacfirst = caclast = cacagecursor = blk;
+    cacheLinkFree(blk);
 
     initprintf("Initialized %.1fM cache\n", (float)(dacachesize/1024.f/1024.f));
 #else
@@ -166,146 +320,175 @@ void cacheAllocateBlock(intptr_t *newhandle, int32_t newbytes, char *newlockptr)
     *newhandle = (intptr_t)Xmalloc(newbytes);
 }
 #else
-static inline void inc_and_check_cacnum(void)
+// returns the smallest-class free block that fits, or NULL
+static cactype *cacheFindFree(int32_t newbytes)
 {
-    if (EDUKE32_PREDICT_FALSE(++cacnum > MAXCACHEOBJECTS))
-        reportandexit("Too many objects in cache! (cacnum > MAXCACHEOBJECTS)");
+    for (int c = cacheSizeClass(newbytes); c < CACHE_NUMSIZECLASSES; c++)
+        for (cactype *blk = cacfree[c]; blk; blk = blk->freenext)
+            if (blk->leng >= newbytes)
+                return blk;
+
+    return NULL;
 }
 
-void cacheAllocateBlock(intptr_t *newhandle, int32_t newbytes, char *newlockptr)
+// Finds the start of the contiguous run of blocks totalling at least newbytes
+// that is cheapest to evict. Both ends of the window only ever move forward,
+// so this is a single pass over the block list.
+static cactype *cacheFindEvictable(int32_t newbytes)
 {
-    if (EDUKE32_PREDICT_FALSE(*newlockptr == 0))
-        reportandexit("ALLOCACHE CALLED WITH LOCK OF 0!");
+    cactype *best    = NULL;
+    int32_t  bestval = INT32_MAX;
 
-    // Make all requests a multiple of 16 bytes
-    newbytes = (newbytes + 15) & ~0xf;
+    cactype *end    = cacfirst;
+    int32_t  winlen = 0;
+    int32_t  winval = 0;
 
-    if (EDUKE32_PREDICT_FALSE((unsigned)newbytes > (unsigned)cachesize))
+    for (cactype *blk = cacfirst; blk; blk = blk->next)
     {
-        initprintf("Cachesize: %d\n",cachesize);
-        initprintf("*Newhandle: 0x%" PRIxPTR ", Newbytes: %d, *Newlock: %d\n",(intptr_t)newhandle,newbytes,*newlockptr);
-        reportandexit("BUFFER TOO BIG TO FIT IN CACHE!");
-    }
-
-    int32_t bestz   = 0;
-    int32_t besto   = 0;
-    int32_t bestval = 0x7fffffff;
-
-    for (native_t z=cacnum-1, o1=cachesize; z>=0; z--)
-    {
-        o1 -= cac[z].leng;
-        int32_t o2 = o1 + newbytes;
-
-        if (o2 > cachesize)
-            continue;
-
-        int32_t daval = 0;
+        if (end == blk)
+            winlen = winval = 0;
 
-        for (native_t i=o1, zz=z; i<o2; i+=cac[zz++].leng)
+        while (winlen < newbytes && end && (cacheIsFree(end) || *end->lock < 200))
         {
-            if (*cac[zz].lock == 0)
-                continue;
+            winlen += end->leng;
+            winval += cacheEvictCost(end);
+            end = end->next;
+        }
 
-            if (*cac[zz].lock >= 200)
-            {
-                daval = 0x7fffffff;
+        if (winlen < newbytes)
+        {
+            if (!end)
                 break;
-            }
-
-            // Potential for eviction increases with
-            //  - smaller item size
-            //  - smaller lock byte value (but in [1 .. 199])
-            daval += mulscale32(cac[zz].leng + 65536, lockrecip[*cac[zz].lock]);
 
-            if (daval >= bestval)
-                break;
+            // end is locked: no window can span it, so restart right after it
+            blk = end;
+            end = end->next;
+            continue;
         }
 
-        if (daval < bestval)
+        if (winval < bestval)
         {
-            bestval = daval;
-            besto   = o1;
-            bestz   = z;
+            bestval = winval;
+            best    = blk;
 
             if (bestval == 0)
                 break;
         }
-    }
 
-    //printf("%d %d %d\n",besto,newbytes,*newlockptr);
+        winlen -= blk->leng;
+        winval -= cacheEvictCost(blk);
+    }
 
-    if (EDUKE32_PREDICT_FALSE(bestval == 0x7fffffff))
-        reportandexit("CACHE SPACE ALL LOCKED UP!");
+    return best;
+}
 
-    //Suck things out
-    int32_t sucklen = -newbytes;
-    int32_t suckz = bestz;
+void cacheAllocateBlock(intptr_t *newhandle, int32_t newbytes, char *newlockptr)
+{
+    if (EDUKE32_PREDICT_FALSE(*newlockptr == 0))
+        reportandexit("ALLOCACHE CALLED WITH LOCK OF 0!");
 
-    for (;sucklen<0; sucklen+=cac[suckz++].leng)
-        if (*cac[suckz].lock)
-            *cac[suckz].hand = 0;
+    // Make all requests a multiple of 16 bytes
+    newbytes = (newbytes + 15) & ~0xf;
 
-    //Remove all blocks except 1
-    suckz -= bestz+1;
-    cacnum -= suckz;
+    if (EDUKE32_PREDICT_FALSE((unsigned)newbytes > (unsigned)cachesize))
+    {
+        initprintf("Cachesize: %d\n",cachesize);
+        initprintf("*Newhandle: 0x%" PRIxPTR ", Newbytes: %d, *Newlock: %d\n",(intptr_t)newhandle,newbytes,*newlockptr);
+        reportandexit("BUFFER TOO BIG TO FIT IN CACHE!");
+    }
 
-    Bmemmove(&cac[bestz], &cac[bestz + suckz], (cacnum - bestz) * sizeof(cactype));
+    cachestats.allocs++;
 
-    cac[bestz].hand = newhandle;
-    *newhandle      = cachestart + besto;
-    cac[bestz].leng = newbytes;
-    cac[bestz].lock = newlockptr;
+    cactype *blk = cacheFindFree(newbytes);
+    int32_t sucklen;
 
-    //Add new empty block if necessary
-    if (sucklen <= 0)
-        return;
-
-    if (++bestz == cacnum)
+    if (blk)
     {
-        inc_and_check_cacnum();
-        cac[bestz].leng = sucklen;
-        cac[bestz].lock = &zerochar;
-        return;
+        cachestats.hits++;
+        cacheUnlinkFree(blk);
+        sucklen = blk->leng - newbytes;
     }
-
-    if (*cac[bestz].lock == 0)
+    else
     {
-        cac[bestz].leng += sucklen;
-        return;
-    }
+        cachestats.misses++;
 
-    inc_and_check_cacnum();
+        if (EDUKE32_PREDICT_FALSE((blk = cacheFindEvictable(newbytes)) == NULL))
+            reportandexit("CACHE SPACE ALL LOCKED UP!");
 
-    for (native_t z=cacnum-1; z>bestz; z--)
-        cac[z] = cac[z-1];
+        //Suck things out
+        sucklen = -newbytes;
+
+        for (cactype *zblk = blk; sucklen < 0; zblk = zblk->next)
+        {
+            sucklen += zblk->leng;
 
-    cac[bestz].leng = sucklen;
-    cac[bestz].lock = &zerochar;
+            if (cacheIsFree(zblk))
+                cacheUnlinkFree(zblk);
+            else if (*zblk->lock)
+            {
+                *zblk->hand = 0;
+                cachestats.evictions++;
+                cachestats.evictedbytes += zblk->leng;
+            }
+        }
+
+        //Remove all blocks except 1
+        while (blk->next && blk->next->ofs < blk->ofs + newbytes + sucklen)
+            cacheRemoveBlock(blk->next);
+    }
+
+    blk->hand = newhandle;
+    *newhandle = cachestart + blk->ofs;
+    blk->leng = newbytes;
+    blk->lock = newlockptr;
+
+    //Add new empty block if necessary
+    cacheInsertFreeAfter(blk, sucklen);
 }
+
 #endif
 
 void cacheAgeEntries(void)
 {
 #ifndef DEBUG_ALLOCACHE_AS_MALLOC
-    static int32_t agecount;
-
-    if (agecount >= cacnum)
-        agecount = cacnum-1;
-
     native_t cnt = (cacnum>>4);
 
-    if (agecount < 0 || !cnt)
+    if (!cnt)
         return;
 
     for (; cnt>=0; cnt--)
     {
+        if (cacagecursor == NULL)
+            cacagecursor = caclast;
+
         // If we have pointer to lock char and it's in [2 .. 199], decrease.
-        if (cac[agecount].lock && (((*cac[agecount].lock)-2)&255) < 198)
-            (*cac[agecount].lock)--;
+        if (cacagecursor->lock && (((*cacagecursor->lock)-2)&255) < 198)
+            (*cacagecursor->lock)--;
+
+        cacagecursor = cacagecursor->prev;
+    }
+#endif
+}
 
-        if (--agecount < 0)
-            agecount = cacnum-1;
+void cacheGetStats(cachestats_t *stats)
+{
+#ifndef DEBUG_ALLOCACHE_AS_MALLOC
+    *stats = cachestats;
+
+    stats->blocks = cacnum;
+    stats->size = cachesize;
+    stats->freebytes = 0;
+    stats->lockedbytes = 0;
+
+    for (cactype const *blk = cacfirst; blk; blk = blk->next)
+    {
+        if (cacheIsFree(blk) || *blk->lock == 0)
+            stats->freebytes += blk->leng;
+        else if (*blk->lock >= 200)
+            stats->lockedbytes += blk->leng;
     }
+#else
+    Bmemset(stats, 0, sizeof(cachestats_t));
 #endif
 }
 
@@ -313,24 +496,24 @@ static void reportandexit(const char *errormessage)
 {
 #ifndef DEBUG_ALLOCACHE_AS_MALLOC
     //setvmode(0x3);
-    int32_t j = 0;
-    for (native_t i = 0; i < cacnum; i++)
+    int32_t i = 0, j = 0;
+    for (cactype const *blk = cacfirst; blk; blk = blk->next, i++)
     {
         buildprint(i, "- ");
 
-        if (cac[i].hand)
-            initprintf("ptr: 0x%" PRIxPTR ", ", *cac[i].hand);
+        if (blk->hand)
+            initprintf("ptr: 0x%" PRIxPTR ", ", *blk->hand);
         else
             initprintf("ptr: NULL, ");
 
-        initprintf("leng: %d, ", cac[i].leng);
+        initprintf("leng: %d, ", blk->leng);
 
-        if (cac[i].lock)
-            initprintf("lock: %d\n", *cac[i].lock);
+        if (blk->lock)
+            initprintf("lock: %d\n", *blk->lock);
         else
             initprintf("lock: NULL\n");
 
-        j += cac[i].leng;
+        j += blk->leng;
     }
 
     initprintf("Cachesize = %d\n", cachesize);
@@ -678,6 +861,22 @@ static char *gfilelist[MAXGROUPFILES];
 static char *groupname[MAXGROUPFILES];
 static int32_t *gfileoffs[MAXGROUPFILES];
 
+// read-only mappings of group files that live directly on the filesystem
+int32_t grpUseMmap = 1;
+static char *groupmap[MAXGROUPFILES];
+static int32_t groupmapsiz[MAXGROUPFILES];
+
+// Case-insensitive index of all GRP/SSI members. Entries are added in mount
+// order with replacement, so a lookup yields the same member the reverse
+// linear scan in kopen_internal() used to find.
+static hashtable_t h_grpfiles = { 4096, NULL };
+
+#define GRPINDEX_PACK(grp, fil) (((intptr_t)(fil) << 3) | (grp))
+#define GRPINDEX_GRP(key) ((int32_t)((key) & 7))
+#define GRPINDEX_FIL(key) ((int32_t)((key) >> 3))
+
+EDUKE32_STATIC_ASSERT(MAXGROUPFILES <= 8);
+
 static uint8_t filegrp[MAXOPENFILES];
 static int32_t filepos[MAXOPENFILES];
 static intptr_t filehan[MAXOPENFILES] =
@@ -703,6 +902,172 @@ static int32_t kread_grp(int32_t handle, void *buffer, int32_t leng);
 static int32_t klseek_grp(int32_t handle, int32_t offset, int32_t whence);
 static void kclose_grp(int32_t handle);
 
+// returns the length of the normalized name, or -1 if it can't be a group member
+static int32_t kgroupindex_key(char *key, const char *filename)
+{
+    int32_t i = 0;
+
+    for (; filename[i]; ++i)
+    {
+        if (i >= 12)
+            return -1;
+
+        key[i] = toupperlookup[(uint8_t)filename[i]];
+    }
+
+    key[i] = 0;
+
+    return i;
+}
+
+static void kgroupindex_add(int32_t grpnum)
+{
+    if (h_grpfiles.items == NULL)
+        hash_init(&h_grpfiles);
+
+    char key[13];
+
+    for (bssize_t i = 0; i < gnumfiles[grpnum]; ++i)
+        if (kgroupindex_key(key, &gfilelist[grpnum][i<<4]) > 0)
+            hash_add(&h_grpfiles, key, GRPINDEX_PACK(grpnum, i), 1);
+}
+
+static void kgroupindex_rebuild(void)
+{
+    hash_free(&h_grpfiles);
+
+    for (bssize_t k = 0; k < numgroupfiles; ++k)
+        if (groupfil[k] != -1)
+            kgroupindex_add(k);
+}
+
+// searches a single group's directory the way kopen_internal() originally did
+static int32_t kgroupfind_linear(const char *filename, int32_t grpnum)
+{
+    for (bssize_t i = gnumfiles[grpnum]-1; i >= 0; --i)
+    {
+        char const * const gfileptr = (char *)&gfilelist[grpnum][i<<4];
+
+        unsigned int j;
+        for (j = 0; j < 13; ++j)
+        {
+            if (!filename[j]) break;
+            if (toupperlookup[filename[j]] != toupperlookup[gfileptr[j]])
+                goto gnumfiles_continue;
+        }
+        if (j<13 && gfileptr[j]) continue;   // JBF: because e1l1.map might exist before e1l1
+        if (j==13 && filename[j]) continue;   // JBF: long file name
+
+        return i;
+
+gnumfiles_continue: ;
+    }
+
+    return -1;
+}
+
+// returns GRPINDEX_PACK(group, member) or -1
+static intptr_t kgroupfind(const char *filename, char searchfirst)
+{
+    if (searchfirst == 1)
+    {
+        // only the first group may be searched, but the index holds the overall winner
+        if (numgroupfiles <= 0 || groupfil[0] < 0)
+            return -1;
+
+        int32_t const i = kgroupfind_linear(filename, 0);
+        return i >= 0 ? GRPINDEX_PACK(0, i) : -1;
+    }
+
+    char key[13];
+
+    if (h_grpfiles.items == NULL || kgroupindex_key(key, filename) <= 0)
+        return -1;
+
+    return hash_find(&h_grpfiles, key);
+}
+
+static void kgroupmap(int32_t grpnum)
+{
+#ifdef CACHE1D_MMAP
+    if (!grpUseMmap || groupfilgrp[grpnum] != GRP_FILESYSTEM)
+        return;
+
+    int32_t const siz = Bfilelength(groupfil[grpnum]);
+
+    if (siz <= 0)
+        return;
+
+# ifdef _WIN32
+    HANDLE const mh = CreateFileMapping((HANDLE)_get_osfhandle(groupfil[grpnum]), NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (mh == NULL)
+        return;
+
+    void *ptr = MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mh);
+
+    if (ptr == NULL)
+        return;
+# else
+    void *ptr = mmap(NULL, siz, PROT_READ, MAP_SHARED, groupfil[grpnum], 0);
+
+    if (ptr == MAP_FAILED)
+        return;
+# endif
+
+    groupmap[grpnum] = (char *)ptr;
+    groupmapsiz[grpnum] = siz;
+#else
+    UNREFERENCED_PARAMETER(grpnum);
+#endif
+}
+
+static void kgroupunmap(int32_t grpnum)
+{
+#ifdef CACHE1D_MMAP
+    if (groupmap[grpnum] == NULL)
+        return;
+
+# ifdef _WIN32
+    UnmapViewOfFile(groupmap[grpnum]);
+# else
+    munmap(groupmap[grpnum], groupmapsiz[grpnum]);
+# endif
+#endif
+    groupmap[grpnum] = NULL;
+    groupmapsiz[grpnum] = 0;
+}
+
+// returns the mapped contents of a group file member, or NULL if it isn't backed by a mapping
+static char const *kgroupmapped(int32_t groupnum, int32_t filenum, int32_t *leng)
+{
+    if (!grpUseMmap || (unsigned)groupnum >= MAXGROUPFILES || groupfil[groupnum] == -1)
+        return NULL;
+
+    int32_t rootgroupnum = groupnum;
+    int32_t i = 0;
+    while (groupfilgrp[rootgroupnum] != GRP_FILESYSTEM)
+    {
+        i += gfileoffs[groupfilgrp[rootgroupnum]][groupfil[rootgroupnum]];
+        rootgroupnum = groupfilgrp[rootgroupnum];
+    }
+
+    if (groupmap[rootgroupnum] == NULL)
+        return NULL;
+
+    i += gfileoffs[groupnum][filenum];
+
+    int32_t const siz = gfileoffs[groupnum][filenum+1] - gfileoffs[groupnum][filenum];
+
+    if (EDUKE32_PREDICT_FALSE(i < 0 || siz < 0 || i + siz > groupmapsiz[rootgroupnum]))
+        return NULL;
+
+    *leng = siz;
+
+    return groupmap[rootgroupnum] + i;
+}
+
 int initgroupfile(const char *filename)
 {
     char buf[70];
@@ -765,6 +1130,8 @@ int initgroupfile(const char *filename)
         }
         gfileoffs[numgroupfiles][gnumfiles[numgroupfiles]] = j;
         groupname[numgroupfiles] = Xstrdup(filename);
+        kgroupindex_add(numgroupfiles);
+        kgroupmap(numgroupfiles);
         return numgroupfiles++;
     }
     klseek_grp(numgroupfiles, 0, BSEEK_SET);
@@ -868,6 +1235,8 @@ int initgroupfile(const char *filename)
         }
         gfileoffs[numgroupfiles][gnumfiles[numgroupfiles]] = j;
         groupname[numgroupfiles] = Xstrdup(filename);
+        kgroupindex_add(numgroupfiles);
+        kgroupmap(numgroupfiles);
         return numgroupfiles++;
     }
 
@@ -886,11 +1255,14 @@ void uninitgroupfile(void)
             DO_FREE_AND_NULL(gfileoffs[i]);
             DO_FREE_AND_NULL(groupname[i]);
 
+            kgroupunmap(i);
             Bclose(groupfil[i]);
             groupfil[i] = -1;
         }
     numgroupfiles = 0;
 
+    hash_free(&h_grpfiles);
+
     // JBF 20040111: "close" any files open in groups
     for (i=0; i<MAXOPENFILES; i++)
     {
@@ -1016,32 +1388,14 @@ static int32_t kopen_internal(const char *filename, char **lastpfn, char searchf
     UNREFERENCED_PARAMETER(tryzip);
 #endif
 
-    for (bssize_t k = searchfirst != 1 ? numgroupfiles-1 : 0; k >= 0; --k)
-    {
-        if (groupfil[k] < 0)
-            continue;
-
-        for (bssize_t i = gnumfiles[k]-1; i >= 0; --i)
-        {
-            char const * const gfileptr = (char *)&gfilelist[k][i<<4];
+    intptr_t const key = kgroupfind(filename, searchfirst);
 
-            unsigned int j;
-            for (j = 0; j < 13; ++j)
-            {
-                if (!filename[j]) break;
-                if (toupperlookup[filename[j]] != toupperlookup[gfileptr[j]])
-                    goto gnumfiles_continue;
-            }
-            if (j<13 && gfileptr[j]) continue;   // JBF: because e1l1.map might exist before e1l1
-            if (j==13 && filename[j]) continue;   // JBF: long file name
-
-            arraygrp[newhandle] = k;
-            arrayhan[newhandle] = i;
-            arraypos[newhandle] = 0;
-            return newhandle;
-
-gnumfiles_continue: ;
-        }
+    if (key >= 0)
+    {
+        arraygrp[newhandle] = GRPINDEX_GRP(key);
+        arrayhan[newhandle] = GRPINDEX_FIL(key);
+        arraypos[newhandle] = 0;
+        return newhandle;
     }
 
     return -1;
@@ -1050,6 +1404,54 @@ gnumfiles_continue: ;
 void krename(int32_t crcval, int32_t filenum, const char *newname)
 {
     Bstrncpy((char *)&gfilelist[crcval][filenum<<4], newname, 12);
+    kgroupindex_rebuild();
+}
+
+void kgroupbench(int32_t grpnum)
+{
+    if ((unsigned)grpnum >= (unsigned)numgroupfiles || groupfil[grpnum] == -1)
+    {
+        OSD_Printf("grpbench: no group file #%d.\n", grpnum);
+        return;
+    }
+
+    int32_t const numfiles = gnumfiles[grpnum];
+    int32_t found[2] = { 0, 0 };
+    double elapsed[2];
+
+    // the linear pass mirrors the old kopen_internal() loop over every mounted group
+    double t = timerGetHiTicks();
+    for (bssize_t i = 0; i < numfiles; ++i)
+        for (bssize_t k = numgroupfiles-1; k >= 0; --k)
+            if (groupfil[k] != -1 && kgroupfind_linear(&gfilelist[grpnum][i<<4], k) >= 0)
+            {
+                found[0]++;
+                break;
+            }
+    elapsed[0] = timerGetHiTicks() - t;
+
+    t = timerGetHiTicks();
+    for (bssize_t i = 0; i < numfiles; ++i)
+        found[1] += (kgroupfind(&gfilelist[grpnum][i<<4], 2) >= 0);
+    elapsed[1] = timerGetHiTicks() - t;
+
+    // full open/close cycle through the public interface
+    int32_t opened = 0;
+    t = timerGetHiTicks();
+    for (bssize_t i = 0; i < numfiles; ++i)
+    {
+        int32_t const fil = kopen4load(&gfilelist[grpnum][i<<4], 2);
+        if (fil < 0)
+            continue;
+        kclose(fil);
+        opened++;
+    }
+    double const openTime = timerGetHiTicks() - t;
+
+    OSD_Printf("grpbench: %s: %d files\n", groupname[grpnum], numfiles);
+    OSD_Printf("  linear scan: %d found in %.3f ms\n", found[0], elapsed[0]);
+    OSD_Printf("  hash index:  %d found in %.3f ms\n", found[1], elapsed[1]);
+    OSD_Printf("  kopen4load:  %d opened in %.3f ms\n", opened, openTime);
 }
 
 char const * kfileparent(int32_t const handle)
@@ -1062,6 +1464,11 @@ char const * kfileparent(int32_t const handle)
     return groupname[groupnum];
 }
 
+char const * kfilemapping(int32_t const handle, int32_t *leng)
+{
+    return kgroupmapped(filegrp[handle], filehan[handle], leng);
+}
+
 int32_t kopen4load(const char *filename, char searchfirst)
 {
     int32_t newhandle = MAXOPENFILES-1;
@@ -1111,6 +1518,21 @@ int32_t kread_internal(int32_t handle, void *buffer, int32_t leng, const uint8_t
     if (EDUKE32_PREDICT_FALSE(groupfil[groupnum] == -1))
         return 0;
 
+    int32_t siz;
+    char const * const mapped = kgroupmapped(groupnum, filenum, &siz);
+
+    if (mapped)
+    {
+        leng = min(leng, siz-arraypos[handle]);
+
+        if (leng <= 0)
+            return 0;
+
+        Bmemcpy(buffer, mapped+arraypos[handle], leng);
+        arraypos[handle] += leng;
+        return leng;
+    }
+
     int32_t rootgroupnum = groupnum;
     int32_t i = 0;
     while (groupfilgrp[rootgroupnum] != GRP_FILESYSTEM)
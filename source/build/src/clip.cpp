@@ -1105,6 +1105,9 @@ int32_t clipmove(vec3_t *pos, int16_t *sectnum,
 
             case CSTAT_SPRITE_ALIGNMENT_WALL:
             {
+                if (klabs(x1-cx) > spriteclipextent(spr)+rad || klabs(y1-cy) > spriteclipextent(spr)+rad)
+                    break;
+
                 const int32_t daz = spr->z + spriteheightofs(j, &k, 1);
 
                 if (pos->z > daz-k-flordist && pos->z < daz+ceildist)
@@ -1138,6 +1141,9 @@ int32_t clipmove(vec3_t *pos, int16_t *sectnum,
 
             case CSTAT_SPRITE_ALIGNMENT_FLOOR:
             {
+                if (klabs(x1-cx) > spriteclipextent(spr)+rad || klabs(y1-cy) > spriteclipextent(spr)+rad)
+                    break;
+
                 if (pos->z > spr->z - flordist && pos->z < spr->z + ceildist)
                 {
                     if ((cstat&64) != 0)
@@ -623,6 +623,43 @@ uint32_t Bgetsysmemsize(void)
 #endif
 }
 
+//
+// Bcpuhasavx2() -- whether both the CPU and the OS support AVX2
+//
+#if defined _MSC_VER && _MSC_VER >= 1700 && (defined _M_X64 || defined _M_IX86)
+# include <intrin.h>
+#endif
+
+int32_t Bcpuhasavx2(void)
+{
+#if defined _MSC_VER && _MSC_VER >= 1700 && (defined _M_X64 || defined _M_IX86)
+    int regs[4];
+
+    __cpuid(regs, 0);
+
+    if (regs[0] < 7)
+        return 0;
+
+    int const osxsave_avx = (1<<27)|(1<<28);
+
+    __cpuid(regs, 1);
+
+    // the OS has to save the YMM registers on context switches
+    if ((regs[2] & osxsave_avx) != osxsave_avx || (_xgetbv(0) & 6) != 6)
+        return 0;
+
+    __cpuidex(regs, 7, 0);
+
+    return !!(regs[1] & (1<<5));
+#elif (EDUKE32_GCC_PREREQ(4,9) || defined __clang__) && (defined __x86_64__ || defined __i386__)
+    __builtin_cpu_init();
+
+    return !!__builtin_cpu_supports("avx2");
+#else
+    return 0;
+#endif
+}
+
 #ifdef GEKKO
 int access(const char *pathname, int mode)
 {
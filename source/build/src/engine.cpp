@@ -23,6 +23,9 @@
 #include "pragmas.h"
 #include "scriptfile.h"
 #include "softsurface.h"
+#include "threadpool.h"
+#include "pvs.h"
+#include "sectgrid.h"
 
 #ifdef USE_OPENGL
 # include "glad/glad.h"
@@ -133,6 +136,12 @@ static int32_t oxdimen = -1, oviewingrange = -1, oxyaspect = -1;
 int32_t r_usenewaspect = 1, newaspect_enable=0;
 uint32_t r_screenxy = 0;
 
+// number of worker threads splitting softsurface_blitBuffer()
+int32_t r_blitthreads = 0;
+
+// prune the portal walk with potentially visible sector sets, see pvs.cpp
+int32_t r_pvs = 0;
+
 int32_t globalflags;
 
 float g_videoGamma = DEFAULT_GAMMA;
@@ -1630,7 +1639,7 @@ static inline int findUnusedTile(void)
 //
 static void classicScanSector(int16_t startsectnum)
 {
-    if (startsectnum < 0)
+    if (startsectnum < 0 || !pvs_maysee(startsectnum))
         return;
 
     sectorborder[0] = startsectnum;
@@ -1689,7 +1698,7 @@ static void classicScanSector(int16_t startsectnum)
 #ifdef YAX_ENABLE
                 if (yax_nomaskpass==0 || !yax_isislandwall(w, !yax_globalcf) || (yax_nomaskdidit=1, 0))
 #endif
-                if ((gotsector[nextsectnum>>3]&pow2char[nextsectnum&7]) == 0)
+                if ((gotsector[nextsectnum>>3]&pow2char[nextsectnum&7]) == 0 && pvs_maysee(nextsectnum))
                 {
                     // OV: E2L10
                     coord_t temp = (coord_t)x1*y2-(coord_t)x2*y1;
@@ -7761,6 +7770,10 @@ int32_t enginePostInit(void)
 //
 void engineUnInit(void)
 {
+    threadpool_uninit();
+    pvs_uninit();
+    sectgrid_uninit();
+
 #ifdef USE_OPENGL
     polymost_glreset();
     hicinit();
@@ -8040,6 +8053,9 @@ int32_t renderDrawRoomsQ16(int32_t daposx, int32_t daposy, int32_t daposz,
             return 0;
     }
 
+    // Mirrored views start outside of their sector, so can't be pruned.
+    pvs_beginframe((dacursectnum >= MAXSECTORS || inpreparemirror) ? -1 : globalcursectnum, globalposx, globalposy);
+
 #ifdef USE_OPENGL
     //============================================================================= //POLYMOST BEGINS
     polymost_drawrooms();
@@ -8975,6 +8991,8 @@ static void enginePrepareLoadBoard(int32_t fil, vec3_t *dapos, int16_t *daang, i
     Bmemset(wallchanged, 0, sizeof(wallchanged));
 #endif
 
+    sectgrid_invalidate();
+
 #ifdef USE_OPENGL
     Polymost_prepare_loadboard();
 #endif
@@ -11176,6 +11194,7 @@ void dragpoint(int16_t pointhighlight, int32_t dax, int32_t day, uint8_t flags)
 
             wall[w].x = dax;
             wall[w].y = day;
+            sectgrid_movedwall(w);
             walbitmap[w>>3] |= (1<<(w&7));
 
             for (YAX_ITER_WALLS(w, j, tmpcf))
@@ -11250,6 +11269,7 @@ void dragpoint(int16_t pointhighlight, int32_t dax, int32_t day, uint8_t flags)
 
     wall[tempshort].x = dax;
     wall[tempshort].y = day;
+    sectgrid_movedwall(tempshort);
 
     if (editstatus)
     {
@@ -11268,6 +11288,7 @@ void dragpoint(int16_t pointhighlight, int32_t dax, int32_t day, uint8_t flags)
             wall[tempshort].x = dax;
             wall[tempshort].y = day;
             wall[tempshort].cstat |= (1<<14);
+            sectgrid_movedwall(tempshort);
         }
         else
         {
@@ -11281,6 +11302,7 @@ void dragpoint(int16_t pointhighlight, int32_t dax, int32_t day, uint8_t flags)
                     wall[tempshort].x = dax;
                     wall[tempshort].y = day;
                     wall[tempshort].cstat |= (1<<14);
+                    sectgrid_movedwall(tempshort);
                 }
                 else
                 {
@@ -11399,7 +11421,10 @@ void updatesector(int32_t x, int32_t y, int16_t *sectnum)
         while (--wallsleft);
     }
 
-    for (bssize_t i=numsectors-1; i>=0; --i)
+    sectgrid_iter_t it;
+    sectgrid_begin(x, y, &it);
+
+    for (int i; (i = sectgrid_next(&it)) >= 0;)
         if (inside_p(x, y, i))
             SET_AND_RETURN(*sectnum, i);
 
@@ -11456,7 +11481,10 @@ void updatesectorexclude(int32_t x, int32_t y, int16_t *sectnum, const uint8_t *
         while (--wallsleft);
     }
 
-    for (bssize_t i=numsectors-1; i>=0; --i)
+    sectgrid_iter_t it;
+    sectgrid_begin(x, y, &it);
+
+    for (int i; (i = sectgrid_next(&it)) >= 0;)
         if (inside_exclude_p(x, y, i, excludesectbitmap))
             SET_AND_RETURN(*sectnum, i);
 
@@ -11515,7 +11543,10 @@ void updatesectorz(int32_t x, int32_t y, int32_t z, int16_t *sectnum)
         while (--wallsleft);
     }
 
-    for (bssize_t i=numsectors-1; i>=0; --i)
+    sectgrid_iter_t it;
+    sectgrid_begin(x, y, &it);
+
+    for (int i; (i = sectgrid_next(&it)) >= 0;)
         if (inside_z_p(x,y,z, i))
             SET_AND_RETURN(*sectnum, i);
 
@@ -11875,6 +11906,10 @@ restart_grand:
 
                     case CSTAT_SPRITE_ALIGNMENT_WALL:
                     {
+                        int32_t const k = spriteclipextent((uspritetype *)&sprite[j]) + walldist+1;
+                        if ((klabs(v1.x-pos->x) > k) || (klabs(v1.y-pos->y) > k))
+                            break;
+
                         vec2_t v2;
                         get_wallspr_points((uspritetype *)&sprite[j], &v1.x, &v2.x, &v1.y, &v2.y);
 
@@ -11890,6 +11925,10 @@ restart_grand:
 
                     case CSTAT_SPRITE_ALIGNMENT_FLOOR:
                     {
+                        int32_t const k = spriteclipextent((uspritetype *)&sprite[j]) + walldist+4;
+                        if ((klabs(v1.x-pos->x) > k) || (klabs(v1.y-pos->y) > k))
+                            break;
+
                         daz = sprite[j].z; daz2 = daz;
 
                         if ((cstat&64) != 0 && (pos->z > daz) == ((cstat&8)==0))
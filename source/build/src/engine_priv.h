@@ -261,6 +261,26 @@ extern void get_floorspr_points(uspritetype const * spr, int32_t px, int32_t py,
     int32_t *x1, int32_t *x2, int32_t *x3, int32_t *x4,
     int32_t *y1, int32_t *y2, int32_t *y3, int32_t *y4);
 
+// How far from (spr->x, spr->y) the points get_wallspr_points() or
+// get_floorspr_points() return for spr can lie at most. Collision code checks
+// this first so that wall and floor sprites out of reach cost no more than
+// face sprites.
+static FORCE_INLINE int32_t spriteclipextent(uspritetype const * const spr)
+{
+    int32_t const tilenum = spr->picnum;
+    int32_t const xspan = tilesiz[tilenum].x;
+    int32_t extent = (xspan + (xspan>>1) + klabs(picanm[tilenum].xofs + spr->xoffset)) * spr->xrepeat;
+
+    if ((spr->cstat & CSTAT_SPRITE_ALIGNMENT_MASK) == CSTAT_SPRITE_ALIGNMENT_FLOOR)
+    {
+        int32_t const yspan = tilesiz[tilenum].y;
+        extent += (yspan + (yspan>>1) + klabs(picanm[tilenum].yofs + spr->yoffset)) * spr->yrepeat;
+    }
+
+    // sintable[] peaks at 1<<14, and each mulscale16() there may round down once
+    return (extent>>2) + 4;
+}
+
 
 // int32_t wallmost(int16_t *mostbuf, int32_t w, int32_t sectnum, char dastat);
 int32_t wallfront(int32_t l1, int32_t l2);
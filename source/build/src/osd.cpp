@@ -265,6 +265,30 @@ static int osdfunc_echo(osdcmdptr_t parm)
     return OSDCMD_OK;
 }
 
+static int osdfunc_grpbench(osdcmdptr_t parm)
+{
+    if (parm->numparms > 1) return OSDCMD_SHOWHELP;
+
+    kgroupbench(parm->numparms ? Batol(parm->parms[0]) : 0);
+
+    return OSDCMD_OK;
+}
+
+static int osdfunc_cachestats(osdcmdptr_t UNUSED(parm))
+{
+    UNREFERENCED_CONST_PARAMETER(parm);
+
+    cachestats_t stats;
+    cacheGetStats(&stats);
+
+    OSD_Printf("Cache: %d blocks, %.1fK free, %.1fK locked of %.1fK\n", stats.blocks,
+               stats.freebytes/1024.f, stats.lockedbytes/1024.f, stats.size/1024.f);
+    OSD_Printf("  %u allocations: %u from free lists, %u needing eviction\n", stats.allocs, stats.hits, stats.misses);
+    OSD_Printf("  %u blocks evicted (%.1fK)\n", stats.evictions, stats.evictedbytes/1024.f);
+
+    return OSDCMD_OK;
+}
+
 static int osdfunc_fileinfo(osdcmdptr_t parm)
 {
     if (parm->numparms != 1) return OSDCMD_SHOWHELP;
@@ -736,10 +760,12 @@ void OSD_Init(void)
         OSD_RegisterCvar(&i, (i.flags & CVAR_FUNCPTR) ? osdcmd_cvar_set_osd : osdcmd_cvar_set);
 
     OSD_RegisterFunction("alias", "alias: creates an alias for calling multiple commands", osdfunc_alias);
+    OSD_RegisterFunction("cachestats", "cachestats: shows allocation and eviction counters for the cache", osdfunc_cachestats);
     OSD_RegisterFunction("clear", "clear: clears the console text buffer", osdfunc_clear);
     OSD_RegisterFunction("echo", "echo [text]: echoes text to the console", osdfunc_echo);
     OSD_RegisterFunction("exec", "exec <scriptfile>: executes a script", osdfunc_exec);
     OSD_RegisterFunction("fileinfo", "fileinfo <file>: gets a file's information", osdfunc_fileinfo);
+    OSD_RegisterFunction("grpbench", "grpbench [group]: times looking up and opening every file in a group file", osdfunc_grpbench);
     OSD_RegisterFunction("help", "help: displays help for a cvar or command; \"listsymbols\" to show all commands", osdfunc_help);
     OSD_RegisterFunction("history", "history: displays the console command history", osdfunc_history);
     OSD_RegisterFunction("listsymbols", "listsymbols: lists all registered functions, cvars and aliases", osdfunc_listsymbols);
@@ -19,6 +19,7 @@ Ken Silverman's official web site: http://www.advsys.net/ken
 #include "hightile.h"
 #include "polymost.h"
 #include "polymer.h"
+#include "pvs.h"
 #include "cache1d.h"
 #include "kplib.h"
 #include "texcache.h"
@@ -5146,7 +5147,7 @@ static int32_t polymost_bunchfront(const int32_t b1, const int32_t b2)
 
 void polymost_scansector(int32_t sectnum)
 {
-    if (sectnum < 0) return;
+    if (sectnum < 0 || !pvs_maysee(sectnum)) return;
 
     sectorborder[0] = sectnum;
     int sectorbordercnt = 1;
@@ -5200,7 +5201,7 @@ void polymost_scansector(int32_t sectnum)
 #ifdef YAX_ENABLE
             if (yax_nomaskpass==0 || !yax_isislandwall(z, !yax_globalcf) || (yax_nomaskdidit=1, 0))
 #endif
-            if ((gotsector[nextsectnum>>3]&pow2char[nextsectnum&7]) == 0)
+            if ((gotsector[nextsectnum>>3]&pow2char[nextsectnum&7]) == 0 && pvs_maysee(nextsectnum))
             {
                 float const d = fp1.x*fp2.y - fp2.x*fp1.y;
                 p1.x = fp2.x-fp1.x;
@@ -0,0 +1,284 @@
+// Potentially visible sector sets (PVS)
+//
+// For a sector A, the set of sectors that a 2D line of sight leaving A can
+// reach through a chain of red-wall portals. Heights are ignored, so a row is
+// a superset of what can be seen from anywhere inside A, and pruning the
+// portal walk in classicScanSector()/polymost_scansector() with it never
+// drops a sector that would have been drawn.
+//
+// Rows are built on demand, the first time a view starts in a sector. Sight
+// is flowed from portal to portal much like Quake's vis: from the third
+// portal on, each one is clipped to the wedge of lines that pass through both
+// the source portal (where the line left A) and the last portal passed, and a
+// path ends once nothing of a portal remains. Portals with vertices that have
+// moved since the map was loaded (SE-driven doors, rotating and sliding
+// sectors) don't constrain anything, and any such movement drops all rows.
+
+#include "build.h"
+#include "baselayer.h"
+#include "engine_priv.h"
+#include "pvs.h"
+
+uint8_t const *pvs_row;
+
+#define PVS_MAXDEPTH 256
+// Rough budget of walls visited while building one row. Rows that exceed it
+// see everything, which is always safe.
+#define PVS_MAXWORK (1<<18)
+
+typedef struct { double x1, y1, x2, y2; } pvsseg_t;
+
+static uint8_t *pvs_bits;      // pvs_numsectors rows of pvs_rowbytes each
+static uint8_t *pvs_rowbuilt;  // per sector
+static vec2_t *pvs_wallpos;    // wall geometry the rows were built from
+static int16_t *pvs_wallnext, *pvs_wallpoint2;
+static int32_t pvs_numsectors = -1, pvs_numwalls = -1, pvs_rowbytes;
+static int32_t pvs_work;
+
+static uint8_t pvs_movedvertex[(MAXWALLS+7)>>3];
+static uint8_t pvs_onpath[(MAXSECTORS+7)>>3];
+
+void pvs_uninit(void)
+{
+    DO_FREE_AND_NULL(pvs_bits);
+    DO_FREE_AND_NULL(pvs_rowbuilt);
+    DO_FREE_AND_NULL(pvs_wallpos);
+    DO_FREE_AND_NULL(pvs_wallnext);
+    DO_FREE_AND_NULL(pvs_wallpoint2);
+
+    pvs_numsectors = pvs_numwalls = -1;
+    pvs_row = NULL;
+}
+
+static void pvs_reset(void)
+{
+    pvs_uninit();
+
+    pvs_numsectors = numsectors;
+    pvs_numwalls = numwalls;
+    pvs_rowbytes = (numsectors+7)>>3;
+
+    pvs_bits = (uint8_t *)Xmalloc(numsectors * pvs_rowbytes);
+    pvs_rowbuilt = (uint8_t *)Xcalloc(numsectors, 1);
+    pvs_wallpos = (vec2_t *)Xmalloc(numwalls * sizeof(vec2_t));
+    pvs_wallnext = (int16_t *)Xmalloc(numwalls * sizeof(int16_t));
+    pvs_wallpoint2 = (int16_t *)Xmalloc(numwalls * sizeof(int16_t));
+
+    for (bssize_t i=0; i<numwalls; i++)
+    {
+        pvs_wallpos[i].x = wall[i].x;
+        pvs_wallpos[i].y = wall[i].y;
+        pvs_wallnext[i] = wall[i].nextsector;
+        pvs_wallpoint2[i] = wall[i].point2;
+    }
+
+    Bmemset(pvs_movedvertex, 0, sizeof(pvs_movedvertex));
+}
+
+// Compares the map against what the rows were built from. Anything may write
+// to wall[] (dragpoint(), CON, savegame restore), so this is checked per view.
+static void pvs_validate(void)
+{
+    if (numsectors != pvs_numsectors || numwalls != pvs_numwalls)
+    {
+        pvs_reset();
+        return;
+    }
+
+    int32_t moved = 0;
+
+    for (bssize_t i=0; i<numwalls; i++)
+    {
+        if (wall[i].nextsector != pvs_wallnext[i] || wall[i].point2 != pvs_wallpoint2[i])
+        {
+            pvs_reset();
+            return;
+        }
+
+        if (wall[i].x != pvs_wallpos[i].x || wall[i].y != pvs_wallpos[i].y)
+        {
+            pvs_wallpos[i].x = wall[i].x;
+            pvs_wallpos[i].y = wall[i].y;
+
+            if ((pvs_movedvertex[i>>3] & pow2char[i&7]) == 0)
+            {
+                pvs_movedvertex[i>>3] |= pow2char[i&7];
+                moved = 1;
+            }
+        }
+    }
+
+    if (moved)
+        Bmemset(pvs_rowbuilt, 0, pvs_numsectors);
+}
+
+static FORCE_INLINE int32_t pvs_wallmoves(int32_t w)
+{
+    int32_t const w2 = wall[w].point2;
+    return (pvs_movedvertex[w>>3] & pow2char[w&7]) || (pvs_movedvertex[w2>>3] & pow2char[w2&7]);
+}
+
+static FORCE_INLINE void pvs_getseg(int32_t w, pvsseg_t *s)
+{
+    s->x1 = wall[w].x;
+    s->y1 = wall[w].y;
+    s->x2 = wall[wall[w].point2].x;
+    s->y2 = wall[wall[w].point2].y;
+}
+
+// Clips n to what lines of sight through src and then pass can reach.
+// Returns 0 if nothing remains.
+static int32_t pvs_clipwedge(pvsseg_t const *src, pvsseg_t const *pass, pvsseg_t *n)
+{
+    double const sx[2] = { src->x1, src->x2 }, sy[2] = { src->y1, src->y2 };
+    double const px[2] = { pass->x1, pass->x2 }, py[2] = { pass->y1, pass->y2 };
+
+    for (bssize_t i=0; i<2; i++)
+        for (bssize_t j=0; j<2; j++)
+        {
+            double const dx = px[j]-sx[i], dy = py[j]-sy[i];
+            double const len = sqrt(dx*dx + dy*dy);
+
+            // Sides of the line through src[i] and pass[j], scaled by len.
+            // Half a unit of slack everywhere keeps rounding on the safe side.
+            double const slack = len*0.5;
+            double const so = dx*(sy[i^1]-sy[i]) - dy*(sx[i^1]-sx[i]);
+            double const po = dx*(py[j^1]-sy[i]) - dy*(px[j^1]-sx[i]);
+
+            if (len < 1.0 || fabs(so) <= slack)
+                continue;
+
+            double const sgn = so > 0 ? 1.0 : -1.0;
+
+            // Only a separator (the rest of src and of pass on opposite sides)
+            // bounds the lines through both; past pass they stay on its far side.
+            if (sgn*po > -slack)
+                continue;
+
+            double const d1 = sgn*(dx*(n->y1-sy[i]) - dy*(n->x1-sx[i])) - slack;
+            double const d2 = sgn*(dx*(n->y2-sy[i]) - dy*(n->x2-sx[i])) - slack;
+
+            if (d1 > 0 && d2 > 0)
+                return 0;
+
+            if (d1 > 0)
+            {
+                double const t = d1/(d1-d2);
+                n->x1 += (n->x2-n->x1)*t;
+                n->y1 += (n->y2-n->y1)*t;
+            }
+            else if (d2 > 0)
+            {
+                double const t = d2/(d2-d1);
+                n->x2 += (n->x1-n->x2)*t;
+                n->y2 += (n->y1-n->y2)*t;
+            }
+        }
+
+    return 1;
+}
+
+// src is the portal the line left the row's sector through and pass the last
+// one it went through; either is NULL when unknown (moving, or not yet seen).
+static void pvs_flow(uint8_t *row, int32_t sectnum, int32_t entrywall,
+                     pvsseg_t const *src, pvsseg_t const *pass, int32_t depth)
+{
+    if (depth >= PVS_MAXDEPTH)
+        pvs_work = -1;
+
+    if (pvs_work < 0)
+        return;
+
+    pvs_onpath[sectnum>>3] |= pow2char[sectnum&7];
+
+    int32_t const startwall = sector[sectnum].wallptr;
+    int32_t const endwall = startwall + sector[sectnum].wallnum;
+
+    for (bssize_t w=startwall; w<endwall && --pvs_work >= 0; w++)
+    {
+        int32_t const nextsectnum = wall[w].nextsector;
+
+        // A line that came in through entrywall can't leave through it, and
+        // one that comes back to a sector on its path is no more constrained
+        // than the shorter path that skips the loop.
+        if (nextsectnum < 0 || w == entrywall || (pvs_onpath[nextsectnum>>3] & pow2char[nextsectnum&7]))
+            continue;
+
+        int32_t const moves = pvs_wallmoves(w);
+        pvsseg_t n;
+
+        pvs_getseg(w, &n);
+
+        if (!moves && src && pass && !pvs_clipwedge(src, pass, &n))
+            continue;
+
+        row[nextsectnum>>3] |= pow2char[nextsectnum&7];
+
+        // Dropping a portal from the chain only ever lets more lines through.
+        if (src)
+            pvs_flow(row, nextsectnum, wall[w].nextwall, src, moves ? NULL : &n, depth+1);
+        else
+            pvs_flow(row, nextsectnum, wall[w].nextwall, moves ? NULL : &n, NULL, depth+1);
+    }
+
+    pvs_onpath[sectnum>>3] &= ~pow2char[sectnum&7];
+}
+
+static void pvs_buildrow(int32_t sectnum)
+{
+    uint8_t *const row = &pvs_bits[sectnum * pvs_rowbytes];
+
+    Bmemset(row, 0, pvs_rowbytes);
+    row[sectnum>>3] |= pow2char[sectnum&7];
+
+    pvs_work = PVS_MAXWORK;
+    pvs_onpath[sectnum>>3] |= pow2char[sectnum&7];
+
+    int32_t const startwall = sector[sectnum].wallptr;
+    int32_t const endwall = startwall + sector[sectnum].wallnum;
+
+    for (bssize_t w=startwall; w<endwall && pvs_work >= 0; w++)
+    {
+        int32_t const nextsectnum = wall[w].nextsector;
+
+        if (nextsectnum < 0 || nextsectnum == sectnum)
+            continue;
+
+        pvsseg_t s;
+        pvs_getseg(w, &s);
+
+        row[nextsectnum>>3] |= pow2char[nextsectnum&7];
+        pvs_flow(row, nextsectnum, wall[w].nextwall, pvs_wallmoves(w) ? NULL : &s, NULL, 1);
+    }
+
+    pvs_onpath[sectnum>>3] &= ~pow2char[sectnum&7];
+
+    if (pvs_work < 0)
+        Bmemset(row, 0xff, pvs_rowbytes);
+
+    pvs_rowbuilt[sectnum] = 1;
+}
+
+void pvs_beginframe(int32_t sectnum, int32_t x, int32_t y)
+{
+    pvs_row = NULL;
+
+    if (!r_pvs || editstatus || (unsigned)sectnum >= (unsigned)numsectors)
+        return;
+#ifdef YAX_ENABLE
+    // TROR levels are reached through ceilings and floors, not portals
+    if (numyaxbunches > 0)
+        return;
+#endif
+
+    pvs_validate();
+
+    // Rows hold for viewpoints inside their sector only.
+    if (inside(x, y, sectnum) != 1)
+        return;
+
+    if (!pvs_rowbuilt[sectnum])
+        pvs_buildrow(sectnum);
+
+    pvs_row = &pvs_bits[sectnum * pvs_rowbytes];
+}
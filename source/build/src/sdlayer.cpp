@@ -591,6 +591,16 @@ int32_t initsystem(void)
         return -1;
 
     int32_t err = 0;
+
+    if (headlessvideo)
+    {
+        // Nothing is ever presented, so let SDL hand us an in-memory window
+        // surface instead of requiring a display server.
+        if (SDL_WasInit(SDL_INIT_VIDEO))
+            SDL_QuitSubSystem(SDL_INIT_VIDEO);
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    }
+
     uint32_t inited = SDL_WasInit(sdlinitflags);
     if (inited == 0)
         err = SDL_Init(sdlinitflags);
@@ -615,16 +625,21 @@ int32_t initsystem(void)
     frameplace = 0;
     lockcount = 0;
 
+#ifdef USE_OPENGL
+    if (headlessvideo)
+        nogl = 1;
+#endif
+
     if (!novideo)
     {
 #ifdef USE_OPENGL
-        if (SDL_GL_LoadLibrary(0))
+        if (!nogl && SDL_GL_LoadLibrary(0))
         {
             initprintf("Failed loading OpenGL Driver.  GL modes will be unavailable. Error: %s\n", SDL_GetError());
             nogl = 1;
         }
 #ifdef POLYMER
-        if (loadglulibrary(getenv("BUILD_GLULIB")))
+        if (!nogl && loadglulibrary(getenv("BUILD_GLULIB")))
         {
             initprintf("Failed loading GLU.  GL modes will be unavailable. Error: %s\n", SDL_GetError());
             nogl = 1;
@@ -1772,6 +1787,8 @@ void videoShowFrame(int32_t w)
         while (lockcount) videoEndDrawing();
     }
 
+    if (headlessvideo) return;
+
     if (SDL_MUSTLOCK(sdl_surface)) SDL_LockSurface(sdl_surface);
     softsurface_blitBuffer((uint32_t*) sdl_surface->pixels, sdl_surface->format->BitsPerPixel);
     if (SDL_MUSTLOCK(sdl_surface)) SDL_UnlockSurface(sdl_surface);
@@ -0,0 +1,314 @@
+// Sector grid
+//
+// updatesector() and friends fall back to trying every sector with inside()
+// when the walk over the neighbours of the last known sector fails, which on
+// large maps is the bulk of their cost. The grid splits the map's bounding box
+// into square cells of a power-of-two size and lists, per cell, the sectors
+// whose bounding box overlaps it, so that only those need to be tried.
+//
+// Each sector remembers the range of cells it was registered in. When one of
+// its vertices is moved outside that range, it goes on a short list of moved
+// sectors that every lookup considers. The grid is rebuilt from scratch when
+// that list fills up, when the number of sectors or walls changes, or when it
+// was invalidated.
+
+#include "build.h"
+#include "baselayer.h"
+#include "engine_priv.h"
+#include "osd.h"
+#include "sectgrid.h"
+
+// Smallest cell size is 1<<SECTGRID_MINSHIFT units
+#define SECTGRID_MINSHIFT 8
+#define SECTGRID_MAXMOVED 256
+
+typedef struct { int32_t x1, y1, x2, y2; } sgrange_t;
+
+static int32_t *sectgrid_cellstart;  // sectgrid_cols*sectgrid_rows+1 offsets into sectgrid_sects
+static int16_t *sectgrid_sects;      // per cell, in descending order
+static sgrange_t *sectgrid_range;    // cells each sector was registered in
+static int32_t sectgrid_numsectors = -1, sectgrid_numwalls = -1;
+static int32_t sectgrid_minx, sectgrid_miny, sectgrid_shift, sectgrid_cols, sectgrid_rows;
+
+static int16_t sectgrid_moved[SECTGRID_MAXMOVED];  // descending
+static int32_t sectgrid_nummoved;
+static uint8_t sectgrid_ismoved[(MAXSECTORS+7)>>3];
+
+void sectgrid_uninit(void)
+{
+    DO_FREE_AND_NULL(sectgrid_cellstart);
+    DO_FREE_AND_NULL(sectgrid_sects);
+    DO_FREE_AND_NULL(sectgrid_range);
+
+    sectgrid_numsectors = sectgrid_numwalls = -1;
+}
+
+void sectgrid_invalidate(void)
+{
+    sectgrid_numsectors = -1;
+}
+
+static FORCE_INLINE int32_t sectgrid_cellx(int32_t x) { return (int32_t)(((int64_t)x - sectgrid_minx) >> sectgrid_shift); }
+static FORCE_INLINE int32_t sectgrid_celly(int32_t y) { return (int32_t)(((int64_t)y - sectgrid_miny) >> sectgrid_shift); }
+
+static void sectgrid_build(void)
+{
+    sectgrid_uninit();
+
+    sectgrid_numsectors = numsectors;
+    sectgrid_numwalls = numwalls;
+    sectgrid_nummoved = 0;
+    sectgrid_cols = sectgrid_rows = 0;
+    Bmemset(sectgrid_ismoved, 0, sizeof(sectgrid_ismoved));
+
+    if (numsectors <= 0)
+        return;
+
+    sectgrid_range = (sgrange_t *)Xmalloc(numsectors * sizeof(sgrange_t));
+
+    int32_t minx = INT32_MAX, miny = INT32_MAX, maxx = INT32_MIN, maxy = INT32_MIN;
+
+    for (bssize_t i=0; i<numsectors; i++)
+    {
+        sgrange_t *const r = &sectgrid_range[i];
+        int32_t const startwall = sector[i].wallptr, endwall = startwall + sector[i].wallnum;
+
+        r->x1 = r->y1 = INT32_MAX;
+        r->x2 = r->y2 = INT32_MIN;
+
+        for (bssize_t w=startwall; w<endwall; w++)
+        {
+            int32_t const x = wall[w].x, y = wall[w].y;
+
+            r->x1 = min(r->x1, x);
+            r->y1 = min(r->y1, y);
+            r->x2 = max(r->x2, x);
+            r->y2 = max(r->y2, y);
+        }
+
+        if (r->x1 > r->x2)
+            continue;
+
+        // inside() also accepts points one unit down and to the left of the
+        // polygon proper
+        r->x1 = max(r->x1, INT32_MIN+1)-1;
+        r->y1 = max(r->y1, INT32_MIN+1)-1;
+
+        minx = min(minx, r->x1);
+        miny = min(miny, r->y1);
+        maxx = max(maxx, r->x2);
+        maxy = max(maxy, r->y2);
+    }
+
+    if (minx > maxx)
+        return;
+
+    // Aim for about two cells per sector.
+    int64_t const width = (int64_t)maxx - minx + 1, height = (int64_t)maxy - miny + 1;
+    int64_t const maxcells = max<int32_t>(numsectors, 16) * 2;
+
+    sectgrid_shift = SECTGRID_MINSHIFT;
+
+    while (((width >> sectgrid_shift) + 1) * ((height >> sectgrid_shift) + 1) > maxcells)
+        sectgrid_shift++;
+
+    sectgrid_minx = minx;
+    sectgrid_miny = miny;
+    sectgrid_cols = (int32_t)(width >> sectgrid_shift) + 1;
+    sectgrid_rows = (int32_t)(height >> sectgrid_shift) + 1;
+
+    int32_t const numcells = sectgrid_cols * sectgrid_rows;
+
+    sectgrid_cellstart = (int32_t *)Xcalloc(numcells + 1, sizeof(int32_t));
+
+    for (bssize_t i=0; i<numsectors; i++)
+    {
+        sgrange_t *const r = &sectgrid_range[i];
+
+        if (r->x1 > r->x2)
+        {
+            // No walls: registered nowhere, and any move puts it on the moved list.
+            r->x1 = r->y1 = 0;
+            r->x2 = r->y2 = -1;
+            continue;
+        }
+
+        r->x1 = sectgrid_cellx(r->x1);
+        r->y1 = sectgrid_celly(r->y1);
+        r->x2 = sectgrid_cellx(r->x2);
+        r->y2 = sectgrid_celly(r->y2);
+
+        for (bssize_t cy=r->y1; cy<=r->y2; cy++)
+            for (bssize_t cx=r->x1; cx<=r->x2; cx++)
+                sectgrid_cellstart[cy*sectgrid_cols + cx + 1]++;
+    }
+
+    for (bssize_t c=0; c<numcells; c++)
+        sectgrid_cellstart[c+1] += sectgrid_cellstart[c];
+
+    sectgrid_sects = (int16_t *)Xmalloc(max(sectgrid_cellstart[numcells], 1) * sizeof(int16_t));
+
+    int32_t *const fill = (int32_t *)Xmalloc(numcells * sizeof(int32_t));
+    Bmemcpy(fill, sectgrid_cellstart, numcells * sizeof(int32_t));
+
+    for (bssize_t i=numsectors-1; i>=0; i--)
+    {
+        sgrange_t const *const r = &sectgrid_range[i];
+
+        for (bssize_t cy=r->y1; cy<=r->y2; cy++)
+            for (bssize_t cx=r->x1; cx<=r->x2; cx++)
+                sectgrid_sects[fill[cy*sectgrid_cols + cx]++] = i;
+    }
+
+    Bfree(fill);
+}
+
+void sectgrid_begin(int32_t x, int32_t y, sectgrid_iter_t *it)
+{
+    it->numcell = it->nummoved = 0;
+
+    if (editstatus)
+    {
+        it->rest = numsectors;
+        return;
+    }
+
+    if (numsectors != sectgrid_numsectors || numwalls != sectgrid_numwalls)
+        sectgrid_build();
+
+    it->rest = 0;
+    it->moved = sectgrid_moved;
+    it->nummoved = sectgrid_nummoved;
+
+    int32_t const cx = sectgrid_cellx(x), cy = sectgrid_celly(y);
+
+    if ((unsigned)cx < (unsigned)sectgrid_cols && (unsigned)cy < (unsigned)sectgrid_rows)
+    {
+        int32_t const c = cy*sectgrid_cols + cx;
+
+        it->cell = &sectgrid_sects[sectgrid_cellstart[c]];
+        it->numcell = sectgrid_cellstart[c+1] - sectgrid_cellstart[c];
+    }
+}
+
+void sectgrid_movedwall(int32_t wallnum)
+{
+    if (sectgrid_numsectors != numsectors || sectgrid_numwalls != numwalls || sectgrid_range == NULL)
+        return;
+
+    int32_t const sectnum = sectorofwall(wallnum);
+
+    if (sectnum < 0 || (sectgrid_ismoved[sectnum>>3] & pow2char[sectnum&7]))
+        return;
+
+    // The sector's bounding box grows only if this vertex leaves it.
+    sgrange_t const *const r = &sectgrid_range[sectnum];
+    int32_t const x = wall[wallnum].x, y = wall[wallnum].y;
+
+    if (sectgrid_cellx(max(x, INT32_MIN+1)-1) >= r->x1 && sectgrid_cellx(x) <= r->x2 &&
+        sectgrid_celly(max(y, INT32_MIN+1)-1) >= r->y1 && sectgrid_celly(y) <= r->y2)
+        return;
+
+    if (sectgrid_nummoved == SECTGRID_MAXMOVED)
+    {
+        sectgrid_invalidate();
+        return;
+    }
+
+    int32_t i = sectgrid_nummoved++;
+
+    for (; i > 0 && sectgrid_moved[i-1] < sectnum; i--)
+        sectgrid_moved[i] = sectgrid_moved[i-1];
+
+    sectgrid_moved[i] = sectnum;
+    sectgrid_ismoved[sectnum>>3] |= pow2char[sectnum&7];
+}
+
+void sectgrid_benchmark(int32_t numpoints)
+{
+    if (numsectors <= 0)
+    {
+        OSD_Printf("No map loaded.\n");
+        return;
+    }
+
+    if (editstatus)
+    {
+        OSD_Printf("The sector grid is not used in the editor.\n");
+        return;
+    }
+
+    sectgrid_iter_t it;
+    sectgrid_begin(0, 0, &it);
+
+    if (sectgrid_cols == 0)
+    {
+        OSD_Printf("Map has no walls.\n");
+        return;
+    }
+
+    vec2_t *const pts = (vec2_t *)Xmalloc(numpoints * sizeof(vec2_t));
+    int16_t *const ref = (int16_t *)Xmalloc(numpoints * sizeof(int16_t));
+    uint32_t seed = 1;
+
+    for (bssize_t i=0; i<numpoints; i++)
+    {
+        seed = seed*1664525 + 1013904223;
+        pts[i].x = sectgrid_minx + (int32_t)(((uint64_t)seed * ((uint64_t)sectgrid_cols << sectgrid_shift)) >> 32);
+        seed = seed*1664525 + 1013904223;
+        pts[i].y = sectgrid_miny + (int32_t)(((uint64_t)seed * ((uint64_t)sectgrid_rows << sectgrid_shift)) >> 32);
+    }
+
+    double t = timerGetHiTicks();
+
+    for (bssize_t i=0; i<numpoints; i++)
+    {
+        ref[i] = -1;
+
+        for (bssize_t j=numsectors-1; j>=0; --j)
+            if (inside(pts[i].x, pts[i].y, j) == 1)
+            {
+                ref[i] = j;
+                break;
+            }
+    }
+
+    double const lineartime = timerGetHiTicks() - t;
+    int32_t numinside = 0, numtried = 0, nummismatched = 0;
+
+    t = timerGetHiTicks();
+
+    for (bssize_t i=0; i<numpoints; i++)
+    {
+        int32_t j;
+
+        sectgrid_begin(pts[i].x, pts[i].y, &it);
+
+        while ((j = sectgrid_next(&it)) >= 0)
+        {
+            numtried++;
+
+            if (inside(pts[i].x, pts[i].y, j) == 1)
+                break;
+        }
+
+        numinside += (j >= 0);
+        nummismatched += (j != ref[i]);
+    }
+
+    double const gridtime = timerGetHiTicks() - t;
+
+    OSD_Printf("Sector lookup benchmark, %d random points over %d sectors (%d inside a sector):\n",
+               numpoints, numsectors, numinside);
+    OSD_Printf("  all sectors: %8.3f us/lookup\n", lineartime * 1000.0 / numpoints);
+    OSD_Printf("  sector grid: %8.3f us/lookup, %.2fx, %.1f sectors tried/lookup\n", gridtime * 1000.0 / numpoints,
+               gridtime > 0.0 ? lineartime / gridtime : 0.0, (double)numtried / numpoints);
+    OSD_Printf("  grid: %dx%d cells of %d units, %d entries, %d moved sectors\n", sectgrid_cols, sectgrid_rows,
+               1 << sectgrid_shift, sectgrid_cellstart[sectgrid_cols*sectgrid_rows], sectgrid_nummoved);
+
+    if (nummismatched)
+        OSD_Printf("  %d lookups DISAGREE with the full scan!\n", nummismatched);
+
+    Bfree(pts);
+    Bfree(ref);
+}
@@ -9,6 +9,7 @@
 
 #include "pragmas.h"
 #include "build.h"
+#include "threadpool.h"
 
 static uint8_t* buffer;
 static vec2_t bufferRes;
@@ -139,13 +140,21 @@ vec2_t softsurface_getDestinationBufferResolution()
 #define BLIT16(x) BLIT8(x); BLIT8(x+8)
 #define BLIT32(x) BLIT16(x); BLIT16(x+16)
 #define BLIT64(x) BLIT32(x); BLIT32(x+32)
+
+// first destination scanline covered by source scanline y
+static FORCE_INLINE uint32_t destLine(uint32_t y)
+{
+    return (uint32_t)(((uint64_t)y * yScale16) >> 16);
+}
+
+// blits source scanlines [yStart, yEnd), each upscaled to its run of destination scanlines
 template <typename UINTTYPE>
-void softsurface_blitBufferInternal(UINTTYPE* destBuffer)
+void softsurface_blitBufferInternal(UINTTYPE* destBuffer, uint32_t yStart, uint32_t yEnd)
 {
-    const uint8_t* __restrict pSrc = buffer;
-    UINTTYPE* __restrict pDst = destBuffer;
-    const UINTTYPE* const pEnd = destBuffer+destBufferRes.x*mulscale16(yScale16, bufferRes.y);
-    uint32_t remainder = 0;
+    const uint8_t* __restrict pSrc = buffer+yStart*bufferRes.x;
+    UINTTYPE* __restrict pDst = destBuffer+destBufferRes.x*destLine(yStart);
+    const UINTTYPE* const pEnd = destBuffer+destBufferRes.x*destLine(yEnd);
+    uint32_t y = yStart;
     while (pDst < pEnd)
     {
         uint16_t* __restrict pScanPos = scanPosLookupTable;
@@ -164,22 +173,36 @@ void softsurface_blitBufferInternal(UINTTYPE* destBuffer)
         }
         pSrc += bufferRes.x;
 
-        static const uint32_t MASK16 = (1<<16)-1;
-        uint32_t linesCopied = 1;
-        uint32_t linesToCopy = yScale16+remainder;
-        remainder = linesToCopy & MASK16;
-        linesToCopy = (linesToCopy >> 16)-1;
+        ++y;
+        int32_t linesToCopy = destLine(y)-destLine(y-1)-1;
         const UINTTYPE* const __restrict pScanLineSrc = pDst-destBufferRes.x;
-        while (linesToCopy)
+        for (; linesToCopy > 0; --linesToCopy)
         {
-            uint32_t lines = min(linesCopied, linesToCopy);
-            memcpy(pDst, pScanLineSrc, sizeof(UINTTYPE)*lines*destBufferRes.x);
-            pDst += lines*destBufferRes.x;
-            linesToCopy -= lines;
+            memcpy(pDst, pScanLineSrc, sizeof(UINTTYPE)*destBufferRes.x);
+            pDst += destBufferRes.x;
         }
     }
 }
 
+struct blitJob
+{
+    uint32_t* destBuffer;
+    uint32_t destBpp;
+};
+
+// each part gets a horizontal strip of whole source scanlines, so strips never share a destination row
+static void softsurface_blitStrip(int32_t part, int32_t numParts, void* data)
+{
+    auto const job = (blitJob const*) data;
+    uint32_t const yStart = bufferRes.y*part/numParts;
+    uint32_t const yEnd = bufferRes.y*(part+1)/numParts;
+
+    if (job->destBpp <= 16)
+        softsurface_blitBufferInternal<uint16_t>((uint16_t*) job->destBuffer, yStart, yEnd);
+    else
+        softsurface_blitBufferInternal<uint32_t>(job->destBuffer, yStart, yEnd);
+}
+
 void softsurface_blitBuffer(uint32_t* destBuffer,
                             uint32_t destBpp)
 {
@@ -191,18 +214,16 @@ void softsurface_blitBuffer(uint32_t* destBuffer,
     switch (destBpp)
     {
     case 15:
-        softsurface_blitBufferInternal<uint16_t>((uint16_t*) destBuffer);
-        break;
     case 16:
-        softsurface_blitBufferInternal<uint16_t>((uint16_t*) destBuffer);
-        break;
     case 24:
-        softsurface_blitBufferInternal<uint32_t>(destBuffer);
-        break;
     case 32:
-        softsurface_blitBufferInternal<uint32_t>(destBuffer);
         break;
     default:
         return;
     }
+
+    blitJob job = { destBuffer, destBpp };
+    int32_t const numParts = min(threadpool_numworkers()+1, bufferRes.y);
+
+    threadpool_run(softsurface_blitStrip, &job, numParts);
 }
@@ -0,0 +1,235 @@
+#include "compat.h"
+
+#ifdef _WIN32
+# define NEED_PROCESS_H
+# include "windows_inc.h"
+#endif
+
+#include "threadpool.h"
+#include "mutex.h"
+
+#ifdef RENDERTYPEWIN
+typedef HANDLE workerthread_t;
+typedef HANDLE semaphore_t;
+#else
+typedef SDL_Thread *workerthread_t;
+typedef SDL_sem *semaphore_t;
+#endif
+
+static struct
+{
+    workerthread_t thread[MAXWORKERTHREADS];
+    semaphore_t    start[MAXWORKERTHREADS];
+    semaphore_t    done;
+    int32_t        numworkers;
+    int32_t        quit;
+
+    threadpool_job_t func;
+    void *           data;
+    int32_t          numparts;
+} pool;
+
+static semaphore_t semaphore_create(void)
+{
+#ifdef RENDERTYPEWIN
+    return CreateSemaphore(NULL, 0, MAXWORKERTHREADS, NULL);
+#else
+    return SDL_CreateSemaphore(0);
+#endif
+}
+
+static void semaphore_destroy(semaphore_t sem)
+{
+#ifdef RENDERTYPEWIN
+    CloseHandle(sem);
+#else
+    SDL_DestroySemaphore(sem);
+#endif
+}
+
+static FORCE_INLINE void semaphore_wait(semaphore_t sem)
+{
+#ifdef RENDERTYPEWIN
+    WaitForSingleObject(sem, INFINITE);
+#else
+    SDL_SemWait(sem);
+#endif
+}
+
+static FORCE_INLINE void semaphore_post(semaphore_t sem)
+{
+#ifdef RENDERTYPEWIN
+    ReleaseSemaphore(sem, 1, NULL);
+#else
+    SDL_SemPost(sem);
+#endif
+}
+
+// parts are dealt out round-robin: the caller takes 0, n+1, ... and worker i takes i+1, i+n+2, ...
+static FORCE_INLINE void threadpool_runshare(int32_t const share)
+{
+    for (int32_t part = share; part < pool.numparts; part += pool.numworkers + 1)
+        pool.func(part, pool.numparts, pool.data);
+}
+
+#ifdef RENDERTYPEWIN
+static DWORD WINAPI threadpool_worker(LPVOID param)
+#else
+static int threadpool_worker(void *param)
+#endif
+{
+    int32_t const worker = (int32_t)(intptr_t)param;
+
+    for (;;)
+    {
+        semaphore_wait(pool.start[worker]);
+
+        if (pool.quit)
+            break;
+
+        threadpool_runshare(worker + 1);
+        semaphore_post(pool.done);
+    }
+
+    return 0;
+}
+
+void threadpool_uninit(void)
+{
+    if (!pool.numworkers)
+        return;
+
+    pool.quit = 1;
+
+    for (int32_t i = 0; i < pool.numworkers; i++)
+        semaphore_post(pool.start[i]);
+
+    for (int32_t i = 0; i < pool.numworkers; i++)
+    {
+#ifdef RENDERTYPEWIN
+        WaitForSingleObject(pool.thread[i], INFINITE);
+        CloseHandle(pool.thread[i]);
+#else
+        SDL_WaitThread(pool.thread[i], NULL);
+#endif
+        semaphore_destroy(pool.start[i]);
+    }
+
+    semaphore_destroy(pool.done);
+
+    pool.numworkers = 0;
+    pool.quit = 0;
+}
+
+void threadpool_init(int32_t numworkers)
+{
+    threadpool_uninit();
+
+    numworkers = clamp(numworkers, 0, MAXWORKERTHREADS);
+
+    if (!numworkers)
+        return;
+
+    pool.done = semaphore_create();
+
+    for (int32_t i = 0; i < numworkers; i++)
+    {
+        pool.start[i] = semaphore_create();
+#ifdef RENDERTYPEWIN
+        pool.thread[i] = CreateThread(NULL, 0, threadpool_worker, (LPVOID)(intptr_t)i, 0, NULL);
+#else
+        pool.thread[i] = SDL_CreateThread(threadpool_worker, "worker", (void *)(intptr_t)i);
+#endif
+        if (pool.thread[i] == NULL)
+        {
+            semaphore_destroy(pool.start[i]);
+            break;
+        }
+
+        pool.numworkers++;
+    }
+
+    if (!pool.numworkers)
+        semaphore_destroy(pool.done);
+}
+
+int32_t threadpool_numworkers(void)
+{
+    return pool.numworkers;
+}
+
+void threadpool_run(threadpool_job_t func, void *data, int32_t numparts)
+{
+    if (!pool.numworkers || numparts <= 1)
+    {
+        for (int32_t part = 0; part < numparts; part++)
+            func(part, numparts, data);
+        return;
+    }
+
+    pool.func     = func;
+    pool.data     = data;
+    pool.numparts = numparts;
+
+    int32_t const numwoken = min(pool.numworkers, numparts - 1);
+
+    for (int32_t i = 0; i < numwoken; i++)
+        semaphore_post(pool.start[i]);
+
+    threadpool_runshare(0);
+
+    for (int32_t i = 0; i < numwoken; i++)
+        semaphore_wait(pool.done);
+}
+
+typedef struct
+{
+    threadpool_job_t func;
+    void *           data;
+    workerthread_t   thread;
+} spawnedthread_t;
+
+#ifdef RENDERTYPEWIN
+static DWORD WINAPI threadpool_spawned(LPVOID param)
+#else
+static int threadpool_spawned(void *param)
+#endif
+{
+    auto const t = (spawnedthread_t *)param;
+
+    t->func(0, 1, t->data);
+
+    return 0;
+}
+
+void *threadpool_spawn(threadpool_job_t func, void *data)
+{
+    auto t = (spawnedthread_t *)Xmalloc(sizeof(spawnedthread_t));
+
+    t->func = func;
+    t->data = data;
+#ifdef RENDERTYPEWIN
+    t->thread = CreateThread(NULL, 0, threadpool_spawned, (LPVOID)t, 0, NULL);
+#else
+    t->thread = SDL_CreateThread(threadpool_spawned, "spawned", (void *)t);
+#endif
+
+    if (t->thread == NULL)
+        DO_FREE_AND_NULL(t);
+
+    return t;
+}
+
+void threadpool_join(void *thread)
+{
+    auto const t = (spawnedthread_t *)thread;
+
+#ifdef RENDERTYPEWIN
+    WaitForSingleObject(t->thread, INFINITE);
+    CloseHandle(t->thread);
+#else
+    SDL_WaitThread(t->thread, NULL);
+#endif
+
+    Bfree(t);
+}
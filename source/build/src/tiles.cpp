@@ -687,6 +687,20 @@ void tileLoadData(int16_t tilenume, int32_t dasiz, char *buffer)
         faketimerhandler();
     }
 
+    // Copy straight out of a memory-mapped group file if possible. Tiles
+    // can't point into the mapping itself: it is read-only while callers
+    // render into and rotate tiles in place, and reloading an evicted or
+    // invalidated tile has to restore its original contents.
+    int32_t artleng;
+    char const * const mapped = kfilemapping(artfil, &artleng);
+
+    if (mapped && tilefileoffs[tilenume] + dasiz <= artleng)
+    {
+        Bmemcpy(buffer, mapped + tilefileoffs[tilenume], dasiz);
+        faketimerhandler();
+        return;
+    }
+
     // Seek to the right position.
     if (artfilplc != tilefileoffs[tilenume])
     {
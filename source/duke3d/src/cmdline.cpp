@@ -40,6 +40,7 @@ const char *CommandMap = NULL;
 const char *CommandName = NULL;
 int32_t g_forceWeaponChoice = 0;
 int32_t g_fakeMultiMode = 0;
+int32_t g_scriptCacheMode = SCRIPTCACHE_OFF;
 
 void G_ShowParameterHelp(void)
 {
@@ -54,6 +55,8 @@ void G_ShowParameterHelp(void)
         "-connect [host]\tConnect to a multiplayer game\n"
         "-c#\t\tMultiplayer mode #, 1 = DM, 2 = Co-op, 3 = DM(no spawn)\n"
         "-d [file.edm or #]\tPlay a demo\n"
+        "-benchmark [file.edm or #][:#]\tTime a demo without video or sound, drawing # frames per gametic\n"
+        "-benchmarkout [file.csv|file.json]\tWrite per-frame -benchmark timings to this file\n"
         "-g [file.grp]\tLoad additional game data\n"
         "-h [file.def]\tLoad an alternate definitions file\n"
         "-j [dir]\t\tAdd a directory to " APPNAME "'s search list\n"
@@ -102,6 +105,8 @@ void G_ShowDebugHelp(void)
         "-a\t\tUse fake player AI (fake multiplayer only)\n"
 #endif
         "-cachesize #\tSet cache size in kB\n"
+        "-concache\tLoad compiled CON scripts from concache.dat if their files are unchanged\n"
+        "-concachecheck\tCompile CON scripts and compare the result with concache.dat\n"
         "-game_dir [dir]\tSpecify game data directory\n"
         "-gamegrp   \tSelect main grp file\n"
         "-name [name]\tPlayer name in multiplayer\n"
@@ -161,6 +166,33 @@ static void G_AddDemo(const char* param)
     }
 }
 
+static void G_AddBenchmark(const char* param)
+{
+    Bstrncpy(tempbuf, param, sizeof(tempbuf));
+    char * colon = (char *) Bstrchr(tempbuf, ':');
+    int32_t framespertic = 1;
+
+    if (colon && colon != tempbuf)
+    {
+        // -benchmark <filename>:<num>
+        *(colon++) = 0;
+        framespertic = Batoi(colon);
+    }
+
+    Demo_SetFirst(tempbuf);
+
+    framespertic = clamp(framespertic, 1, 8)+1;
+    initprintf("Benchmark demo %s, %d frames/gametic.\n", g_firstDemoFile, framespertic-1);
+    Demo_PlayFirst(framespertic, 1);
+    g_demo_benchmark = 1;
+
+    // render into the software surface only, with no window, sound or interaction
+    headlessvideo = 1;
+    g_noSetup = g_noLogo = TRUE;
+    g_noSound = 2;
+    g_noMusic = 1;
+}
+
 void G_CheckCommandLine(int32_t argc, char const * const * argv)
 {
     int16_t i = 1, j;
@@ -490,6 +522,26 @@ void G_CheckCommandLine(int32_t argc, char const * const * argv)
                     i++;
                     continue;
                 }
+                if (!Bstrcasecmp(c+1, "benchmark"))
+                {
+                    if (argc > i+1)
+                    {
+                        G_AddBenchmark(argv[i+1]);
+                        i++;
+                    }
+                    i++;
+                    continue;
+                }
+                if (!Bstrcasecmp(c+1, "benchmarkout"))
+                {
+                    if (argc > i+1)
+                    {
+                        Demo_SetBenchmarkFile(argv[i+1]);
+                        i++;
+                    }
+                    i++;
+                    continue;
+                }
                 if (!Bstrcasecmp(c+1, "d"))
                 {
                     if (argc > i+1)
@@ -518,6 +570,18 @@ void G_CheckCommandLine(int32_t argc, char const * const * argv)
                     i++;
                     continue;
                 }
+                if (!Bstrcasecmp(c+1, "concache"))
+                {
+                    g_scriptCacheMode = SCRIPTCACHE_USE;
+                    i++;
+                    continue;
+                }
+                if (!Bstrcasecmp(c+1, "concachecheck"))
+                {
+                    g_scriptCacheMode = SCRIPTCACHE_CHECK;
+                    i++;
+                    continue;
+                }
                 if (!Bstrcasecmp(c+1, "nologo"))
                 {
                     g_noLogo = 1;
@@ -38,4 +38,13 @@ extern const char *CommandMap;
 extern const char *CommandName;
 extern int32_t g_forceWeaponChoice;
 extern int32_t g_fakeMultiMode;
+
+// what C_Compile() does with concache.dat
+enum
+{
+    SCRIPTCACHE_OFF,    // always compile, don't write it
+    SCRIPTCACHE_USE,    // load it if it matches, otherwise compile and write it
+    SCRIPTCACHE_CHECK,  // load it, compile anyway and report any difference
+};
+extern int32_t g_scriptCacheMode;
 #endif // cmdline_h__
@@ -250,6 +250,9 @@ void CONFIG_SetDefaults(void)
     ud.config.MusicVolume     = 195;
     ud.config.NumBits         = 16;
     ud.config.NumChannels     = 2;
+    ud.config.BufferSize      = 0;
+    ud.config.AdaptiveBuffer  = 0;
+    ud.config.ResampleCache   = 1;
     ud.config.ReverseStereo   = 0;
     ud.config.ShowWeapons     = 0;
     ud.config.SmoothInput     = 1;
@@ -733,7 +736,8 @@ void CONFIG_WriteSettings(void) // save binds and aliases to <cfgname>_settings.
 
 void CONFIG_WriteSetup(uint32_t flags)
 {
-    if (!ud.config.setupread) return;
+    // don't let the video settings forced by a headless run leak into the user's config
+    if (!ud.config.setupread || headlessvideo) return;
 
     if (ud.config.scripthandle < 0)
         ud.config.scripthandle = SCRIPT_Init(g_setupFileName);
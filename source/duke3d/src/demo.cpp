@@ -383,8 +383,25 @@ static struct {
     double totalgamems;
     double totalroomsdrawms, totalrestdrawms;
     double starthiticks;
+    double ticgamems, framemasksms;
 } g_prof;
 
+// -benchmark: per-frame records, written out by Demo_FinishProfile()
+typedef struct {
+    int32_t gametic;
+    float gamems, roomsms, masksms, hudms;
+} benchframe_t;
+
+int32_t g_demo_benchmark;
+static char g_demo_benchmarkFile[BMAX_PATH] = "benchmark.csv";
+static benchframe_t *g_benchFrames;
+static int32_t g_benchNumFrames, g_benchAllocFrames;
+
+void Demo_SetBenchmarkFile(const char *fn)
+{
+    Bstrncpyz(g_demo_benchmarkFile, fn, sizeof(g_demo_benchmarkFile));
+}
+
 int32_t Demo_IsProfiling(void)
 {
     return (g_demo_profile > 0);
@@ -398,14 +415,43 @@ static void Demo_StopProfiling(void)
 static void Demo_GToc(double t)
 {
     g_prof.numtics++;
-    g_prof.totalgamems += timerGetHiTicks()-t;
+    g_prof.ticgamems = timerGetHiTicks()-t;
+    g_prof.totalgamems += g_prof.ticgamems;
+}
+
+void Demo_MToc(double t)
+{
+    g_prof.framemasksms += timerGetHiTicks()-t;
 }
 
 static void Demo_RToc(double t1, double t2)
 {
+    double const t3 = timerGetHiTicks();
+
     g_prof.numframes++;
     g_prof.totalroomsdrawms += t2-t1;
-    g_prof.totalrestdrawms += timerGetHiTicks()-t2;
+    g_prof.totalrestdrawms += t3-t2;
+
+    if (g_demo_benchmark)
+    {
+        if (g_benchNumFrames == g_benchAllocFrames)
+        {
+            g_benchAllocFrames = g_benchAllocFrames ? g_benchAllocFrames<<1 : 4096;
+            g_benchFrames = (benchframe_t *)Xrealloc(g_benchFrames, g_benchAllocFrames * sizeof(benchframe_t));
+        }
+
+        benchframe_t &f = g_benchFrames[g_benchNumFrames++];
+
+        // game time is charged to the first frame drawn after the tic ran
+        f.gametic = g_demo_cnt;
+        f.gamems  = g_prof.ticgamems;
+        f.masksms = g_prof.framemasksms;
+        f.roomsms = (t2-t1) - g_prof.framemasksms;
+        f.hudms   = t3-t2;
+    }
+
+    g_prof.ticgamems = 0;
+    g_prof.framemasksms = 0;
 }
 
 static void Demo_DisplayProfStatus(void)
@@ -419,6 +465,13 @@ static void Demo_DisplayProfStatus(void)
         return;
     lastpercent = percent;
 
+    if (headlessvideo)
+    {
+        if (percent % 10 == 0)
+            initprintf("benchmark: %d/%d game tics (%d %%)\n", g_demo_cnt, g_demo_totalCnt, percent);
+        return;
+    }
+
     videoClearScreen(0);
     Bsnprintf(buf, sizeof(buf), "timing... %d/%d game tics (%d %%)",
               g_demo_cnt, g_demo_totalCnt, percent);
@@ -434,10 +487,161 @@ static void Demo_SetupProfile(void)
     ud.config.SoundToggle = 0;  // restored by Demo_FinishProfile()
 
     Bmemset(&g_prof, 0, sizeof(g_prof));
+    g_benchNumFrames = 0;
 
     g_prof.starthiticks = timerGetHiTicks();
 }
 
+enum { BENCH_GAME, BENCH_DRAWROOMS, BENCH_DRAWMASKS, BENCH_HUD, BENCH_TOTAL, BENCH_NUMCOLUMNS };
+enum { BENCH_MEAN, BENCH_P50, BENCH_P90, BENCH_P99, BENCH_MAX, BENCH_NUMSTATS };
+
+static const char *const s_benchColumns[BENCH_NUMCOLUMNS] = { "game_ms", "drawrooms_ms", "drawmasks_ms", "hud_ms", "total_ms" };
+static const char *const s_benchStats[BENCH_NUMSTATS] = { "mean", "p50", "p90", "p99", "max" };
+
+static double Demo_BenchValue(benchframe_t const &f, int32_t col)
+{
+    switch (col)
+    {
+        case BENCH_GAME: return f.gamems;
+        case BENCH_DRAWROOMS: return f.roomsms;
+        case BENCH_DRAWMASKS: return f.masksms;
+        case BENCH_HUD: return f.hudms;
+        default: return (double)f.gamems + f.roomsms + f.masksms + f.hudms;
+    }
+}
+
+static int32_t Demo_CompareDoubles(const void *a, const void *b)
+{
+    double const da = *(double const *)a, db = *(double const *)b;
+    return (da > db) - (da < db);
+}
+
+// Nearest-rank percentiles over all frames. Game tic times are taken only from
+// the frames that carry one, so drawing several frames per tic doesn't dilute them.
+static void Demo_BenchStats(double stats[BENCH_NUMCOLUMNS][BENCH_NUMSTATS])
+{
+    double *const vals = (double *)Xmalloc(g_benchNumFrames * sizeof(double));
+
+    for (int32_t col=0; col<BENCH_NUMCOLUMNS; col++)
+    {
+        int32_t n = 0;
+        double sum = 0;
+
+        for (int32_t i=0; i<g_benchNumFrames; i++)
+        {
+            if (col == BENCH_GAME && i > 0 && g_benchFrames[i].gametic == g_benchFrames[i-1].gametic)
+                continue;
+
+            vals[n] = Demo_BenchValue(g_benchFrames[i], col);
+            sum += vals[n++];
+        }
+
+        qsort(vals, n, sizeof(double), Demo_CompareDoubles);
+
+        stats[col][BENCH_MEAN] = sum / n;
+        stats[col][BENCH_P50] = vals[(n*50-1)/100];
+        stats[col][BENCH_P90] = vals[(n*90-1)/100];
+        stats[col][BENCH_P99] = vals[(n*99-1)/100];
+        stats[col][BENCH_MAX] = vals[n-1];
+    }
+
+    Bfree(vals);
+}
+
+static void Demo_WriteJSONString(BFILE *fp, const char *str)
+{
+    Bfputc('"', fp);
+    for (; *str; str++)
+    {
+        if (*str == '"' || *str == '\\')
+            Bfputc('\\', fp);
+        Bfputc(*str, fp);
+    }
+    Bfputc('"', fp);
+}
+
+static void Demo_WriteBenchmark(int32_t dn)
+{
+    if (g_benchNumFrames == 0)
+        return;
+
+    double stats[BENCH_NUMCOLUMNS][BENCH_NUMSTATS];
+    Demo_BenchStats(stats);
+
+    for (int32_t col=0; col<BENCH_NUMCOLUMNS; col++)
+        OSD_Printf("== demo %d %-12s mean %7.3f  p50 %7.3f  p90 %7.3f  p99 %7.3f  max %7.3f\n", dn, s_benchColumns[col],
+                   stats[col][BENCH_MEAN], stats[col][BENCH_P50], stats[col][BENCH_P90], stats[col][BENCH_P99], stats[col][BENCH_MAX]);
+
+    BFILE *fp = Bfopen(g_demo_benchmarkFile, "wt");
+
+    if (!fp)
+    {
+        OSD_Printf(OSD_ERROR "Unable to write benchmark results to \"%s\"!\n", g_demo_benchmarkFile);
+        return;
+    }
+
+    char const *const ext = Bstrrchr(g_demo_benchmarkFile, '.');
+
+    if (ext && !Bstrcasecmp(ext, ".json"))
+    {
+        Bfprintf(fp, "{\n  \"demo\": ");
+        Demo_WriteJSONString(fp, g_firstDemoFile);
+        Bfprintf(fp, ",\n  \"xdim\": %d,\n  \"ydim\": %d,\n  \"renderer\": %d,\n  \"r_blitthreads\": %d,\n",
+                 xdim, ydim, videoGetRenderMode(), r_blitthreads);
+        Bfprintf(fp, "  \"framespertic\": %d,\n  \"gametics\": %d,\n  \"frames\": %d,\n  \"summary\": {\n",
+                 g_demo_profile-1, g_prof.numtics, g_benchNumFrames);
+
+        for (int32_t col=0; col<BENCH_NUMCOLUMNS; col++)
+        {
+            Bfprintf(fp, "    \"%s\": {", s_benchColumns[col]);
+            for (int32_t s=0; s<BENCH_NUMSTATS; s++)
+                Bfprintf(fp, " \"%s\": %.4f%s", s_benchStats[s], stats[col][s], s < BENCH_NUMSTATS-1 ? "," : " ");
+            Bfprintf(fp, "}%s\n", col < BENCH_NUMCOLUMNS-1 ? "," : "");
+        }
+
+        Bfprintf(fp, "  },\n  \"columns\": [\"gametic\"");
+        for (int32_t col=0; col<BENCH_NUMCOLUMNS; col++)
+            Bfprintf(fp, ", \"%s\"", s_benchColumns[col]);
+        Bfprintf(fp, "],\n  \"perframe\": [\n");
+
+        for (int32_t i=0; i<g_benchNumFrames; i++)
+        {
+            benchframe_t const &f = g_benchFrames[i];
+            Bfprintf(fp, "    [%d, %.4f, %.4f, %.4f, %.4f, %.4f]%s\n", f.gametic, f.gamems, f.roomsms, f.masksms, f.hudms,
+                     Demo_BenchValue(f, BENCH_TOTAL), i < g_benchNumFrames-1 ? "," : "");
+        }
+
+        Bfprintf(fp, "  ]\n}\n");
+    }
+    else
+    {
+        // one row per frame, followed by one row per summary statistic
+        Bfprintf(fp, "frame,gametic");
+        for (int32_t col=0; col<BENCH_NUMCOLUMNS; col++)
+            Bfprintf(fp, ",%s", s_benchColumns[col]);
+        Bfprintf(fp, "\n");
+
+        for (int32_t i=0; i<g_benchNumFrames; i++)
+        {
+            benchframe_t const &f = g_benchFrames[i];
+            Bfprintf(fp, "%d,%d,%.4f,%.4f,%.4f,%.4f,%.4f\n", i, f.gametic, f.gamems, f.roomsms, f.masksms, f.hudms,
+                     Demo_BenchValue(f, BENCH_TOTAL));
+        }
+
+        for (int32_t s=0; s<BENCH_NUMSTATS; s++)
+        {
+            Bfprintf(fp, "%s,", s_benchStats[s]);
+            for (int32_t col=0; col<BENCH_NUMCOLUMNS; col++)
+                Bfprintf(fp, ",%.4f", stats[col][s]);
+            Bfprintf(fp, "\n");
+        }
+    }
+
+    Bfclose(fp);
+
+    OSD_Printf("== demo %d: wrote %d frames to \"%s\"\n", dn, g_benchNumFrames, g_demo_benchmarkFile);
+}
+
 static void Demo_FinishProfile(void)
 {
     if (Demo_IsProfiling())
@@ -458,7 +662,7 @@ static void Demo_FinishProfile(void)
 
         if (nf > 0)
         {
-            OSD_Printf("== demo %d: %d frames (%d frames/gametic)\n", dn, nf, g_demo_profile-1);
+            OSD_Printf("== demo %d: %d frames (%d frames/gametic, r_blitthreads %d)\n", dn, nf, g_demo_profile-1, r_blitthreads);
             OSD_Printf("== demo %d drawrooms times: %.03f s (%.03f ms/frame)\n",
                        dn, dms1/1000.0, dms1/nf);
             OSD_Printf("== demo %d drawrest times: %.03f s (%.03f ms/frame)\n",
@@ -472,6 +676,14 @@ static void Demo_FinishProfile(void)
                 OSD_Printf("== demo %d: non-profiled time overhead: %.02f %%\n",
                            dn, 100.0*totalms/totalprofms - 100.0);
         }
+
+        if (g_demo_benchmark)
+        {
+            Demo_WriteBenchmark(dn);
+
+            DO_FREE_AND_NULL(g_benchFrames);
+            g_benchNumFrames = g_benchAllocFrames = 0;
+        }
     }
 
     g_demo_profile = 0;
@@ -787,7 +999,8 @@ nextdemo_nomenu:
         if (Demo_IsProfiling())
             totalclock += TICSPERFRAME;
 
-        if (G_FPSLimit())
+        // profiling draws every gametic, so r_maxfps must not drop any
+        if (Demo_IsProfiling() || G_FPSLimit())
         {
             if (foundemo == 0)
             {
@@ -57,6 +57,10 @@ void Demo_PlayFirst(int32_t prof, int32_t exitafter);
 void Demo_SetFirst(const char *demostr);
 
 int32_t Demo_IsProfiling(void);
+void Demo_MToc(double t);
+
+extern int32_t g_demo_benchmark;
+void Demo_SetBenchmarkFile(const char *fn);
 
 #if KRANDDEBUG
 int32_t krd_print(const char *filename);
@@ -61,7 +61,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 # define BYTEVERSION_EDUKE32      339
 #else
 // Non-Lua build
-# define BYTEVERSION_EDUKE32      339
+# define BYTEVERSION_EDUKE32      342
 #endif
 
 //#define BYTEVERSION_13      27
@@ -285,7 +285,8 @@ void G_GameExit(const char *msg)
     // JBF: fixes crash on demo playback
     // PK: modified from original
 
-    if (!g_quickExit)
+    // headless runs have nobody to dismiss the exit screens
+    if (!g_quickExit && !headlessvideo)
     {
         if (VM_OnEventWithReturn(EVENT_EXITGAMESCREEN, g_player[myconnectindex].ps->i, myconnectindex, 0) == 0 &&
            g_mostConcurrentPlayers > 1 && g_player[myconnectindex].ps->gm & MODE_GAME && GTFLAGS(GAMETYPE_SCORESHEET) && *msg == ' ')
@@ -701,6 +702,20 @@ static void G_ReadGLFrame(void)
 }
 #endif
 
+// renderDrawMasks() for the view itself, timed on its own when profiling a demo
+static void G_DrawMasks(void)
+{
+    if (!Demo_IsProfiling())
+    {
+        renderDrawMasks();
+        return;
+    }
+
+    double const t = timerGetHiTicks();
+    renderDrawMasks();
+    Demo_MToc(t);
+}
+
 void G_DrawRooms(int32_t playerNum, int32_t smoothRatio)
 {
     DukePlayer_t *const pPlayer = g_player[playerNum].ps;
@@ -775,7 +790,7 @@ void G_DrawRooms(int32_t playerNum, int32_t smoothRatio)
             renderDrawRoomsQ16(pSprite->x, pSprite->y, pSprite->z - ZOFFSET6, CAMERA(q16ang), fix16_from_int(pSprite->yvel), pSprite->sectnum);
             yax_drawrooms(G_DoSpriteAnimations, pSprite->sectnum, 0, smoothRatio);
             G_DoSpriteAnimations(pSprite->x, pSprite->y, fix16_to_int(CAMERA(q16ang)), smoothRatio);
-            renderDrawMasks();
+            G_DrawMasks();
         }
     }
     else
@@ -1047,7 +1062,7 @@ void G_DrawRooms(int32_t playerNum, int32_t smoothRatio)
 #ifdef LEGACY_ROR
             drawing_ror = 0;
 #endif
-            renderDrawMasks();
+            G_DrawMasks();
 #endif
         }
 
@@ -6517,6 +6532,13 @@ int app_main(int argc, char const * const * argv)
 
     if (g_networkMode != NET_DEDICATED_SERVER)
     {
+        if (headlessvideo)
+        {
+            // only the software renderer can draw without a window
+            ud.setup.bpp = 8;
+            ud.setup.fullscreen = 0;
+        }
+
         if (videoSetGameMode(ud.setup.fullscreen, ud.setup.xdim, ud.setup.ydim, ud.setup.bpp, ud.detail) < 0)
         {
             initprintf("Failure setting video mode %dx%dx%d %s! Trying next mode...\n", ud.setup.xdim, ud.setup.ydim,
@@ -6558,8 +6580,12 @@ int app_main(int argc, char const * const * argv)
 
         g_frameDelay = calcFrameDelay(r_maxfps + r_maxfpsoffset);
         videoSetPalette(ud.brightness>>2, myplayer.palette, 0);
-        S_MusicStartup();
-        S_SoundStartup();
+
+        if (!g_demo_benchmark)
+        {
+            S_MusicStartup();
+            S_SoundStartup();
+        }
     }
 
     // check if the minifont will support lowercase letters (3136-3161)
@@ -6728,10 +6754,13 @@ MAIN_LOOP_RESTART:
 #endif
         {
             S_Cleanup();
+            S_UpdateBuffer();
             MUSIC_Update();
             G_HandleLocalKeys();
         }
 
+        G_CheckSaveGame();
+
         OSD_DispatchQueued();
 
         char gameUpdate = false;
@@ -7016,6 +7045,10 @@ int G_DoMoveThings(void)
             {
                 Net_StoreClientState();
             }
+            else
+            {
+                Net_SnapshotBenchmarkUpdate();
+            }
         }
     }
 
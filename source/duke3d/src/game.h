@@ -254,6 +254,9 @@ typedef struct {
         int32_t NumChannels;
         int32_t NumBits;
         int32_t MixRate;
+        int32_t BufferSize;
+        int32_t AdaptiveBuffer;
+        int32_t ResampleCache;
 
         int32_t ReverseStereo;
 
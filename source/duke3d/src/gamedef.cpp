@@ -23,6 +23,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "gamedef.h"
 
 #include "cheats.h"
+#include "cmdline.h"
 #include "common.h"
 #include "common_game.h"
 #include "crc32.h"
@@ -73,6 +74,93 @@ static intptr_t g_scriptEventOffset;
 // First entry is 'default' code.
 static intptr_t *g_caseTablePtr;
 
+// Offsets of instructions C_OptimizeScript() may rewrite once the whole script
+// is compiled.
+static GrowArray<int32_t> g_optimizerCandidates;
+
+// Compiled script cache
+//
+// After a successful compile, everything C_Compile() leaves behind is written
+// to a file in the mod directory: the bytecode with its pointers turned into
+// offsets, the labels, the event table, g_tile with its script pointers turned
+// into indices, and the gamevars, quotes, sounds, levels and names that the
+// definitions in the script set up. The names, lengths and CRCs of the main
+// CON file and of every file it included go along with it. On the next start,
+// if all of those files are unchanged, the cache is loaded instead of
+// compiling.
+//
+// Commands whose effects are not captured (dynamic remapping, the game,
+// DEF and CFG names, game function names) make the script uncacheable.
+
+#define SCRIPTCACHE_FILENAME "concache.dat"
+#define SCRIPTCACHE_VERSION  1
+
+static char const s_scriptCacheMagic[8] = "EDCONC";
+
+typedef struct
+{
+    char     magic[8];
+    int32_t  version, ptrsize, byteversion;
+    char     buildrev[64], buildtime[64];
+    uint32_t modulecrc;  // of the names of the -mx modules
+    int32_t  numfiles;
+    uint32_t bodylen, bodycrc;
+} scriptcacheheader_t;
+
+typedef struct
+{
+    char     filename[BMAX_PATH];
+    int32_t  length;
+    uint32_t crc;
+} scriptcachefile_t;
+
+// Definitions that cannot be captured by their result alone, replayed in order
+typedef struct
+{
+    int32_t  type;  // CON_GAMEVAR, CON_GAMEARRAY or CON_GAMESTARTUP
+    int32_t  version;
+    intptr_t value;
+    uint32_t flags;
+    char     label[MAXVARLABEL];
+    int32_t  params[31];
+} scriptcacheop_t;
+
+static GrowArray<scriptcachefile_t, 16> g_scriptCacheFiles;
+static GrowArray<scriptcacheop_t, 64> g_scriptCacheOps;
+static bool g_scriptCacheable;
+static uint32_t g_scriptCacheModuleCRC;
+
+static void C_CacheAddFile(char const *fileName, char const *data, int32_t length)
+{
+    scriptcachefile_t file;
+
+    Bmemset(&file, 0, sizeof(file));
+    Bstrncpyz(file.filename, fileName, sizeof(file.filename));
+    file.length = length;
+    file.crc    = Bcrc32(data, length, 0);
+
+    g_scriptCacheFiles.append(file);
+}
+
+static void C_CacheAddOp(int32_t type, char const *label, intptr_t value, uint32_t flags, int32_t const *params)
+{
+    scriptcacheop_t op;
+
+    Bmemset(&op, 0, sizeof(op));
+    op.type    = type;
+    op.version = g_scriptVersion;
+    op.value   = value;
+    op.flags   = flags;
+
+    if (label)
+        Bstrncpyz(op.label, label, sizeof(op.label));
+
+    if (params)
+        Bmemcpy(op.params, params, sizeof(op.params));
+
+    g_scriptCacheOps.append(op);
+}
+
 static bool C_ParseCommand(bool loop);
 static void C_SetScriptSize(int32_t newsize);
 #endif
@@ -817,6 +905,20 @@ const tokenmap_t iter_tokens [] =
     { "walofsec",         ITER_WALLSOFSECTOR },
 };
 
+// instructions without a keyword of their own, written by C_OptimizeScript()
+static tokenmap_t const vm_optimizedkeywords[] =
+{
+    { "ifvar (constant)", CON_IFCONST },
+    { "ifvare+setvar",    CON_IFVARE_SETVAR },
+    { "ifvarn+setvar",    CON_IFVARN_SETVAR },
+    { "ifvare+setvar",    CON_IFVARE_GLOBAL_SETVAR },
+    { "ifvarn+setvar",    CON_IFVARN_GLOBAL_SETVAR },
+    { "getactor+ifvare",  CON_GETSPRITESTRUCT_IFVARE },
+    { "getactor+ifvarn",  CON_GETSPRITESTRUCT_IFVARN },
+    { "getactor+ifvarl",  CON_GETSPRITESTRUCT_IFVARL },
+    { "getactor+ifvarg",  CON_GETSPRITESTRUCT_IFVARG },
+};
+
 char const * VM_GetKeywordForID(int32_t id)
 {
     // could be better but this is only called for diagnostics, ayy lmao
@@ -824,6 +926,10 @@ char const * VM_GetKeywordForID(int32_t id)
         if (keyword.val == id)
             return keyword.token;
 
+    for (tokenmap_t const & keyword : vm_optimizedkeywords)
+        if (keyword.val == id)
+            return keyword.token;
+
     return "<unknown>";
 }
 #endif
@@ -1537,10 +1643,18 @@ static void C_GetNextVarType(int32_t type)
                 scriptWriteValue(WallLabels[labelNum].lId);
                 break;
             case STRUCT_PLAYER:
-                scriptWriteValue(PlayerLabels[labelNum].lId);
+                {
+                    auto const &label = PlayerLabels[labelNum];
 
-                if (PlayerLabels[labelNum].flags & LABEL_HASPARM2)
-                    C_GetNextVarType(0);
+                    scriptWriteValue(label.lId);
+
+                    Bassert((*varptr & (MAXGAMEVARS-1)) == g_structVarIDs + STRUCT_PLAYER);
+
+                    if (label.flags & LABEL_HASPARM2)
+                        C_GetNextVarType(0);
+                    else if (label.offset != -1 && (label.flags & LABEL_READFUNC) == 0)
+                        *varptr = (*varptr & ~(MAXGAMEVARS-1)) + g_structVarIDs + STRUCT_PLAYER_INTERNAL__;
+                }
                 break;
             case STRUCT_ACTORVAR:
             case STRUCT_PLAYERVAR:
@@ -1806,6 +1920,24 @@ static inline uint32_t C_Pow2IntLogBase2(int32_t const v)
     return r;
 }
 
+static void C_AddOptimizerCandidate(intptr_t const offset)
+{
+    g_optimizerCandidates.append(offset);
+}
+
+// Code from offset on is being thrown away.
+static void C_DiscardOptimizerCandidates(intptr_t const offset)
+{
+    size_t numKept = 0;
+
+    for (int32_t const candidate : g_optimizerCandidates)
+        if (candidate < offset)
+            g_optimizerCandidates[numKept++] = candidate;
+
+    while (g_optimizerCandidates.size() > numKept)
+        g_optimizerCandidates.removeLast();
+}
+
 static bool C_CheckMalformedBranch(intptr_t lastScriptPtr)
 {
     switch (C_GetKeyword())
@@ -1816,6 +1948,7 @@ static bool C_CheckMalformedBranch(intptr_t lastScriptPtr)
     case CON_ENDS:
     case CON_ELSE:
         g_scriptPtr = lastScriptPtr + apScript;
+        C_DiscardOptimizerCandidates(lastScriptPtr);
         g_skipBranch = true;
         C_ReportError(-1);
         g_warningCnt++;
@@ -1845,6 +1978,7 @@ static bool C_CheckEmptyBranch(int tw, intptr_t lastScriptPtr)
         C_ReportError(-1);
         g_warningCnt++;
         g_scriptPtr = lastScriptPtr + apScript;
+        C_DiscardOptimizerCandidates(lastScriptPtr);
         initprintf("%s:%d: warning: empty `%s' branch\n",g_scriptFileName,g_lineNumber,
                    VM_GetKeywordForID(*(g_scriptPtr) & VM_INSTMASK));
         scriptWriteAtOffset(CON_NULLOP | (IFELSE_MAGIC<<12), g_scriptPtr);
@@ -1877,6 +2011,9 @@ static int C_CountCaseStatements()
     g_caseTablePtr = apScript + casePtrOffset;
     g_scriptPtr    = apScript + scriptPtrOffset;
 
+    // the dry run's code gets overwritten by the case table and the real pass
+    C_DiscardOptimizerCandidates(scriptPtrOffset);
+
     return numCases;
 }
 
@@ -1901,6 +2038,7 @@ static void C_Include(const char *confile)
 
     mptr[len] = 0;
     g_scriptcrc = Bcrc32(mptr, len, g_scriptcrc);
+    C_CacheAddFile(confile, mptr, len);
 
     if (*textptr == '"') // skip past the closing quote if it's there so we don't screw up the next line
         textptr++;
@@ -2672,6 +2810,7 @@ DO_DEFSTATE:
             }
 
             Gv_NewVar(LAST_LABEL, defaultValue, varFlags);
+            C_CacheAddOp(CON_GAMEVAR, LAST_LABEL, defaultValue, varFlags, NULL);
             continue;
         }
 
@@ -2714,6 +2853,7 @@ DO_DEFSTATE:
             g_scriptPtr--;
 
             Gv_NewArray(arrayName, NULL, g_scriptPtr[-1], arrayFlags);
+            C_CacheAddOp(CON_GAMEARRAY, arrayName, g_scriptPtr[-1], arrayFlags, NULL);
 
             g_scriptPtr -= 2; // no need to save in script...
             continue;
@@ -3324,6 +3464,7 @@ DO_DEFSTATE:
                     else C_ParseCommand(0);
 
                     g_scriptPtr = tempscrptr;
+                    C_DiscardOptimizerCandidates(tempscrptr - apScript);
 
                     continue;
                 }
@@ -3347,6 +3488,7 @@ DO_DEFSTATE:
 
                 auto const tempscrptr = (intptr_t *) apScript+offset;
                 scriptWritePointer((intptr_t)g_scriptPtr, tempscrptr);
+                C_AddOptimizerCandidate(lastScriptPtr);
 
                 continue;
             }
@@ -3407,14 +3549,23 @@ DO_DEFSTATE:
         case CON_SETPLAYER:
         case CON_GETPLAYER:
             {
+                intptr_t * const ins = &g_scriptPtr[-1];
                 int const labelNum = C_GetStructureIndexes(1, &h_player);
 
                 if (labelNum == -1)
                     continue;
 
-                scriptWriteValue(PlayerLabels[labelNum].lId);
+                Bassert((*ins & VM_INSTMASK) == tw);
+
+                auto const &label = PlayerLabels[labelNum];
+                uint32_t const funcFlag = (tw == CON_GETPLAYER) ? LABEL_READFUNC : LABEL_WRITEFUNC;
+
+                if (label.offset != -1 && (label.flags & (funcFlag|LABEL_HASPARM2)) == 0)
+                    *ins = ((tw == CON_GETPLAYER) ? CON_GETPLAYERSTRUCT : CON_SETPLAYERSTRUCT) | LINE_NUMBER;
+
+                scriptWriteValue(label.lId);
 
-                if (PlayerLabels[labelNum].flags & LABEL_HASPARM2)
+                if (label.flags & LABEL_HASPARM2)
                     C_GetNextVar();
 
                 C_GetNextVarType((tw == CON_GETPLAYER) ? GAMEVAR_READONLY : 0);
@@ -3502,11 +3653,11 @@ DO_DEFSTATE:
                 if (label.offset != -1 && (label.flags & (LABEL_WRITEFUNC|LABEL_HASPARM2)) == 0)
                 {
                     if (labelNum >= ACTOR_SPRITEEXT_BEGIN)
-                        *ins = CON_SETSPRITEEXT;
+                        *ins = CON_SETSPRITEEXT | LINE_NUMBER;
                     else if (labelNum >= ACTOR_STRUCT_BEGIN)
-                        *ins = CON_SETACTORSTRUCT;
+                        *ins = CON_SETACTORSTRUCT | LINE_NUMBER;
                     else
-                        *ins = CON_SETSPRITESTRUCT;
+                        *ins = CON_SETSPRITESTRUCT | LINE_NUMBER;
                 }
 
                 scriptWriteValue(label.lId);
@@ -3533,11 +3684,17 @@ DO_DEFSTATE:
                 if (label.offset != -1 && (label.flags & (LABEL_READFUNC|LABEL_HASPARM2)) == 0)
                 {
                     if (labelNum >= ACTOR_SPRITEEXT_BEGIN)
-                        *ins = CON_GETSPRITEEXT;
+                        *ins = CON_GETSPRITEEXT | LINE_NUMBER;
                     else if (labelNum >= ACTOR_STRUCT_BEGIN)
-                        *ins = CON_GETACTORSTRUCT;
+                        *ins = CON_GETACTORSTRUCT | LINE_NUMBER;
                     else
-                        *ins = CON_GETSPRITESTRUCT;
+                    {
+                        *ins = CON_GETSPRITESTRUCT | LINE_NUMBER;
+
+                        // in a block, whatever follows is always executed next
+                        if (loop)
+                            C_AddOptimizerCandidate(ins - apScript);
+                    }
                 }
 
                 scriptWriteValue(label.lId);
@@ -3694,6 +3851,7 @@ DO_DEFSTATE:
                     initprintf("Using dynamic tile remapping\n");
 #endif
             g_dynamicTileMapping = 1;
+            g_scriptCacheable = false;
 #else
             else
             {
@@ -3717,6 +3875,7 @@ DO_DEFSTATE:
 #endif
 
             g_dynamicSoundMapping = 1;
+            g_scriptCacheable = false;
 #else
             {
                 initprintf("%s:%d: warning: dynamic sound remapping is disabled in this build\n",g_scriptFileName,g_lineNumber);
@@ -4437,6 +4596,8 @@ ifvar:
 
                 if (tw != CON_WHILEVARN && tw != CON_WHILEVARL)
                 {
+                    C_AddOptimizerCandidate(lastScriptPtr);
+
                     j = C_GetKeyword();
 
                     if (j == CON_ELSE || j == CON_LEFTBRACE)
@@ -5224,6 +5385,7 @@ repeatcase:
             }
             gamefunctions[j][i] = '\0';
             hash_add(&h_gamefuncs,gamefunctions[j],j,0);
+            g_scriptCacheable = false;
             {
                 char *str = Bstrtolower(Xstrdup(gamefunctions[j]));
                 hash_add(&h_gamefuncs,str,j,0);
@@ -5248,6 +5410,7 @@ repeatcase:
             }
 
             gamefunctions[j][0] = '\0';
+            g_scriptCacheable = false;
 
             continue;
 
@@ -5319,6 +5482,7 @@ repeatcase:
                 gamename[i] = '\0';
                 g_gameNamePtr = Xstrdup(gamename);
                 G_UpdateAppTitle();
+                g_scriptCacheable = false;
             }
             continue;
 
@@ -5336,6 +5500,7 @@ repeatcase:
                 tempbuf[j] = '\0';
 
                 C_SetDefName(tempbuf);
+                g_scriptCacheable = false;
             }
             continue;
 
@@ -5353,6 +5518,7 @@ repeatcase:
                 tempbuf[j] = '\0';
 
                 C_SetCfgName(tempbuf);
+                g_scriptCacheable = false;
             }
             continue;
 
@@ -5910,6 +6076,7 @@ repeatcase:
                 */
 
                 G_DoGameStartup(params);
+                C_CacheAddOp(CON_GAMESTARTUP, NULL, 0, 0, params);
             }
             continue;
         }
@@ -6173,6 +6340,833 @@ void scriptInitTables()
         inthash_add(&h_actorvar, actorvar.x, actorvar.y, 0);
 }
 
+// Operands of the ifvar family and of getactor that are a plain gamevar take a
+// single word. Array and struct accesses take more.
+static FORCE_INLINE bool C_IsPlainVar(intptr_t const var)
+{
+    return (unsigned)(var & ~GV_FLAG_NEGATIVE) < (unsigned)g_gameVarCount;
+}
+
+// Same tests as the VM makes for the ifvar family, on constant operands.
+static int C_FoldCondition(int const opcode, int const lValue, intptr_t const rValue)
+{
+    native_t const tw = lValue;
+
+    switch (opcode)
+    {
+        case CON_IFVARA:      return (uint32_t)tw > (uint32_t)rValue;
+        case CON_IFVARAE:     return (uint32_t)tw >= (uint32_t)rValue;
+        case CON_IFVARAND:    return (tw & rValue) != 0;
+        case CON_IFVARB:      return (uint32_t)tw < (uint32_t)rValue;
+        case CON_IFVARBE:     return (uint32_t)tw <= (uint32_t)rValue;
+        case CON_IFVARBOTH:   return tw && rValue;
+        case CON_IFVARE:      return tw == rValue;
+        case CON_IFVAREITHER: return tw || rValue;
+        case CON_IFVARG:      return tw > rValue;
+        case CON_IFVARGE:     return tw >= rValue;
+        case CON_IFVARL:      return tw < rValue;
+        case CON_IFVARLE:     return tw <= rValue;
+        case CON_IFVARN:      return tw != rValue;
+        case CON_IFVAROR:     return (tw | rValue) != 0;
+        case CON_IFVARXOR:    return (tw ^ rValue) != 0;
+    }
+
+    return -1;
+}
+
+static void C_RewriteInstruction(intptr_t *ins, int const opcode)
+{
+    if (g_scriptDebug > 1)
+        initprintf("%d: %s -> %s\n", (int32_t)(*ins >> 12), VM_GetKeywordForID(*ins & VM_INSTMASK), VM_GetKeywordForID(opcode));
+
+    *ins = (*ins & ~VM_INSTMASK) | opcode;
+}
+
+// Peephole pass over the compiled script, run once it is complete. Nothing is
+// inserted, removed or moved: instructions are only rewritten in place, so
+// every offset and pointer into the script stays valid, and the words of all
+// instructions, fused ones included, keep their line numbers for error
+// reports and VM_ScriptInfo(). The second instruction of a fused pair is left
+// as it was, in case something jumps to it directly.
+static void C_OptimizeScript(void)
+{
+    int numFolded = 0, numFused = 0, numThreaded = 0;
+
+    // [getactor] [sprite var] [label] [var], then an ifvar on that var
+    for (int32_t const offset : g_optimizerCandidates)
+    {
+        intptr_t *const ins = apScript + offset;
+
+        if ((*ins & VM_INSTMASK) != CON_GETSPRITESTRUCT || !C_IsPlainVar(ins[1]) || !C_IsPlainVar(ins[3]))
+            continue;
+
+        intptr_t const *const next = &ins[4];
+
+        if (next[1] != ins[3])
+            continue;
+
+        int opcode;
+
+        switch (*next & VM_INSTMASK)
+        {
+            case CON_IFVARE: case CON_IFVARE_GLOBAL: opcode = CON_GETSPRITESTRUCT_IFVARE; break;
+            case CON_IFVARN: case CON_IFVARN_GLOBAL: opcode = CON_GETSPRITESTRUCT_IFVARN; break;
+            case CON_IFVARL: case CON_IFVARL_GLOBAL: opcode = CON_GETSPRITESTRUCT_IFVARL; break;
+            case CON_IFVARG: case CON_IFVARG_GLOBAL: opcode = CON_GETSPRITESTRUCT_IFVARG; break;
+            default: continue;
+        }
+
+        C_RewriteInstruction(ins, opcode);
+        numFused++;
+    }
+
+    for (int32_t const offset : g_optimizerCandidates)
+    {
+        intptr_t *const ins = apScript + offset;
+        int const opcode = *ins & VM_INSTMASK;
+
+        if (opcode == CON_ELSE)
+        {
+            // An else reached by running off the end of the true branch only
+            // jumps over its own branch. Where that lands on another else or
+            // on a nullop, go straight to where those lead.
+            auto target = (intptr_t *)ins[1];
+
+            while (target < g_scriptPtr && (*target >> 12) != 0)
+            {
+                if ((*target & VM_INSTMASK) == CON_ELSE)
+                    target = (intptr_t *)target[1];
+                else if ((*target & VM_INSTMASK) == CON_NULLOP)
+                    target++;
+                else
+                    break;
+            }
+
+            if (target != (intptr_t *)ins[1])
+            {
+                ins[1] = (intptr_t)target;
+                numThreaded++;
+            }
+            continue;
+        }
+
+        if (ins[1] == GV_FLAG_CONSTANT)
+        {
+            // ifvar <constant> <constant>: [opcode] [GV_FLAG_CONSTANT] [lValue] [rValue] [fail]
+            int const result = C_FoldCondition(opcode, ins[2], ins[3]);
+
+            if (result == -1)
+                continue;
+
+            ins[3] = result;
+            C_RewriteInstruction(ins, CON_IFCONST);
+            numFolded++;
+            continue;
+        }
+
+        // [opcode] [var] [value] [fail] with a true branch of nothing but
+        // [setvar] [var] [value], directly followed by where fail points
+        if (!C_IsPlainVar(ins[1]) || (intptr_t *)ins[3] != &ins[7] || !C_IsPlainVar(ins[5]))
+            continue;
+
+        int const bodyOpcode = ins[4] & VM_INSTMASK;
+
+        if (bodyOpcode != CON_SETVAR && bodyOpcode != CON_SETVAR_GLOBAL)
+            continue;
+
+        switch (opcode)
+        {
+            case CON_IFVARE: C_RewriteInstruction(ins, CON_IFVARE_SETVAR); break;
+            case CON_IFVARN: C_RewriteInstruction(ins, CON_IFVARN_SETVAR); break;
+            case CON_IFVARE_GLOBAL: C_RewriteInstruction(ins, CON_IFVARE_GLOBAL_SETVAR); break;
+            case CON_IFVARN_GLOBAL: C_RewriteInstruction(ins, CON_IFVARN_GLOBAL_SETVAR); break;
+            default: continue;
+        }
+
+        numFused++;
+    }
+
+    g_optimizerCandidates.clear();
+
+    if (g_scriptDebug)
+        initprintf("Optimized script: %d conditions folded, %d instruction pairs fused, %d jumps threaded\n",
+                   numFolded, numFused, numThreaded);
+}
+
+static void C_CacheHeader(scriptcacheheader_t *h)
+{
+    Bmemset(h, 0, sizeof(scriptcacheheader_t));
+    Bmemcpy(h->magic, s_scriptCacheMagic, sizeof(h->magic));
+    h->version     = SCRIPTCACHE_VERSION;
+    h->ptrsize     = sizeof(intptr_t);
+    h->byteversion = BYTEVERSION;
+    Bstrncpyz(h->buildrev, s_buildRev, sizeof(h->buildrev));
+    Bstrncpyz(h->buildtime, s_buildTimestamp, sizeof(h->buildtime));
+    h->modulecrc = g_scriptCacheModuleCRC;
+}
+
+typedef struct
+{
+    uint8_t *data;
+    size_t   size, capacity;
+} scriptcachebuf_t;
+
+static void C_CachePut(scriptcachebuf_t *b, void const *src, size_t len)
+{
+    if (b->size + len > b->capacity)
+    {
+        b->capacity = max(b->capacity * 2, b->size + len);
+        b->data     = (uint8_t *)Xrealloc(b->data, b->capacity);
+    }
+
+    Bmemcpy(b->data + b->size, src, len);
+    b->size += len;
+}
+
+static void C_CachePutInt(scriptcachebuf_t *b, int32_t const value) { C_CachePut(b, &value, sizeof(value)); }
+
+// NULL is stored as length -1
+static void C_CachePutString(scriptcachebuf_t *b, char const *str)
+{
+    int32_t const len = str ? Bstrlen(str) : -1;
+
+    C_CachePutInt(b, len);
+
+    if (len > 0)
+        C_CachePut(b, str, len);
+}
+
+typedef struct
+{
+    uint8_t const *ptr, *end;
+} scriptcachereader_t;
+
+// The body was checked against its CRC before anything is read from it, so
+// running past its end means it was written by something else entirely.
+static void C_CacheGet(scriptcachereader_t *r, void *dst, size_t len)
+{
+    if (EDUKE32_PREDICT_FALSE(len > (size_t)(r->end - r->ptr)))
+        G_GameExit("Compiled script cache " SCRIPTCACHE_FILENAME " is corrupt, please delete it.");
+
+    Bmemcpy(dst, r->ptr, len);
+    r->ptr += len;
+}
+
+static int32_t C_CacheGetInt(scriptcachereader_t *r)
+{
+    int32_t value;
+    C_CacheGet(r, &value, sizeof(value));
+    return value;
+}
+
+static char *C_CacheGetString(scriptcachereader_t *r, size_t const minsize)
+{
+    int32_t const len = C_CacheGetInt(r);
+
+    if (len < 0)
+        return NULL;
+
+    auto str = (char *)Xcalloc(max<size_t>(len + 1, minsize), 1);
+    C_CacheGet(r, str, len);
+
+    return str;
+}
+
+static void C_WriteScriptCache(void)
+{
+    if (!g_scriptCacheable || g_scriptCacheMode == SCRIPTCACHE_OFF || g_loadFromGroupOnly)
+        return;
+
+    scriptcachebuf_t body = { NULL, 0, 0 };
+    int32_t const scriptLen = g_scriptPtr - apScript;
+
+    C_CachePutInt(&body, g_scriptcrc);
+    C_CachePutInt(&body, g_scriptVersion);
+    C_CachePutInt(&body, g_totalLines);
+    C_CachePutInt(&body, g_scriptSize);
+    C_CachePutInt(&body, scriptLen);
+
+    // the same relocation C_SetScriptSize() does before moving the script
+    for (int i = 0; i < g_scriptSize; ++i)
+    {
+        intptr_t const word = BITPTR_IS_POINTER(i) ? apScript[i] - (intptr_t)apScript : apScript[i];
+        C_CachePut(&body, &word, sizeof(word));
+    }
+
+    C_CachePut(&body, bitptr, ((g_scriptSize + 7) >> 3) + 1);
+
+    C_CachePutInt(&body, g_labelCnt);
+    C_CachePut(&body, label, g_labelCnt << 6);
+    C_CachePut(&body, labelcode, g_labelCnt * sizeof(int32_t));
+    C_CachePut(&body, labeltype, g_labelCnt * sizeof(int32_t));
+
+    C_CachePut(&body, apScriptEvents, sizeof(apScriptEvents));
+
+    C_CachePutInt(&body, g_scriptCacheOps.size());
+    for (auto const &op : g_scriptCacheOps)
+        C_CachePut(&body, &op, sizeof(op));
+
+    G_Util_PtrToIdx2(&g_tile[0].execPtr, MAXTILES, sizeof(tiledata_t), apScript, P2I_FWD_NON0);
+    G_Util_PtrToIdx2(&g_tile[0].loadPtr, MAXTILES, sizeof(tiledata_t), apScript, P2I_FWD_NON0);
+    C_CachePut(&body, g_tile, sizeof(g_tile));
+    G_Util_PtrToIdx2(&g_tile[0].execPtr, MAXTILES, sizeof(tiledata_t), apScript, P2I_BACK_NON0);
+    G_Util_PtrToIdx2(&g_tile[0].loadPtr, MAXTILES, sizeof(tiledata_t), apScript, P2I_BACK_NON0);
+
+    for (int i = 0; i < MAXTILES; i++)
+        if (g_tile[i].proj)
+        {
+            C_CachePutInt(&body, i);
+            C_CachePut(&body, g_tile[i].proj, 2 * sizeof(projectile_t));
+        }
+    C_CachePutInt(&body, -1);
+
+    for (int i = 0; i < MAXQUOTES; i++)
+        if (apStrings[i])
+        {
+            C_CachePutInt(&body, i);
+            C_CachePutString(&body, apStrings[i]);
+        }
+    C_CachePutInt(&body, -1);
+
+    C_CachePutInt(&body, g_numXStrings);
+    for (int i = 0; i < g_numXStrings; i++)
+        C_CachePutString(&body, apXStrings[i]);
+
+    for (auto const &map : g_mapInfo)
+    {
+        C_CachePutInt(&body, map.partime);
+        C_CachePutInt(&body, map.designertime);
+        C_CachePutString(&body, map.name);
+        C_CachePutString(&body, map.filename);
+        C_CachePutString(&body, map.musicfn);
+    }
+
+    for (int i = 0; i < MAXSOUNDS; i++)
+        if (g_sounds[i].filename)
+        {
+            sound_t const &snd = g_sounds[i];
+
+            C_CachePutInt(&body, i);
+            C_CachePutString(&body, snd.filename);
+            C_CachePut(&body, &snd.volume, sizeof(snd.volume));
+            C_CachePutInt(&body, snd.ps);
+            C_CachePutInt(&body, snd.pe);
+            C_CachePutInt(&body, snd.vo);
+            C_CachePutInt(&body, snd.pr);
+            C_CachePutInt(&body, snd.m);
+        }
+    C_CachePutInt(&body, -1);
+    C_CachePutInt(&body, g_highestSoundIdx);
+
+    C_CachePut(&body, g_volumeNames, sizeof(g_volumeNames));
+    C_CachePut(&body, g_volumeFlags, sizeof(g_volumeFlags));
+    C_CachePutInt(&body, g_volumeCnt);
+    C_CachePut(&body, g_skillNames, sizeof(g_skillNames));
+    C_CachePutInt(&body, g_skillCnt);
+    C_CachePut(&body, g_gametypeNames, sizeof(g_gametypeNames));
+    C_CachePut(&body, g_gametypeFlags, sizeof(g_gametypeFlags));
+    C_CachePutInt(&body, g_gametypeCnt);
+    C_CachePut(&body, CheatStrings, sizeof(CheatStrings));
+    C_CachePut(&body, CheatKeys, sizeof(CheatKeys));
+
+    scriptcacheheader_t h;
+    C_CacheHeader(&h);
+    h.numfiles = g_scriptCacheFiles.size();
+    h.bodylen  = body.size;
+    h.bodycrc  = Bcrc32(body.data, body.size, 0);
+
+    char fn[BMAX_PATH];
+    BFILE *fp = NULL;
+
+    if (!G_ModDirSnprintf(fn, sizeof(fn), SCRIPTCACHE_FILENAME))
+        fp = Bfopen(fn, "wb");
+
+    if (fp)
+    {
+        bool const ok = Bfwrite(&h, sizeof(h), 1, fp) == 1
+                        && Bfwrite(g_scriptCacheFiles.begin(), sizeof(scriptcachefile_t), h.numfiles, fp) == (size_t)h.numfiles
+                        && Bfwrite(body.data, body.size, 1, fp) == 1;
+        Bfclose(fp);
+
+        if (!ok)
+        {
+            initprintf("Failed writing compiled script cache %s\n", fn);
+            unlink(fn);
+        }
+    }
+
+    Bfree(body.data);
+}
+
+// Returns true if the script was loaded from the cache. Nothing is changed
+// unless the cache matches this build and every file it was compiled from.
+static bool C_ReadScriptCache(char const *fileName)
+{
+    if (g_scriptCacheMode == SCRIPTCACHE_OFF || g_loadFromGroupOnly || g_scriptDebug)
+        return false;
+
+    char fn[BMAX_PATH];
+
+    if (G_ModDirSnprintf(fn, sizeof(fn), SCRIPTCACHE_FILENAME))
+        return false;
+
+    BFILE *const fp = Bfopen(fn, "rb");
+
+    if (!fp)
+        return false;
+
+    scriptcacheheader_t h, cur;
+    C_CacheHeader(&cur);
+
+    scriptcachefile_t *files = NULL;
+    uint8_t *body = NULL;
+    bool valid = Bfread(&h, sizeof(h), 1, fp) == 1 && h.numfiles > 0 && h.bodylen > 0;
+
+    // everything but the counts and the CRC of the body has to match
+    if (valid)
+    {
+        cur.numfiles = h.numfiles;
+        cur.bodylen  = h.bodylen;
+        cur.bodycrc  = h.bodycrc;
+        valid = !Bmemcmp(&h, &cur, sizeof(h));
+    }
+
+    if (valid)
+    {
+        files = (scriptcachefile_t *)Xmalloc(h.numfiles * sizeof(scriptcachefile_t));
+        valid = Bfread(files, sizeof(scriptcachefile_t), h.numfiles, fp) == (size_t)h.numfiles
+                && !Bstrcmp(files[0].filename, fileName);
+    }
+
+    for (int i = 0; valid && i < h.numfiles; i++)
+    {
+        int32_t const kFile = kopen4loadfrommod(files[i].filename, 0);
+
+        if (kFile < 0)
+        {
+            valid = false;
+            break;
+        }
+
+        int32_t const len = kfilelength(kFile);
+
+        if (len == files[i].length)
+        {
+            auto data = (char *)Xmalloc(len);
+            valid = kread(kFile, data, len) == len && Bcrc32(data, len, 0) == files[i].crc;
+            Bfree(data);
+        }
+        else valid = false;
+
+        kclose(kFile);
+    }
+
+    if (valid)
+    {
+        body  = (uint8_t *)Xmalloc(h.bodylen);
+        valid = Bfread(body, h.bodylen, 1, fp) == 1 && Bcrc32(body, h.bodylen, 0) == h.bodycrc;
+    }
+
+    Bfclose(fp);
+    Bfree(files);
+
+    if (!valid)
+    {
+        Bfree(body);
+        return false;
+    }
+
+    scriptcachereader_t r = { body, body + h.bodylen };
+
+    g_scriptcrc  = C_CacheGetInt(&r);
+
+    int32_t const scriptVersion = C_CacheGetInt(&r);
+
+    g_totalLines = C_CacheGetInt(&r);
+    g_scriptSize = C_CacheGetInt(&r);
+
+    int32_t const scriptLen = C_CacheGetInt(&r);
+
+    Bfree(apScript);
+    Bfree(bitptr);
+
+    apScript    = (intptr_t *)Xmalloc(g_scriptSize * sizeof(intptr_t));
+    bitptr      = (char *)Xmalloc(((g_scriptSize + 7) >> 3) + 1);
+    g_scriptPtr = apScript + scriptLen;
+
+    C_CacheGet(&r, apScript, g_scriptSize * sizeof(intptr_t));
+    C_CacheGet(&r, bitptr, ((g_scriptSize + 7) >> 3) + 1);
+
+    for (int i = 0; i < g_scriptSize; ++i)
+        if (BITPTR_IS_POINTER(i))
+            apScript[i] += (intptr_t)apScript;
+
+    g_labelCnt = C_CacheGetInt(&r);
+
+    if ((uint32_t)g_labelCnt > MAXSPRITES*sizeof(spritetype)/64)
+        G_GameExit("Error: too many labels defined!");
+
+    C_CacheGet(&r, label, g_labelCnt << 6);
+    C_CacheGet(&r, labelcode, g_labelCnt * sizeof(int32_t));
+    C_CacheGet(&r, labeltype, g_labelCnt * sizeof(int32_t));
+
+    C_CacheGet(&r, apScriptEvents, sizeof(apScriptEvents));
+
+    for (int i = C_CacheGetInt(&r); i > 0; i--)
+    {
+        scriptcacheop_t op;
+        C_CacheGet(&r, &op, sizeof(op));
+
+        switch (op.type)
+        {
+            case CON_GAMEVAR: Gv_NewVar(op.label, op.value, op.flags); break;
+            case CON_GAMEARRAY: Gv_NewArray(op.label, NULL, op.value, op.flags); break;
+            case CON_GAMESTARTUP:
+                g_scriptVersion = op.version;
+                G_DoGameStartup(op.params);
+                break;
+        }
+    }
+
+    g_scriptVersion = scriptVersion;
+
+    C_CacheGet(&r, g_tile, sizeof(g_tile));
+    G_Util_PtrToIdx2(&g_tile[0].execPtr, MAXTILES, sizeof(tiledata_t), apScript, P2I_BACK_NON0);
+    G_Util_PtrToIdx2(&g_tile[0].loadPtr, MAXTILES, sizeof(tiledata_t), apScript, P2I_BACK_NON0);
+
+    for (auto &tile : g_tile)
+        tile.proj = tile.defproj = NULL;
+
+    for (int i; (i = C_CacheGetInt(&r)) >= 0;)
+    {
+        C_AllocProjectile(i);
+        C_CacheGet(&r, g_tile[i].proj, 2 * sizeof(projectile_t));
+    }
+
+    for (int i; (i = C_CacheGetInt(&r)) >= 0;)
+    {
+        char *const str = C_CacheGetString(&r, MAXQUOTELEN);
+        C_AllocQuote(i);
+        Bstrncpyz(apStrings[i], str, MAXQUOTELEN);
+        Bfree(str);
+    }
+
+    g_numXStrings = C_CacheGetInt(&r);
+    for (int i = 0; i < g_numXStrings; i++)
+    {
+        Bfree(apXStrings[i]);
+        apXStrings[i] = C_CacheGetString(&r, MAXQUOTELEN);
+    }
+
+    for (auto &map : g_mapInfo)
+    {
+        map.partime      = C_CacheGetInt(&r);
+        map.designertime = C_CacheGetInt(&r);
+        Bfree(map.name);
+        map.name = C_CacheGetString(&r, 0);
+        Bfree(map.filename);
+        map.filename = C_CacheGetString(&r, 0);
+        Bfree(map.musicfn);
+        map.musicfn = C_CacheGetString(&r, 0);
+    }
+
+    for (int i; (i = C_CacheGetInt(&r)) >= 0;)
+    {
+        sound_t &snd = g_sounds[i];
+
+        Bfree(snd.filename);
+        snd.filename = C_CacheGetString(&r, BMAX_PATH);
+        C_CacheGet(&r, &snd.volume, sizeof(snd.volume));
+        snd.ps = C_CacheGetInt(&r);
+        snd.pe = C_CacheGetInt(&r);
+        snd.vo = C_CacheGetInt(&r);
+        snd.pr = C_CacheGetInt(&r);
+        snd.m  = C_CacheGetInt(&r);
+    }
+    g_highestSoundIdx = C_CacheGetInt(&r);
+
+    C_CacheGet(&r, g_volumeNames, sizeof(g_volumeNames));
+    C_CacheGet(&r, g_volumeFlags, sizeof(g_volumeFlags));
+    g_volumeCnt = C_CacheGetInt(&r);
+    C_CacheGet(&r, g_skillNames, sizeof(g_skillNames));
+    g_skillCnt = C_CacheGetInt(&r);
+    C_CacheGet(&r, g_gametypeNames, sizeof(g_gametypeNames));
+    C_CacheGet(&r, g_gametypeFlags, sizeof(g_gametypeFlags));
+    g_gametypeCnt = C_CacheGetInt(&r);
+    C_CacheGet(&r, CheatStrings, sizeof(CheatStrings));
+    C_CacheGet(&r, CheatKeys, sizeof(CheatKeys));
+
+    Bfree(body);
+
+    return true;
+}
+
+// -concachecheck loads the cache, takes a snapshot of what it produced, throws
+// that away and compiles as usual. The snapshot of the compiled result has to
+// be identical, section by section.
+
+enum
+{
+    SCS_COUNTS,
+    SCS_SCRIPT,
+    SCS_BITPTR,
+    SCS_LABELS,
+    SCS_EVENTS,
+    SCS_TILES,
+    SCS_PROJECTILES,
+    SCS_GAMEVARS,
+    SCS_GAMEARRAYS,
+    SCS_STARTUP,
+    SCS_NUM
+};
+
+typedef struct
+{
+    char    name[64];
+    int32_t code, type;
+} scriptchecklabel_t;
+
+typedef struct
+{
+    int32_t      tile;
+    projectile_t proj[2];
+} scriptcheckprojectile_t;
+
+typedef struct
+{
+    char     label[MAXVARLABEL];
+    uint32_t flags;
+    intptr_t defaultValue, value;
+} scriptcheckvar_t;
+
+typedef struct
+{
+    char     label[MAXARRAYLABEL];
+    uint32_t flags;
+    intptr_t size;
+} scriptcheckarray_t;
+
+// named sections start each record with its label
+static struct
+{
+    char const *name;
+    size_t      recordsize;
+    bool        named;
+} const s_scriptCheckSections[SCS_NUM] = {
+    { "counts",      sizeof(int32_t),                 false },
+    { "script",      sizeof(intptr_t),                false },
+    { "bitptr",      sizeof(char),                    false },
+    { "labels",      sizeof(scriptchecklabel_t),      true },
+    { "events",      sizeof(intptr_t),                false },
+    { "tiledata",    sizeof(tiledata_t),              false },
+    { "projectiles", sizeof(scriptcheckprojectile_t), false },
+    { "gamevars",    sizeof(scriptcheckvar_t),        true },
+    { "gamearrays",  sizeof(scriptcheckarray_t),      true },
+    { "gamestartup", sizeof(int32_t),                 false },
+};
+
+#define SCRIPTCHECK_MAXSTARTUP 64
+
+// Every field G_DoGameStartup() can set.
+static void C_CopyStartupValues(int32_t *values, bool const restore)
+{
+    auto &p0 = *g_player[0].ps;
+    int j = 0;
+
+#define STARTUPVALUE(x) do { if (restore) x = values[j]; else values[j] = x; j++; } while (0)
+    STARTUPVALUE(ud.const_visibility);
+    STARTUPVALUE(g_impactDamage);
+    STARTUPVALUE(p0.max_shield_amount);
+    STARTUPVALUE(p0.max_player_health);
+    STARTUPVALUE(g_maxPlayerHealth);
+    STARTUPVALUE(g_startArmorAmount);
+    STARTUPVALUE(g_actorRespawnTime);
+    STARTUPVALUE(g_itemRespawnTime);
+    STARTUPVALUE(g_playerFriction);
+    STARTUPVALUE(g_spriteGravity);
+    STARTUPVALUE(g_rpgRadius);
+    STARTUPVALUE(g_pipebombRadius);
+    STARTUPVALUE(g_shrinkerRadius);
+    STARTUPVALUE(g_tripbombRadius);
+    STARTUPVALUE(g_morterRadius);
+    STARTUPVALUE(g_bouncemineRadius);
+    STARTUPVALUE(g_seenineRadius);
+    for (auto &ammo : p0.max_ammo_amount)
+        STARTUPVALUE(ammo);
+    STARTUPVALUE(g_damageCameras);
+    STARTUPVALUE(g_numFreezeBounces);
+    STARTUPVALUE(g_freezerSelfDamage);
+    STARTUPVALUE(g_deleteQueueSize);
+    STARTUPVALUE(g_tripbombLaserMode);
+#undef STARTUPVALUE
+
+    Bassert(j <= SCRIPTCHECK_MAXSTARTUP);
+}
+
+static void C_SnapshotScript(scriptcachebuf_t *s)
+{
+    int32_t const counts[] = { g_scriptSize,    (int32_t)(g_scriptPtr - apScript), g_labelCnt,
+                               g_gameVarCount, g_gameArrayCount,                  g_scriptVersion };
+    C_CachePut(&s[SCS_COUNTS], counts, sizeof(counts));
+
+    for (int i = 0; i < g_scriptSize; ++i)
+    {
+        intptr_t const word = BITPTR_IS_POINTER(i) ? apScript[i] - (intptr_t)apScript : apScript[i];
+        C_CachePut(&s[SCS_SCRIPT], &word, sizeof(word));
+    }
+
+    C_CachePut(&s[SCS_BITPTR], bitptr, ((g_scriptSize + 7) >> 3) + 1);
+
+    for (int i = 0; i < g_labelCnt; i++)
+    {
+        scriptchecklabel_t l;
+
+        Bmemset(&l, 0, sizeof(l));
+        Bstrncpyz(l.name, label + (i << 6), sizeof(l.name));
+        l.code = labelcode[i];
+        l.type = labeltype[i];
+
+        C_CachePut(&s[SCS_LABELS], &l, sizeof(l));
+    }
+
+    C_CachePut(&s[SCS_EVENTS], apScriptEvents, sizeof(apScriptEvents));
+
+    G_Util_PtrToIdx2(&g_tile[0].execPtr, MAXTILES, sizeof(tiledata_t), apScript, P2I_FWD_NON0);
+    G_Util_PtrToIdx2(&g_tile[0].loadPtr, MAXTILES, sizeof(tiledata_t), apScript, P2I_FWD_NON0);
+
+    for (auto const &tile : g_tile)
+    {
+        tiledata_t t = tile;
+        t.proj = t.defproj = NULL;
+        C_CachePut(&s[SCS_TILES], &t, sizeof(t));
+    }
+
+    G_Util_PtrToIdx2(&g_tile[0].execPtr, MAXTILES, sizeof(tiledata_t), apScript, P2I_BACK_NON0);
+    G_Util_PtrToIdx2(&g_tile[0].loadPtr, MAXTILES, sizeof(tiledata_t), apScript, P2I_BACK_NON0);
+
+    for (int i = 0; i < MAXTILES; i++)
+        if (g_tile[i].proj)
+        {
+            scriptcheckprojectile_t p;
+
+            Bmemset(&p, 0, sizeof(p));
+            p.tile = i;
+            Bmemcpy(p.proj, g_tile[i].proj, sizeof(p.proj));
+
+            C_CachePut(&s[SCS_PROJECTILES], &p, sizeof(p));
+        }
+
+    for (int i = 0; i < g_gameVarCount; i++)
+    {
+        gamevar_t const &var = aGameVars[i];
+        scriptcheckvar_t v;
+
+        Bmemset(&v, 0, sizeof(v));
+        if (var.szLabel)
+            Bstrncpyz(v.label, var.szLabel, sizeof(v.label));
+        v.flags        = var.flags & ~GAMEVAR_RESET;
+        v.defaultValue = var.defaultValue;
+
+        if (var.flags & GAMEVAR_USER_MASK)
+            v.value = var.pValues ? var.pValues[0] : 0;
+        else
+            v.value = var.global;
+
+        C_CachePut(&s[SCS_GAMEVARS], &v, sizeof(v));
+    }
+
+    for (int i = 0; i < g_gameArrayCount; i++)
+    {
+        gamearray_t const &array = aGameArrays[i];
+        scriptcheckarray_t a;
+
+        Bmemset(&a, 0, sizeof(a));
+        if (array.szLabel)
+            Bstrncpyz(a.label, array.szLabel, sizeof(a.label));
+        a.flags = array.flags & ~GAMEARRAY_RESET;
+        a.size  = array.size;
+
+        C_CachePut(&s[SCS_GAMEARRAYS], &a, sizeof(a));
+    }
+
+    int32_t startup[SCRIPTCHECK_MAXSTARTUP];
+    Bmemset(startup, 0, sizeof(startup));
+    C_CopyStartupValues(startup, false);
+    C_CachePut(&s[SCS_STARTUP], startup, sizeof(startup));
+}
+
+static void C_FreeSnapshot(scriptcachebuf_t *s)
+{
+    for (int i = 0; i < SCS_NUM; i++)
+        DO_FREE_AND_NULL(s[i].data);
+}
+
+// Undoes everything C_ReadScriptCache() did that the compiler doesn't simply
+// overwrite, so the compile starts from the same state it would have without it.
+static void C_DiscardCachedScript(int32_t *startupValues, int32_t const scriptVersion)
+{
+    Bmemset(apScriptEvents, 0, sizeof(apScriptEvents));
+
+    for (int i = 0; i < MAXTILES; i++)
+        C_FreeProjectile(i);
+
+    for (auto &tile : g_tile)
+        Bmemset(&tile, 0, sizeof(tiledata_t));
+
+    DO_FREE_AND_NULL(bitptr);
+
+    Gv_Reinit();
+    C_CopyStartupValues(startupValues, true);
+    g_scriptVersion = scriptVersion;
+}
+
+// Returns the number of sections that differ.
+static int C_CompareSnapshots(scriptcachebuf_t const *cached, scriptcachebuf_t const *compiled)
+{
+    int numDiffering = 0;
+
+    for (int i = 0; i < SCS_NUM; i++)
+    {
+        scriptcachebuf_t const &a = cached[i], &b = compiled[i];
+
+        if (a.size == b.size && (a.size == 0 || !Bmemcmp(a.data, b.data, a.size)))
+            continue;
+
+        numDiffering++;
+
+        size_t const recSize = s_scriptCheckSections[i].recordsize;
+        size_t const numA = a.size / recSize, numB = b.size / recSize;
+        size_t j = 0;
+
+        while (j < min(numA, numB) && !Bmemcmp(a.data + j * recSize, b.data + j * recSize, recSize))
+            j++;
+
+        initprintf("%s: %s differ at record %d (%d cached, %d compiled)", SCRIPTCACHE_FILENAME,
+                   s_scriptCheckSections[i].name, (int)j, (int)numA, (int)numB);
+
+        if (s_scriptCheckSections[i].named && (j < numA || j < numB))
+            initprintf(" `%s'", (char const *)(j < numB ? b.data : a.data) + j * recSize);
+
+        initprintf("\n");
+    }
+
+    return numDiffering;
+}
+
+static void C_FreeCompilerTables(void)
+{
+    for (auto i : tables_free)
+        hash_free(i);
+
+    inthash_free(&h_varvar);
+    inthash_free(&h_globalvar);
+    inthash_free(&h_playervar);
+    inthash_free(&h_actorvar);
+
+    freehashnames();
+    freesoundhashnames();
+}
+
 void C_Compile(const char *fileName)
 {
     Bmemset(apScriptEvents, 0, sizeof(apScriptEvents));
@@ -6217,12 +7211,55 @@ void C_Compile(const char *fileName)
 
     int const kFileLen = kfilelength(kFile);
 
-    initprintf("Compiling: %s (%d bytes)\n", fileName, kFileLen);
+    g_scriptCacheFiles.clear();
+    g_scriptCacheOps.clear();
+    g_scriptCacheable = true;
+    g_scriptCacheModuleCRC = 0;
 
-    g_logFlushWindow = 0;
+    for (char const *m : g_scriptModules)
+        g_scriptCacheModuleCRC = Bcrc32(m, Bstrlen(m) + 1, g_scriptCacheModuleCRC);
 
     uint32_t const startcompiletime = timerGetTicks();
 
+    bool const checkCache = (g_scriptCacheMode == SCRIPTCACHE_CHECK);
+    scriptcachebuf_t cached[SCS_NUM];
+    int32_t startupValues[SCRIPTCHECK_MAXSTARTUP];
+    int32_t const initialVersion = g_scriptVersion;
+
+    Bmemset(cached, 0, sizeof(cached));
+
+    if (checkCache)
+        C_CopyStartupValues(startupValues, false);
+
+    bool const haveCached = C_ReadScriptCache(fileName);
+
+    if (haveCached && checkCache)
+    {
+        C_SnapshotScript(cached);
+        C_DiscardCachedScript(startupValues, initialVersion);
+    }
+    else if (checkCache)
+        initprintf("No usable " SCRIPTCACHE_FILENAME " to check %s against\n", fileName);
+    else if (haveCached)
+    {
+        kclose(kFile);
+
+        for (char * m : g_scriptModules)
+            free(m);
+        g_scriptModules.clear();
+
+        initprintf("Loaded compiled code for %s from " SCRIPTCACHE_FILENAME " in %ums%s\n", fileName,
+                   timerGetTicks() - startcompiletime, C_ScriptVersionString(g_scriptVersion));
+
+        C_FreeCompilerTables();
+        C_InitQuotes();
+        return;
+    }
+
+    initprintf("Compiling: %s (%d bytes)\n", fileName, kFileLen);
+
+    g_logFlushWindow = 0;
+
     char * mptr = (char *)Xmalloc(kFileLen+1);
     mptr[kFileLen] = 0;
 
@@ -6232,6 +7269,7 @@ void C_Compile(const char *fileName)
 
     g_scriptcrc = Bcrc32(NULL, 0, 0L);
     g_scriptcrc = Bcrc32(textptr, kFileLen, g_scriptcrc);
+    C_CacheAddFile(fileName, textptr, kFileLen);
 
     Bfree(apScript);
 
@@ -6296,20 +7334,36 @@ void C_Compile(const char *fileName)
     g_totalLines += g_lineNumber;
 
     C_SetScriptSize(g_scriptPtr-apScript+8);
+    C_OptimizeScript();
 
     initprintf("Compiled %d bytes in %ums%s\n", (int)((intptr_t)g_scriptPtr - (intptr_t)apScript),
                timerGetTicks() - startcompiletime, C_ScriptVersionString(g_scriptVersion));
 
-    for (auto i : tables_free)
-        hash_free(i);
+    if (haveCached && checkCache)
+    {
+        scriptcachebuf_t compiled[SCS_NUM];
 
-    inthash_free(&h_varvar);
-    inthash_free(&h_globalvar);
-    inthash_free(&h_playervar);
-    inthash_free(&h_actorvar);
+        Bmemset(compiled, 0, sizeof(compiled));
+        C_SnapshotScript(compiled);
 
-    freehashnames();
-    freesoundhashnames();
+        if (C_CompareSnapshots(cached, compiled))
+        {
+            char fn[BMAX_PATH];
+
+            if (!G_ModDirSnprintf(fn, sizeof(fn), SCRIPTCACHE_FILENAME))
+                unlink(fn);
+
+            initprintf("Compiled script cache " SCRIPTCACHE_FILENAME " does not match, deleted it\n");
+            g_scriptCacheable = false;
+        }
+        else initprintf("Compiled script cache " SCRIPTCACHE_FILENAME " matches\n");
+
+        C_FreeSnapshot(compiled);
+        C_FreeSnapshot(cached);
+    }
+
+    C_WriteScriptCache();
+    C_FreeCompilerTables();
 
     if (g_scriptDebug)
         C_PrintStats();
@@ -115,6 +115,7 @@ enum QuickStructureAccess_t
     STRUCT_INPUT,
     STRUCT_TILEDATA,
     STRUCT_PALDATA,
+    STRUCT_PLAYER_INTERNAL__,
     NUMQUICKSTRUCTS,
 };
 
@@ -930,6 +931,17 @@ enum ScriptKeywords_t
     CON_WHILEVARN_ACTOR,
     CON_XORVAR_ACTOR,
 
+    // written over existing instructions by C_OptimizeScript()
+    CON_IFCONST,
+    CON_IFVARE_SETVAR,
+    CON_IFVARN_SETVAR,
+    CON_IFVARE_GLOBAL_SETVAR,
+    CON_IFVARN_GLOBAL_SETVAR,
+    CON_GETSPRITESTRUCT_IFVARE,
+    CON_GETSPRITESTRUCT_IFVARN,
+    CON_GETSPRITESTRUCT_IFVARL,
+    CON_GETSPRITESTRUCT_IFVARG,
+
     CON_IFVARVARA,
     CON_IFVARVARAE,
     CON_IFVARVARAND,
@@ -1006,6 +1018,7 @@ enum ScriptKeywords_t
     CON_SETACTORVAR,
     CON_SETARRAY,
     CON_SETPLAYER,
+    CON_SETPLAYERSTRUCT,
     CON_SETPLAYERVAR,
     CON_SETPROJECTILE,
     CON_SETSECTOR,
@@ -1021,6 +1034,7 @@ enum ScriptKeywords_t
     CON_GETACTORVAR,
     CON_GETANGLE,
     CON_GETPLAYER,
+    CON_GETPLAYERSTRUCT,
     CON_GETPLAYERVAR,
     CON_GETPROJECTILE,
     CON_GETSECTOR,
@@ -31,6 +31,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "osdcmds.h"
 #include "savegame.h"
 #include "scriplib.h"
+#include "sectgrid.h"
 
 #ifdef LUNATIC
 # include "lunatic_game.h"
@@ -69,6 +70,284 @@ int32_t g_structVarIDs   = -1;
 uint32_t g_eventCalls[MAXEVENTS], g_actorCalls[MAXTILES];
 double g_eventTotalMs[MAXEVENTS], g_actorTotalMs[MAXTILES], g_actorMinMs[MAXTILES], g_actorMaxMs[MAXTILES];
 
+// CON profiler, started and stopped with the "profilecon" command.
+//
+// Events, actors and states entered while it runs make up a call tree. Timer
+// ticks are charged to the innermost node and the CON line being executed,
+// whenever either of them changes. When stopped, the only cost left in the VM
+// is one test of g_conProfile per instruction.
+int32_t g_conProfile;
+
+#define VM_PROFILE_MAXNODES 8192
+#define VM_PROFILE_MAXLINES 65536
+#define VM_PROFILE_MAXDEPTH 256
+
+enum { VM_PROFILE_EVENT, VM_PROFILE_ACTOR, VM_PROFILE_STATE };
+
+typedef struct
+{
+    int32_t parent, kind, id;
+    uint32_t calls;
+} vmprofnode_t;
+
+typedef struct
+{
+    int32_t node, line;
+    uint32_t hits;
+    uint64_t ticks;
+} vmprofline_t;
+
+static vmprofnode_t *vmprof_nodes;
+static vmprofline_t *vmprof_lines;
+static int32_t *vmprof_nodehash, *vmprof_linehash;
+static int32_t vmprof_numnodes, vmprof_numlines, vmprof_dropped;
+
+static struct { int32_t node, line; } vmprof_stack[VM_PROFILE_MAXDEPTH];
+static int32_t vmprof_depth, vmprof_node = -1, vmprof_line;
+static uint64_t vmprof_lastTicks;
+
+static FORCE_INLINE uint32_t VM_ProfileHash(uint32_t a, uint32_t b, uint32_t c)
+{
+    return ((a * 0x9E3779B1u) ^ (b * 0x85EBCA77u) ^ (c * 0xC2B2AE3Du)) >> 7;
+}
+
+static void VM_ProfileCharge(uint64_t const now)
+{
+    if (vmprof_node < 0)
+        return;
+
+    uint32_t const mask = VM_PROFILE_MAXLINES*2 - 1;
+    uint32_t h = VM_ProfileHash(vmprof_node, vmprof_line, 0) & mask;
+
+    for (; vmprof_linehash[h] >= 0; h = (h+1) & mask)
+    {
+        vmprofline_t &l = vmprof_lines[vmprof_linehash[h]];
+
+        if (l.node == vmprof_node && l.line == vmprof_line)
+        {
+            l.hits++;
+            l.ticks += now - vmprof_lastTicks;
+            return;
+        }
+    }
+
+    if (vmprof_numlines == VM_PROFILE_MAXLINES)
+    {
+        vmprof_dropped++;
+        return;
+    }
+
+    vmprof_linehash[h] = vmprof_numlines;
+    vmprof_lines[vmprof_numlines++] = { vmprof_node, vmprof_line, 1, now - vmprof_lastTicks };
+}
+
+static int32_t VM_ProfileChild(int32_t const parent, int32_t const kind, int32_t const id)
+{
+    uint32_t const mask = VM_PROFILE_MAXNODES*2 - 1;
+    uint32_t h = VM_ProfileHash(parent, kind, id) & mask;
+
+    for (; vmprof_nodehash[h] >= 0; h = (h+1) & mask)
+    {
+        vmprofnode_t const &n = vmprof_nodes[vmprof_nodehash[h]];
+
+        if (n.parent == parent && n.kind == kind && n.id == id)
+            return vmprof_nodehash[h];
+    }
+
+    // out of nodes: charge deeper calls to their caller
+    if (vmprof_numnodes == VM_PROFILE_MAXNODES)
+    {
+        vmprof_dropped++;
+        return parent;
+    }
+
+    vmprof_nodehash[h] = vmprof_numnodes;
+    vmprof_nodes[vmprof_numnodes] = { parent, kind, id, 0 };
+
+    return vmprof_numnodes++;
+}
+
+static void VM_ProfileEnter_(int32_t const kind, int32_t const id)
+{
+    uint64_t const now = timerGetTicksU64();
+
+    VM_ProfileCharge(now);
+
+    if (vmprof_depth < VM_PROFILE_MAXDEPTH)
+    {
+        vmprof_stack[vmprof_depth] = { vmprof_node, vmprof_line };
+        vmprof_node = VM_ProfileChild(vmprof_node, kind, id);
+        vmprof_nodes[vmprof_node].calls++;
+        vmprof_line = 0;
+    }
+
+    vmprof_depth++;
+    vmprof_lastTicks = now;
+}
+
+static void VM_ProfileLeave_(void)
+{
+    if (vmprof_depth == 0)
+        return;
+
+    uint64_t const now = timerGetTicksU64();
+
+    if (--vmprof_depth < VM_PROFILE_MAXDEPTH)
+    {
+        VM_ProfileCharge(now);
+        vmprof_node = vmprof_stack[vmprof_depth].node;
+        vmprof_line = vmprof_stack[vmprof_depth].line;
+    }
+
+    vmprof_lastTicks = now;
+}
+
+static FORCE_INLINE void VM_ProfileEnter(int32_t const kind, int32_t const id)
+{
+    if (EDUKE32_PREDICT_FALSE(g_conProfile))
+        VM_ProfileEnter_(kind, id);
+}
+
+static FORCE_INLINE void VM_ProfileLeave(void)
+{
+    if (EDUKE32_PREDICT_FALSE(g_conProfile))
+        VM_ProfileLeave_();
+}
+
+static void VM_ProfileLine(int32_t const line)
+{
+    if (line == vmprof_line)
+        return;
+
+    uint64_t const now = timerGetTicksU64();
+
+    VM_ProfileCharge(now);
+    vmprof_line = line;
+    vmprof_lastTicks = now;
+}
+
+void VM_ProfileReset(void)
+{
+    if (vmprof_nodehash == NULL)
+    {
+        vmprof_nodes    = (vmprofnode_t *)Xmalloc(VM_PROFILE_MAXNODES * sizeof(vmprofnode_t));
+        vmprof_lines    = (vmprofline_t *)Xmalloc(VM_PROFILE_MAXLINES * sizeof(vmprofline_t));
+        vmprof_nodehash = (int32_t *)Xmalloc(VM_PROFILE_MAXNODES * 2 * sizeof(int32_t));
+        vmprof_linehash = (int32_t *)Xmalloc(VM_PROFILE_MAXLINES * 2 * sizeof(int32_t));
+    }
+
+    Bmemset(vmprof_nodehash, -1, VM_PROFILE_MAXNODES * 2 * sizeof(int32_t));
+    Bmemset(vmprof_linehash, -1, VM_PROFILE_MAXLINES * 2 * sizeof(int32_t));
+    vmprof_numnodes = vmprof_numlines = vmprof_dropped = 0;
+}
+
+void VM_ProfileStart(void)
+{
+    if (vmprof_nodehash == NULL)
+        VM_ProfileReset();
+
+    // the OSD runs outside of the VM, so there is nothing on the stack
+    vmprof_depth = 0;
+    vmprof_node  = -1;
+    g_conProfile = 1;
+}
+
+void VM_ProfileStop(void)
+{
+    g_conProfile = 0;
+}
+
+static char const *VM_ProfileLabelName(int32_t const type, int32_t const code)
+{
+    for (bssize_t i=0; i<g_labelCnt; i++)
+        if (labelcode[i] == code && (labeltype[i] & type))
+            return label+(i<<6);
+
+    return NULL;
+}
+
+static int32_t VM_ProfileFrameName(char *buf, vmprofnode_t const &n)
+{
+    char const *name;
+
+    switch (n.kind)
+    {
+        case VM_PROFILE_EVENT:
+            return Bsprintf(buf, "%s", EventNames[n.id]);
+        case VM_PROFILE_ACTOR:
+            name = VM_ProfileLabelName(LABEL_ACTOR, n.id);
+            return name ? Bsprintf(buf, "actor %s", name) : Bsprintf(buf, "actor %d", n.id);
+        default:
+            name = VM_ProfileLabelName(LABEL_STATE, n.id);
+            return name ? Bsprintf(buf, "state %s", name) : Bsprintf(buf, "state @%d", n.id);
+    }
+}
+
+// Writes one line per (call stack, CON line) pair in the folded format read by
+// flamegraph.pl and compatible tools, weighted by timer ticks. The line
+// numbers are those of the file each piece of code was compiled from.
+int32_t VM_ProfileDump(char const *const filename)
+{
+    if (vmprof_numlines == 0)
+        return -1;
+
+    BFILE *const fp = Bfopen(filename, "wt");
+
+    if (!fp)
+        return -2;
+
+    // labels are at most 64 bytes, plus the "actor " or "state " prefix
+    int32_t const namelen = 64 + 8;
+    char *const names = (char *)Xmalloc(vmprof_numnodes * namelen);
+
+    for (bssize_t i=0; i<vmprof_numnodes; i++)
+        VM_ProfileFrameName(names + i*namelen, vmprof_nodes[i]);
+
+    int32_t path[VM_PROFILE_MAXDEPTH];
+
+    for (bssize_t i=0; i<vmprof_numlines; i++)
+    {
+        vmprofline_t const &l = vmprof_lines[i];
+
+        if (l.ticks == 0)
+            continue;
+
+        int32_t depth = 0;
+
+        for (int32_t n = l.node; n >= 0 && depth < VM_PROFILE_MAXDEPTH; n = vmprof_nodes[n].parent)
+            path[depth++] = n;
+
+        while (depth-- > 0)
+            Bfprintf(fp, "%s%s", names + path[depth]*namelen, depth ? ";" : "");
+
+        if (l.line)
+            Bfprintf(fp, ";line %d", l.line);
+
+        Bfprintf(fp, " %" PRIu64 "\n", l.ticks);
+    }
+
+    Bfclose(fp);
+    Bfree(names);
+
+    return vmprof_numlines;
+}
+
+void VM_ProfileStats(void)
+{
+    uint64_t total = 0;
+
+    for (bssize_t i=0; i<vmprof_numlines; i++)
+        total += vmprof_lines[i].ticks;
+
+    OSD_Printf("CON profiler %s: %d call paths, %d lines, %.3f ms recorded", g_conProfile ? "running" : "stopped",
+               vmprof_numnodes, vmprof_numlines, (double)total * 1000.0 / timerGetFreqU64());
+
+    if (vmprof_dropped)
+        OSD_Printf(", %d samples lost to full tables", vmprof_dropped);
+
+    OSD_Printf("\n");
+}
+
 GAMEEXEC_STATIC void VM_Execute(native_t loop);
 
 # include "gamestructures.cpp"
@@ -180,11 +459,14 @@ static FORCE_INLINE int32_t VM_EventCommon__(int const &eventNum, int const &spr
     if (EDUKE32_PREDICT_FALSE((unsigned)playerNum >= (unsigned)g_mostConcurrentPlayers))
         vm.pPlayer = g_player[0].ps;
 
+    VM_ProfileEnter(VM_PROFILE_EVENT, eventNum);
     VM_Execute(1);
 
     if (vm.flags & VM_KILL)
         VM_DeleteSprite(vm.spriteNum, vm.playerNum);
 
+    VM_ProfileLeave();
+
     // this needs to happen after VM_DeleteSprite() because VM_DeleteSprite()
     // can trigger additional events
 
@@ -1279,6 +1561,9 @@ next_instruction:
         g_errorLineNum = tw >> 12;
         g_tw = tw &= VM_INSTMASK;
 
+        if (EDUKE32_PREDICT_FALSE(g_conProfile))
+            VM_ProfileLine(g_errorLineNum);
+
         if (tw == CON_ELSE)
         {
             insptr = (intptr_t *)insptr[1];
@@ -1421,7 +1706,9 @@ next_instruction:
                 {
                     auto tempscrptr = &insptr[2];
                     insptr = (intptr_t *)insptr[1];
+                    VM_ProfileEnter(VM_PROFILE_STATE, insptr - apScript);
                     VM_Execute(1);
+                    VM_ProfileLeave();
                     insptr = tempscrptr;
                 }
                 continue;
@@ -1968,6 +2255,91 @@ next_instruction:
                 VM_CONDITIONAL(tw != *insptr);
                 continue;
 
+            // the instructions below are only written by C_OptimizeScript()
+
+            case CON_IFCONST:
+                insptr += 3;
+                VM_CONDITIONAL(*insptr);
+                continue;
+
+// an ifvar whose true branch is a single setvar, run here instead of through VM_CONDITIONAL
+#define VM_IFVAR_SETVAR(xxx)                   \
+    {                                          \
+        if (xxx)                               \
+        {                                      \
+            insptr += 2;                       \
+            g_errorLineNum = *insptr >> 12;    \
+            Gv_SetVarX(insptr[1], insptr[2]);  \
+            insptr += 3;                       \
+            continue;                          \
+        }                                      \
+        VM_CONDITIONAL(0);                     \
+    }
+
+            case CON_IFVARE_SETVAR:
+                insptr++;
+                tw = Gv_GetVarX(*insptr++);
+                VM_IFVAR_SETVAR(tw == *insptr);
+                continue;
+
+            case CON_IFVARN_SETVAR:
+                insptr++;
+                tw = Gv_GetVarX(*insptr++);
+                VM_IFVAR_SETVAR(tw != *insptr);
+                continue;
+
+            case CON_IFVARE_GLOBAL_SETVAR:
+                insptr++;
+                tw = aGameVars[*insptr++].global;
+                VM_IFVAR_SETVAR(tw == *insptr);
+                continue;
+
+            case CON_IFVARN_GLOBAL_SETVAR:
+                insptr++;
+                tw = aGameVars[*insptr++].global;
+                VM_IFVAR_SETVAR(tw != *insptr);
+                continue;
+#undef VM_IFVAR_SETVAR
+
+// getactor on a sprite member, then straight into the ifvar after it
+#define VM_GETSPRITESTRUCT_IFVAR(xxx)                                                                                    \
+    {                                                                                                                    \
+        insptr++;                                                                                                        \
+        int const spriteNum = (*insptr++ != g_thisActorVarID) ? Gv_GetVarX(insptr[-1]) : vm.spriteNum;                 \
+        int const labelNum  = *insptr++;                                                                                 \
+        auto const &spriteLabel = ActorLabels[labelNum];                                                                 \
+                                                                                                                         \
+        if (EDUKE32_PREDICT_FALSE((unsigned)spriteNum >= MAXSPRITES))                                                    \
+        {                                                                                                                \
+            CON_ERRPRINTF("invalid sprite %d\n", spriteNum);                                                             \
+            continue;                                                                                                    \
+        }                                                                                                                \
+                                                                                                                         \
+        Gv_SetVarX(*insptr++, VM_GetStruct(spriteLabel.flags, (intptr_t *)((char *)&sprite[spriteNum] + spriteLabel.offset))); \
+                                                                                                                         \
+        g_errorLineNum = *insptr >> 12;                                                                                  \
+        insptr++;                                                                                                        \
+        tw = Gv_GetVarX(*insptr++);                                                                                      \
+        VM_CONDITIONAL(xxx);                                                                                             \
+    }
+
+            case CON_GETSPRITESTRUCT_IFVARE:
+                VM_GETSPRITESTRUCT_IFVAR(tw == *insptr);
+                continue;
+
+            case CON_GETSPRITESTRUCT_IFVARN:
+                VM_GETSPRITESTRUCT_IFVAR(tw != *insptr);
+                continue;
+
+            case CON_GETSPRITESTRUCT_IFVARL:
+                VM_GETSPRITESTRUCT_IFVAR(tw < *insptr);
+                continue;
+
+            case CON_GETSPRITESTRUCT_IFVARG:
+                VM_GETSPRITESTRUCT_IFVAR(tw > *insptr);
+                continue;
+#undef VM_GETSPRITESTRUCT_IFVAR
+
             case CON_IFVARVARE:
                 insptr++;
                 tw = Gv_GetVarX(*insptr++);
@@ -2274,6 +2646,40 @@ next_instruction:
                     Gv_SetVarX(*insptr++, VM_GetPlayer(playerNum, labelNum, lParm2));
                     continue;
                 }
+
+            case CON_SETPLAYERSTRUCT:
+                insptr++;
+                {
+                    int const playerNum = (*insptr++ != g_thisActorVarID) ? Gv_GetVarX(insptr[-1]) : vm.playerNum;
+                    int const labelNum  = *insptr++;
+                    auto const &playerLabel = PlayerLabels[labelNum];
+
+                    if (EDUKE32_PREDICT_FALSE((unsigned)playerNum >= (unsigned)g_mostConcurrentPlayers))
+                    {
+                        CON_ERRPRINTF("invalid player %d\n", playerNum);
+                        continue;
+                    }
+
+                    VM_SetStruct(playerLabel.flags, (intptr_t *)((char *)g_player[playerNum].ps + playerLabel.offset), Gv_GetVarX(*insptr++));
+                    continue;
+                }
+
+            case CON_GETPLAYERSTRUCT:
+                insptr++;
+                {
+                    int const playerNum = (*insptr++ != g_thisActorVarID) ? Gv_GetVarX(insptr[-1]) : vm.playerNum;
+                    int const labelNum  = *insptr++;
+                    auto const &playerLabel = PlayerLabels[labelNum];
+
+                    if (EDUKE32_PREDICT_FALSE((unsigned)playerNum >= (unsigned)g_mostConcurrentPlayers))
+                    {
+                        CON_ERRPRINTF("invalid player %d\n", playerNum);
+                        continue;
+                    }
+
+                    Gv_SetVarX(*insptr++, VM_GetStruct(playerLabel.flags, (intptr_t *)((char *)g_player[playerNum].ps + playerLabel.offset)));
+                    continue;
+                }
             case CON_SETWALL:
                 insptr++;
                 {
@@ -2527,7 +2933,7 @@ next_instruction:
 
                     if (sectLabel.offset == -1 || sectLabel.flags & LABEL_WRITEFUNC)
                     {
-                        VM_SetSector(sectNum, labelNum, Gv_GetVarX(*insptr++));
+                        VM_SetSector(sectNum, labelNum, newValue);
                         continue;
                     }
 
@@ -6420,7 +6826,9 @@ void A_LoadActor(int32_t spriteNum)
     }
 
     insptr = g_tile[vm.pSprite->picnum].loadPtr;
+    VM_ProfileEnter(VM_PROFILE_ACTOR, vm.pSprite->picnum);
     VM_Execute(1);
+    VM_ProfileLeave();
     insptr = NULL;
 
     if (vm.flags & VM_KILL)
@@ -6504,7 +6912,9 @@ void A_Execute(int spriteNum, int playerNum, int playerDist)
 #else
     int const picnum = vm.pSprite->picnum;
     insptr = 4 + (g_tile[vm.pSprite->picnum].execPtr);
+    VM_ProfileEnter(VM_PROFILE_ACTOR, picnum);
     VM_Execute(1);
+    VM_ProfileLeave();
     insptr = NULL;
 #endif
 
@@ -6733,6 +7143,7 @@ void G_RestoreMapState(void)
 #ifndef NEW_MAP_FORMAT
         Bmemcpy(&wallext[0],&pSavedState->wallext[0],sizeof(wallext_t)*MAXWALLS);
 #endif
+        sectgrid_invalidate();
         numsectors = pSavedState->numsectors;
         Bmemcpy(&sector[0],&pSavedState->sector[0],sizeof(sectortype)*MAXSECTORS);
         Bmemcpy(&sprite[0],&pSavedState->sprite[0],sizeof(spritetype)*MAXSPRITES);
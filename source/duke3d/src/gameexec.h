@@ -50,8 +50,15 @@ extern vmstate_t vm;
 extern int32_t g_tw;
 extern int32_t g_errorLineNum;
 extern int32_t g_currentEvent;
+extern int32_t g_conProfile;
 
 void A_LoadActor(int32_t spriteNum);
+
+void VM_ProfileReset(void);
+void VM_ProfileStart(void);
+void VM_ProfileStop(void);
+void VM_ProfileStats(void);
+int32_t VM_ProfileDump(char const *filename);
 #endif
 
 extern uint32_t g_eventCalls[MAXEVENTS], g_actorCalls[MAXTILES];
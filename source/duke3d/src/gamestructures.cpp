@@ -44,6 +44,8 @@ int32_t __fastcall VM_GetTileData(int const tileNum, int32_t labelNum);
 void __fastcall VM_SetTileData(int const tileNum, int const labelNum, int32_t const newValue);
 int32_t __fastcall VM_GetPalData(int const palNum, int32_t labelNum);
 #else
+#include "sectgrid.h"
+
 #define LABEL_SETUP_UNMATCHED(struct, memb, name, idx)                                                              \
     {                                                                                                               \
         name, idx, sizeof(struct[0].memb) | (is_unsigned<decltype(struct[0].memb)>::value ? LABEL_UNSIGNED : 0), 0, \
@@ -177,8 +179,8 @@ void __fastcall VM_SetSector(int const sectNum, int const labelNum, int32_t newV
 
 const memberlabel_t WallLabels[]=
 {
-    LABEL_SETUP(wall, x,          WALL_X),
-    LABEL_SETUP(wall, y,          WALL_Y),
+    { "x", WALL_X, sizeof(wall[0].x) | LABEL_WRITEFUNC, 0, offsetof(uwalltype, x) },
+    { "y", WALL_Y, sizeof(wall[0].y) | LABEL_WRITEFUNC, 0, offsetof(uwalltype, y) },
     LABEL_SETUP(wall, point2,     WALL_POINT2),
     LABEL_SETUP(wall, nextwall,   WALL_NEXTWALL),
     LABEL_SETUP(wall, nextsector, WALL_NEXTSECTOR),
@@ -235,6 +237,16 @@ void __fastcall VM_SetWall(int const wallNum, int const labelNum, int32_t const
 
     switch (labelNum)
     {
+        case WALL_X:
+            wall[wallNum].x = newValue;
+            sectgrid_movedwall(wallNum);
+            break;
+
+        case WALL_Y:
+            wall[wallNum].y = newValue;
+            sectgrid_movedwall(wallNum);
+            break;
+
         case WALL_BLEND:
 #ifdef NEW_MAP_FORMAT
             w.blend = newValue;
@@ -382,158 +394,162 @@ const memberlabel_t TsprLabels[] =
     LABEL_SETUP_UNMATCHED(sprite, extra,    "tsprextra",    ACTOR_EXTRA),
 };
 
+// g_player[].ps is a pointer, so these go through a null one for the type
+#define PLAYER_LABEL_SETUP_UNMATCHED(memb, name, idx) LABEL_SETUP_UNMATCHED(((DukePlayer_t *)0), memb, name, idx)
+#define PLAYER_LABEL_SETUP(memb, idx) PLAYER_LABEL_SETUP_UNMATCHED(memb, #memb, idx)
+
 const memberlabel_t PlayerLabels[]=
 {
-    { "zoom",                  PLAYER_ZOOM,                  0, 0, -1 },
+    PLAYER_LABEL_SETUP(zoom,                   PLAYER_ZOOM),
     { "loogiex",               PLAYER_LOOGIEX,               LABEL_HASPARM2, 64, -1 },
     { "loogiey",               PLAYER_LOOGIEY,               LABEL_HASPARM2, 64, -1 },
-    { "numloogs",              PLAYER_NUMLOOGS,              0, 0, -1 },
-    { "loogcnt",               PLAYER_LOOGCNT,               0, 0, -1 },
-    { "posx",                  PLAYER_POSX,                  0, 0, -1 },
-    { "posy",                  PLAYER_POSY,                  0, 0, -1 },
-    { "posz",                  PLAYER_POSZ,                  0, 0, -1 },
+    PLAYER_LABEL_SETUP(numloogs,               PLAYER_NUMLOOGS),
+    PLAYER_LABEL_SETUP(loogcnt,                PLAYER_LOOGCNT),
+    PLAYER_LABEL_SETUP_UNMATCHED(pos.x,                    "posx",                  PLAYER_POSX),
+    PLAYER_LABEL_SETUP_UNMATCHED(pos.y,                    "posy",                  PLAYER_POSY),
+    PLAYER_LABEL_SETUP_UNMATCHED(pos.z,                    "posz",                  PLAYER_POSZ),
     { "horiz",                 PLAYER_HORIZ,                 0, 0, -1 },
     { "ohoriz",                PLAYER_OHORIZ,                0, 0, -1 },
     { "ohorizoff",             PLAYER_OHORIZOFF,             0, 0, -1 },
-    { "invdisptime",           PLAYER_INVDISPTIME,           0, 0, -1 },
-    { "bobposx",               PLAYER_BOBPOSX,               0, 0, -1 },
-    { "bobposy",               PLAYER_BOBPOSY,               0, 0, -1 },
-    { "oposx",                 PLAYER_OPOSX,                 0, 0, -1 },
-    { "oposy",                 PLAYER_OPOSY,                 0, 0, -1 },
-    { "oposz",                 PLAYER_OPOSZ,                 0, 0, -1 },
-    { "pyoff",                 PLAYER_PYOFF,                 0, 0, -1 },
-    { "opyoff",                PLAYER_OPYOFF,                0, 0, -1 },
-    { "posxv",                 PLAYER_POSXV,                 0, 0, -1 },
-    { "posyv",                 PLAYER_POSYV,                 0, 0, -1 },
-    { "poszv",                 PLAYER_POSZV,                 0, 0, -1 },
-    { "last_pissed_time",      PLAYER_LAST_PISSED_TIME,      0, 0, -1 },
-    { "truefz",                PLAYER_TRUEFZ,                0, 0, -1 },
-    { "truecz",                PLAYER_TRUECZ,                0, 0, -1 },
-    { "player_par",            PLAYER_PLAYER_PAR,            0, 0, -1 },
-    { "visibility",            PLAYER_VISIBILITY,            0, 0, -1 },
-    { "bobcounter",            PLAYER_BOBCOUNTER,            0, 0, -1 },
-    { "weapon_sway",           PLAYER_WEAPON_SWAY,           0, 0, -1 },
-    { "pals_time",             PLAYER_PALS_TIME,             0, 0, -1 },
-    { "crack_time",            PLAYER_CRACK_TIME,            0, 0, -1 },
-    { "aim_mode",              PLAYER_AIM_MODE,              0, 0, -1 },
+    PLAYER_LABEL_SETUP(invdisptime,            PLAYER_INVDISPTIME),
+    PLAYER_LABEL_SETUP_UNMATCHED(bobpos.x,                 "bobposx",               PLAYER_BOBPOSX),
+    PLAYER_LABEL_SETUP_UNMATCHED(bobpos.y,                 "bobposy",               PLAYER_BOBPOSY),
+    PLAYER_LABEL_SETUP_UNMATCHED(opos.x,                   "oposx",                 PLAYER_OPOSX),
+    PLAYER_LABEL_SETUP_UNMATCHED(opos.y,                   "oposy",                 PLAYER_OPOSY),
+    PLAYER_LABEL_SETUP_UNMATCHED(opos.z,                   "oposz",                 PLAYER_OPOSZ),
+    PLAYER_LABEL_SETUP(pyoff,                  PLAYER_PYOFF),
+    PLAYER_LABEL_SETUP(opyoff,                 PLAYER_OPYOFF),
+    PLAYER_LABEL_SETUP_UNMATCHED(vel.x,                    "posxv",                 PLAYER_POSXV),
+    PLAYER_LABEL_SETUP_UNMATCHED(vel.y,                    "posyv",                 PLAYER_POSYV),
+    PLAYER_LABEL_SETUP_UNMATCHED(vel.z,                    "poszv",                 PLAYER_POSZV),
+    PLAYER_LABEL_SETUP(last_pissed_time,       PLAYER_LAST_PISSED_TIME),
+    PLAYER_LABEL_SETUP(truefz,                 PLAYER_TRUEFZ),
+    PLAYER_LABEL_SETUP(truecz,                 PLAYER_TRUECZ),
+    PLAYER_LABEL_SETUP(player_par,             PLAYER_PLAYER_PAR),
+    PLAYER_LABEL_SETUP(visibility,             PLAYER_VISIBILITY),
+    PLAYER_LABEL_SETUP(bobcounter,             PLAYER_BOBCOUNTER),
+    PLAYER_LABEL_SETUP(weapon_sway,            PLAYER_WEAPON_SWAY),
+    PLAYER_LABEL_SETUP_UNMATCHED(pals.f,                   "pals_time",             PLAYER_PALS_TIME),
+    PLAYER_LABEL_SETUP(crack_time,             PLAYER_CRACK_TIME),
+    PLAYER_LABEL_SETUP(aim_mode,               PLAYER_AIM_MODE),
     { "ang",                   PLAYER_ANG,                   0, 0, -1 },
     { "oang",                  PLAYER_OANG,                  0, 0, -1 },
     { "angvel",                PLAYER_ANGVEL,                0, 0, -1 },
-    { "cursectnum",            PLAYER_CURSECTNUM,            0, 0, -1 },
-    { "look_ang",              PLAYER_LOOK_ANG,              0, 0, -1 },
-    { "last_extra",            PLAYER_LAST_EXTRA,            0, 0, -1 },
-    { "subweapon",             PLAYER_SUBWEAPON,             0, 0, -1 },
+    PLAYER_LABEL_SETUP(cursectnum,             PLAYER_CURSECTNUM),
+    PLAYER_LABEL_SETUP(look_ang,               PLAYER_LOOK_ANG),
+    PLAYER_LABEL_SETUP(last_extra,             PLAYER_LAST_EXTRA),
+    PLAYER_LABEL_SETUP(subweapon,              PLAYER_SUBWEAPON),
     { "ammo_amount",           PLAYER_AMMO_AMOUNT,           LABEL_HASPARM2, MAX_WEAPONS, -1 },
-    { "wackedbyactor",         PLAYER_WACKEDBYACTOR,         0, 0, -1 },
-    { "frag",                  PLAYER_FRAG,                  0, 0, -1 },
-    { "fraggedself",           PLAYER_FRAGGEDSELF,           0, 0, -1 },
-    { "curr_weapon",           PLAYER_CURR_WEAPON,           0, 0, -1 },
-    { "last_weapon",           PLAYER_LAST_WEAPON,           0, 0, -1 },
-    { "tipincs",               PLAYER_TIPINCS,               0, 0, -1 },
+    PLAYER_LABEL_SETUP(wackedbyactor,          PLAYER_WACKEDBYACTOR),
+    PLAYER_LABEL_SETUP(frag,                   PLAYER_FRAG),
+    PLAYER_LABEL_SETUP(fraggedself,            PLAYER_FRAGGEDSELF),
+    PLAYER_LABEL_SETUP(curr_weapon,            PLAYER_CURR_WEAPON),
+    PLAYER_LABEL_SETUP(last_weapon,            PLAYER_LAST_WEAPON),
+    PLAYER_LABEL_SETUP(tipincs,                PLAYER_TIPINCS),
     { "horizoff",              PLAYER_HORIZOFF,              0, 0, -1 },
-    { "wantweaponfire",        PLAYER_WANTWEAPONFIRE,        0, 0, -1 },
-    { "holoduke_amount",       PLAYER_HOLODUKE_AMOUNT,       0, 0, -1 },
-    { "newowner",              PLAYER_NEWOWNER,              0, 0, -1 },
-    { "hurt_delay",            PLAYER_HURT_DELAY,            0, 0, -1 },
-    { "hbomb_hold_delay",      PLAYER_HBOMB_HOLD_DELAY,      0, 0, -1 },
-    { "jumping_counter",       PLAYER_JUMPING_COUNTER,       0, 0, -1 },
-    { "airleft",               PLAYER_AIRLEFT,               0, 0, -1 },
-    { "knee_incs",             PLAYER_KNEE_INCS,             0, 0, -1 },
-    { "access_incs",           PLAYER_ACCESS_INCS,           0, 0, -1 },
-    { "fta",                   PLAYER_FTA,                   0, 0, -1 },
-    { "ftq",                   PLAYER_FTQ,                   0, 0, -1 },
-    { "access_wallnum",        PLAYER_ACCESS_WALLNUM,        0, 0, -1 },
-    { "access_spritenum",      PLAYER_ACCESS_SPRITENUM,      0, 0, -1 },
-    { "kickback_pic",          PLAYER_KICKBACK_PIC,          0, 0, -1 },
-    { "got_access",            PLAYER_GOT_ACCESS,            0, 0, -1 },
-    { "weapon_ang",            PLAYER_WEAPON_ANG,            0, 0, -1 },
-    { "firstaid_amount",       PLAYER_FIRSTAID_AMOUNT,       0, 0, -1 },
-    { "somethingonplayer",     PLAYER_SOMETHINGONPLAYER,     0, 0, -1 },
-    { "on_crane",              PLAYER_ON_CRANE,              0, 0, -1 },
-    { "i",                     PLAYER_I,                     0, 0, -1 },
-    { "one_parallax_sectnum",  PLAYER_PARALLAX_SECTNUM,      0, 0, -1 },
-    { "over_shoulder_on",      PLAYER_OVER_SHOULDER_ON,      0, 0, -1 },
-    { "random_club_frame",     PLAYER_RANDOM_CLUB_FRAME,     0, 0, -1 },
-    { "fist_incs",             PLAYER_FIST_INCS,             0, 0, -1 },
-    { "one_eighty_count",      PLAYER_ONE_EIGHTY_COUNT,      0, 0, -1 },
-    { "cheat_phase",           PLAYER_CHEAT_PHASE,           0, 0, -1 },
-    { "dummyplayersprite",     PLAYER_DUMMYPLAYERSPRITE,     0, 0, -1 },
-    { "extra_extra8",          PLAYER_EXTRA_EXTRA8,          0, 0, -1 },
-    { "quick_kick",            PLAYER_QUICK_KICK,            0, 0, -1 },
-    { "heat_amount",           PLAYER_HEAT_AMOUNT,           0, 0, -1 },
-    { "actorsqu",              PLAYER_ACTORSQU,              0, 0, -1 },
-    { "timebeforeexit",        PLAYER_TIMEBEFOREEXIT,        0, 0, -1 },
-    { "customexitsound",       PLAYER_CUSTOMEXITSOUND,       0, 0, -1 },
+    PLAYER_LABEL_SETUP(wantweaponfire,         PLAYER_WANTWEAPONFIRE),
+    PLAYER_LABEL_SETUP_UNMATCHED(inv_amount[GET_HOLODUKE], "holoduke_amount",       PLAYER_HOLODUKE_AMOUNT),
+    PLAYER_LABEL_SETUP(newowner,               PLAYER_NEWOWNER),
+    PLAYER_LABEL_SETUP(hurt_delay,             PLAYER_HURT_DELAY),
+    PLAYER_LABEL_SETUP(hbomb_hold_delay,       PLAYER_HBOMB_HOLD_DELAY),
+    PLAYER_LABEL_SETUP(jumping_counter,        PLAYER_JUMPING_COUNTER),
+    PLAYER_LABEL_SETUP(airleft,                PLAYER_AIRLEFT),
+    PLAYER_LABEL_SETUP(knee_incs,              PLAYER_KNEE_INCS),
+    PLAYER_LABEL_SETUP(access_incs,            PLAYER_ACCESS_INCS),
+    PLAYER_LABEL_SETUP(fta,                    PLAYER_FTA),
+    PLAYER_LABEL_SETUP(ftq,                    PLAYER_FTQ),
+    PLAYER_LABEL_SETUP(access_wallnum,         PLAYER_ACCESS_WALLNUM),
+    PLAYER_LABEL_SETUP(access_spritenum,       PLAYER_ACCESS_SPRITENUM),
+    PLAYER_LABEL_SETUP(kickback_pic,           PLAYER_KICKBACK_PIC),
+    PLAYER_LABEL_SETUP(got_access,             PLAYER_GOT_ACCESS),
+    PLAYER_LABEL_SETUP(weapon_ang,             PLAYER_WEAPON_ANG),
+    PLAYER_LABEL_SETUP_UNMATCHED(inv_amount[GET_FIRSTAID], "firstaid_amount",       PLAYER_FIRSTAID_AMOUNT),
+    PLAYER_LABEL_SETUP(somethingonplayer,      PLAYER_SOMETHINGONPLAYER),
+    PLAYER_LABEL_SETUP(on_crane,               PLAYER_ON_CRANE),
+    PLAYER_LABEL_SETUP(i,                      PLAYER_I),
+    PLAYER_LABEL_SETUP_UNMATCHED(parallax_sectnum,         "one_parallax_sectnum",  PLAYER_PARALLAX_SECTNUM),
+    PLAYER_LABEL_SETUP(over_shoulder_on,       PLAYER_OVER_SHOULDER_ON),
+    PLAYER_LABEL_SETUP(random_club_frame,      PLAYER_RANDOM_CLUB_FRAME),
+    PLAYER_LABEL_SETUP(fist_incs,              PLAYER_FIST_INCS),
+    PLAYER_LABEL_SETUP(one_eighty_count,       PLAYER_ONE_EIGHTY_COUNT),
+    PLAYER_LABEL_SETUP(cheat_phase,            PLAYER_CHEAT_PHASE),
+    PLAYER_LABEL_SETUP(dummyplayersprite,      PLAYER_DUMMYPLAYERSPRITE),
+    PLAYER_LABEL_SETUP(extra_extra8,           PLAYER_EXTRA_EXTRA8),
+    PLAYER_LABEL_SETUP(quick_kick,             PLAYER_QUICK_KICK),
+    PLAYER_LABEL_SETUP_UNMATCHED(inv_amount[GET_HEATS],    "heat_amount",           PLAYER_HEAT_AMOUNT),
+    PLAYER_LABEL_SETUP(actorsqu,               PLAYER_ACTORSQU),
+    PLAYER_LABEL_SETUP(timebeforeexit,         PLAYER_TIMEBEFOREEXIT),
+    PLAYER_LABEL_SETUP(customexitsound,        PLAYER_CUSTOMEXITSOUND),
     { "weaprecs",              PLAYER_WEAPRECS,              LABEL_HASPARM2, MAX_WEAPONS, -1 },
-    { "weapreccnt",            PLAYER_WEAPRECCNT,            0, 0, -1 },
-    { "interface_toggle_flag", PLAYER_INTERFACE_TOGGLE,      0, 0, -1 },
-    { "rotscrnang",            PLAYER_ROTSCRNANG,            0, 0, -1 },
-    { "dead_flag",             PLAYER_DEAD_FLAG,             0, 0, -1 },
-    { "show_empty_weapon",     PLAYER_SHOW_EMPTY_WEAPON,     0, 0, -1 },
-    { "scuba_amount",          PLAYER_SCUBA_AMOUNT,          0, 0, -1 },
-    { "jetpack_amount",        PLAYER_JETPACK_AMOUNT,        0, 0, -1 },
-    { "steroids_amount",       PLAYER_STEROIDS_AMOUNT,       0, 0, -1 },
-    { "shield_amount",         PLAYER_SHIELD_AMOUNT,         0, 0, -1 },
-    { "holoduke_on",           PLAYER_HOLODUKE_ON,           0, 0, -1 },
-    { "pycount",               PLAYER_PYCOUNT,               0, 0, -1 },
-    { "weapon_pos",            PLAYER_WEAPON_POS,            0, 0, -1 },
-    { "frag_ps",               PLAYER_FRAG_PS,               0, 0, -1 },
-    { "transporter_hold",      PLAYER_TRANSPORTER_HOLD,      0, 0, -1 },
-    { "clipdist",              PLAYER_CLIPDIST,              0, 0, -1 },
-    { "last_full_weapon",      PLAYER_LAST_FULL_WEAPON,      0, 0, -1 },
-    { "footprintshade",        PLAYER_FOOTPRINTSHADE,        0, 0, -1 },
-    { "boot_amount",           PLAYER_BOOT_AMOUNT,           0, 0, -1 },
-    { "scream_voice",          PLAYER_SCREAM_VOICE,          0, 0, -1 },
-    { "gm",                    PLAYER_GM,                    0, 0, -1 },
-    { "on_warping_sector",     PLAYER_ON_WARPING_SECTOR,     0, 0, -1 },
-    { "footprintcount",        PLAYER_FOOTPRINTCOUNT,        0, 0, -1 },
-    { "hbomb_on",              PLAYER_HBOMB_ON,              0, 0, -1 },
-    { "jumping_toggle",        PLAYER_JUMPING_TOGGLE,        0, 0, -1 },
-    { "rapid_fire_hold",       PLAYER_RAPID_FIRE_HOLD,       0, 0, -1 },
-    { "on_ground",             PLAYER_ON_GROUND,             0, 0, -1 },
+    PLAYER_LABEL_SETUP(weapreccnt,             PLAYER_WEAPRECCNT),
+    PLAYER_LABEL_SETUP_UNMATCHED(interface_toggle,         "interface_toggle_flag", PLAYER_INTERFACE_TOGGLE),
+    PLAYER_LABEL_SETUP(rotscrnang,             PLAYER_ROTSCRNANG),
+    PLAYER_LABEL_SETUP(dead_flag,              PLAYER_DEAD_FLAG),
+    PLAYER_LABEL_SETUP(show_empty_weapon,      PLAYER_SHOW_EMPTY_WEAPON),
+    PLAYER_LABEL_SETUP_UNMATCHED(inv_amount[GET_SCUBA],    "scuba_amount",          PLAYER_SCUBA_AMOUNT),
+    PLAYER_LABEL_SETUP_UNMATCHED(inv_amount[GET_JETPACK],  "jetpack_amount",        PLAYER_JETPACK_AMOUNT),
+    PLAYER_LABEL_SETUP_UNMATCHED(inv_amount[GET_STEROIDS], "steroids_amount",       PLAYER_STEROIDS_AMOUNT),
+    PLAYER_LABEL_SETUP_UNMATCHED(inv_amount[GET_SHIELD],   "shield_amount",         PLAYER_SHIELD_AMOUNT),
+    PLAYER_LABEL_SETUP(holoduke_on,            PLAYER_HOLODUKE_ON),
+    PLAYER_LABEL_SETUP(pycount,                PLAYER_PYCOUNT),
+    PLAYER_LABEL_SETUP(weapon_pos,             PLAYER_WEAPON_POS),
+    PLAYER_LABEL_SETUP(frag_ps,                PLAYER_FRAG_PS),
+    PLAYER_LABEL_SETUP(transporter_hold,       PLAYER_TRANSPORTER_HOLD),
+    PLAYER_LABEL_SETUP(clipdist,               PLAYER_CLIPDIST),
+    PLAYER_LABEL_SETUP(last_full_weapon,       PLAYER_LAST_FULL_WEAPON),
+    PLAYER_LABEL_SETUP(footprintshade,         PLAYER_FOOTPRINTSHADE),
+    PLAYER_LABEL_SETUP_UNMATCHED(inv_amount[GET_BOOTS],    "boot_amount",           PLAYER_BOOT_AMOUNT),
+    PLAYER_LABEL_SETUP(scream_voice,           PLAYER_SCREAM_VOICE),
+    { "gm",                   PLAYER_GM,                    sizeof(g_player[0].ps->gm) | LABEL_WRITEFUNC, 0, offsetof(DukePlayer_t, gm) },
+    PLAYER_LABEL_SETUP(on_warping_sector,      PLAYER_ON_WARPING_SECTOR),
+    PLAYER_LABEL_SETUP(footprintcount,         PLAYER_FOOTPRINTCOUNT),
+    PLAYER_LABEL_SETUP(hbomb_on,               PLAYER_HBOMB_ON),
+    PLAYER_LABEL_SETUP(jumping_toggle,         PLAYER_JUMPING_TOGGLE),
+    PLAYER_LABEL_SETUP(rapid_fire_hold,        PLAYER_RAPID_FIRE_HOLD),
+    PLAYER_LABEL_SETUP(on_ground,              PLAYER_ON_GROUND),
     { "name",                  PLAYER_NAME,                  LABEL_ISSTRING, 32, -1 },
-    { "inven_icon",            PLAYER_INVEN_ICON,            0, 0, -1 },
-    { "buttonpalette",         PLAYER_BUTTONPALETTE,         0, 0, -1 },
-    { "jetpack_on",            PLAYER_JETPACK_ON,            0, 0, -1 },
-    { "spritebridge",          PLAYER_SPRITEBRIDGE,          0, 0, -1 },
-    { "scuba_on",              PLAYER_SCUBA_ON,              0, 0, -1 },
-    { "footprintpal",          PLAYER_FOOTPRINTPAL,          0, 0, -1 },
-    { "heat_on",               PLAYER_HEAT_ON,               0, 0, -1 },
-    { "holster_weapon",        PLAYER_HOLSTER_WEAPON,        0, 0, -1 },
-    { "falling_counter",       PLAYER_FALLING_COUNTER,       0, 0, -1 },
+    PLAYER_LABEL_SETUP(inven_icon,             PLAYER_INVEN_ICON),
+    PLAYER_LABEL_SETUP(buttonpalette,          PLAYER_BUTTONPALETTE),
+    PLAYER_LABEL_SETUP(jetpack_on,             PLAYER_JETPACK_ON),
+    PLAYER_LABEL_SETUP(spritebridge,           PLAYER_SPRITEBRIDGE),
+    PLAYER_LABEL_SETUP(scuba_on,               PLAYER_SCUBA_ON),
+    PLAYER_LABEL_SETUP(footprintpal,           PLAYER_FOOTPRINTPAL),
+    { "heat_on",              PLAYER_HEAT_ON,               sizeof(g_player[0].ps->heat_on) | LABEL_WRITEFUNC, 0, offsetof(DukePlayer_t, heat_on) },
+    PLAYER_LABEL_SETUP(holster_weapon,         PLAYER_HOLSTER_WEAPON),
+    PLAYER_LABEL_SETUP(falling_counter,        PLAYER_FALLING_COUNTER),
     { "gotweapon",             PLAYER_GOTWEAPON,             LABEL_HASPARM2, MAX_WEAPONS, -1 },
-    { "palette",               PLAYER_PALETTE,               0, 0, -1 },
-    { "toggle_key_flag",       PLAYER_TOGGLE_KEY_FLAG,       0, 0, -1 },
-    { "knuckle_incs",          PLAYER_KNUCKLE_INCS,          0, 0, -1 },
-    { "walking_snd_toggle",    PLAYER_WALKING_SND_TOGGLE,    0, 0, -1 },
-    { "palookup",              PLAYER_PALOOKUP,              0, 0, -1 },
-    { "hard_landing",          PLAYER_HARD_LANDING,          0, 0, -1 },
-    { "max_secret_rooms",      PLAYER_MAX_SECRET_ROOMS,      0, 0, -1 },
-    { "secret_rooms",          PLAYER_SECRET_ROOMS,          0, 0, -1 },
+    { "palette",              PLAYER_PALETTE,               sizeof(g_player[0].ps->palette) | LABEL_WRITEFUNC, 0, offsetof(DukePlayer_t, palette) },
+    PLAYER_LABEL_SETUP(toggle_key_flag,        PLAYER_TOGGLE_KEY_FLAG),
+    PLAYER_LABEL_SETUP(knuckle_incs,           PLAYER_KNUCKLE_INCS),
+    PLAYER_LABEL_SETUP(walking_snd_toggle,     PLAYER_WALKING_SND_TOGGLE),
+    PLAYER_LABEL_SETUP(palookup,               PLAYER_PALOOKUP),
+    PLAYER_LABEL_SETUP(hard_landing,           PLAYER_HARD_LANDING),
+    PLAYER_LABEL_SETUP(max_secret_rooms,       PLAYER_MAX_SECRET_ROOMS),
+    PLAYER_LABEL_SETUP(secret_rooms,           PLAYER_SECRET_ROOMS),
     { "pals",                  PLAYER_PALS,                  LABEL_HASPARM2, 3, -1 },
-    { "max_actors_killed",     PLAYER_MAX_ACTORS_KILLED,     0, 0, -1 },
-    { "actors_killed",         PLAYER_ACTORS_KILLED,         0, 0, -1 },
-    { "return_to_center",      PLAYER_RETURN_TO_CENTER,      0, 0, -1 },
-    { "runspeed",              PLAYER_RUNSPEED,              0, 0, -1 },
-    { "sbs",                   PLAYER_SBS,                   0, 0, -1 },
-    { "reloading",             PLAYER_RELOADING,             0, 0, -1 },
-    { "auto_aim",              PLAYER_AUTO_AIM,              0, 0, -1 },
-    { "movement_lock",         PLAYER_MOVEMENT_LOCK,         0, 0, -1 },
-    { "sound_pitch",           PLAYER_SOUND_PITCH,           0, 0, -1 },
-    { "weaponswitch",          PLAYER_WEAPONSWITCH,          0, 0, -1 },
-    { "team",                  PLAYER_TEAM,                  0, 0, -1 },
-    { "max_player_health",     PLAYER_MAX_PLAYER_HEALTH,     0, 0, -1 },
-    { "max_shield_amount",     PLAYER_MAX_SHIELD_AMOUNT,     0, 0, -1 },
+    PLAYER_LABEL_SETUP(max_actors_killed,      PLAYER_MAX_ACTORS_KILLED),
+    PLAYER_LABEL_SETUP(actors_killed,          PLAYER_ACTORS_KILLED),
+    PLAYER_LABEL_SETUP(return_to_center,       PLAYER_RETURN_TO_CENTER),
+    PLAYER_LABEL_SETUP(runspeed,               PLAYER_RUNSPEED),
+    PLAYER_LABEL_SETUP(sbs,                    PLAYER_SBS),
+    PLAYER_LABEL_SETUP(reloading,              PLAYER_RELOADING),
+    PLAYER_LABEL_SETUP(auto_aim,               PLAYER_AUTO_AIM),
+    PLAYER_LABEL_SETUP(movement_lock,          PLAYER_MOVEMENT_LOCK),
+    PLAYER_LABEL_SETUP(sound_pitch,            PLAYER_SOUND_PITCH),
+    PLAYER_LABEL_SETUP(weaponswitch,           PLAYER_WEAPONSWITCH),
+    PLAYER_LABEL_SETUP(team,                   PLAYER_TEAM),
+    PLAYER_LABEL_SETUP(max_player_health,      PLAYER_MAX_PLAYER_HEALTH),
+    PLAYER_LABEL_SETUP(max_shield_amount,      PLAYER_MAX_SHIELD_AMOUNT),
     { "max_ammo_amount",       PLAYER_MAX_AMMO_AMOUNT,       LABEL_HASPARM2, MAX_WEAPONS, -1 },
-    { "last_quick_kick",       PLAYER_LAST_QUICK_KICK,       0, 0, -1 },
-    { "autostep",              PLAYER_AUTOSTEP,              0, 0, -1 },
-    { "autostep_sbw",          PLAYER_AUTOSTEP_SBW,          0, 0, -1 },
+    PLAYER_LABEL_SETUP(last_quick_kick,        PLAYER_LAST_QUICK_KICK),
+    PLAYER_LABEL_SETUP(autostep,               PLAYER_AUTOSTEP),
+    PLAYER_LABEL_SETUP(autostep_sbw,           PLAYER_AUTOSTEP_SBW),
     { "hudpal",                PLAYER_HUDPAL,                0, 0, -1 },
     { "index",                 PLAYER_INDEX,                 0, 0, -1 },
     { "connected",             PLAYER_CONNECTED,             0, 0, -1 },
     { "frags",                 PLAYER_FRAGS,                 LABEL_HASPARM2, MAXPLAYERS, -1 },
     { "deaths",                PLAYER_DEATHS,                0, 0, -1 },
-    { "last_used_weapon",      PLAYER_LAST_USED_WEAPON,      0, 0, -1 },
+    PLAYER_LABEL_SETUP(last_used_weapon,       PLAYER_LAST_USED_WEAPON),
 };
 
 int32_t __fastcall VM_GetPlayer(int const playerNum, int32_t labelNum, int const lParm2)
@@ -557,142 +573,11 @@ int32_t __fastcall VM_GetPlayer(int const playerNum, int32_t labelNum, int const
         case PLAYER_HORIZOFF:  labelNum = fix16_to_int(ps.q16horizoff);  break;
         case PLAYER_OHORIZOFF: labelNum = fix16_to_int(ps.oq16horizoff); break;
 
-        case PLAYER_ACCESS_INCS:        labelNum = ps.access_incs;        break;
-        case PLAYER_ACCESS_SPRITENUM:   labelNum = ps.access_spritenum;   break;
-        case PLAYER_ACCESS_WALLNUM:     labelNum = ps.access_wallnum;     break;
-        case PLAYER_ACTORS_KILLED:      labelNum = ps.actors_killed;      break;
-        case PLAYER_ACTORSQU:           labelNum = ps.actorsqu;           break;
-        case PLAYER_AIM_MODE:           labelNum = ps.aim_mode;           break;
-        case PLAYER_AIRLEFT:            labelNum = ps.airleft;            break;
-        case PLAYER_AUTO_AIM:           labelNum = ps.auto_aim;           break;
-        case PLAYER_AUTOSTEP:           labelNum = ps.autostep;           break;
-        case PLAYER_AUTOSTEP_SBW:       labelNum = ps.autostep_sbw;       break;
-        case PLAYER_BOBCOUNTER:         labelNum = ps.bobcounter;         break;
-        case PLAYER_BOBPOSX:            labelNum = ps.bobpos.x;           break;
-        case PLAYER_BOBPOSY:            labelNum = ps.bobpos.y;           break;
-        case PLAYER_BUTTONPALETTE:      labelNum = ps.buttonpalette;      break;
-        case PLAYER_CHEAT_PHASE:        labelNum = ps.cheat_phase;        break;
-        case PLAYER_CLIPDIST:           labelNum = ps.clipdist;           break;
-        case PLAYER_CRACK_TIME:         labelNum = ps.crack_time;         break;
-        case PLAYER_CURR_WEAPON:        labelNum = ps.curr_weapon;        break;
-        case PLAYER_CURSECTNUM:         labelNum = ps.cursectnum;         break;
-        case PLAYER_CUSTOMEXITSOUND:    labelNum = ps.customexitsound;    break;
-        case PLAYER_DEAD_FLAG:          labelNum = ps.dead_flag;          break;
-        case PLAYER_DUMMYPLAYERSPRITE:  labelNum = ps.dummyplayersprite;  break;
-        case PLAYER_EXTRA_EXTRA8:       labelNum = ps.extra_extra8;       break;
-        case PLAYER_FALLING_COUNTER:    labelNum = ps.falling_counter;    break;
-        case PLAYER_FIST_INCS:          labelNum = ps.fist_incs;          break;
-        case PLAYER_FOOTPRINTCOUNT:     labelNum = ps.footprintcount;     break;
-        case PLAYER_FOOTPRINTPAL:       labelNum = ps.footprintpal;       break;
-        case PLAYER_FOOTPRINTSHADE:     labelNum = ps.footprintshade;     break;
-        case PLAYER_FRAG:               labelNum = ps.frag;               break;
-        case PLAYER_FRAG_PS:            labelNum = ps.frag_ps;            break;
-        case PLAYER_FRAGGEDSELF:        labelNum = ps.fraggedself;        break;
-        case PLAYER_FTA:                labelNum = ps.fta;                break;
-        case PLAYER_FTQ:                labelNum = ps.ftq;                break;
-        case PLAYER_GM:                 labelNum = ps.gm;                 break;
-        case PLAYER_GOT_ACCESS:         labelNum = ps.got_access;         break;
-        case PLAYER_HARD_LANDING:       labelNum = ps.hard_landing;       break;
-        case PLAYER_HBOMB_HOLD_DELAY:   labelNum = ps.hbomb_hold_delay;   break;
-        case PLAYER_HBOMB_ON:           labelNum = ps.hbomb_on;           break;
-        case PLAYER_HEAT_ON:            labelNum = ps.heat_on;            break;
-        case PLAYER_HOLODUKE_ON:        labelNum = ps.holoduke_on;        break;
-        case PLAYER_HOLSTER_WEAPON:     labelNum = ps.holster_weapon;     break;
-        case PLAYER_HUDPAL:             labelNum = P_GetHudPal(&ps);      break;
-        case PLAYER_HURT_DELAY:         labelNum = ps.hurt_delay;         break;
-        case PLAYER_I:                  labelNum = ps.i;                  break;
-        case PLAYER_INDEX:              labelNum = playerNum;             break;
-        case PLAYER_INTERFACE_TOGGLE:   labelNum = ps.interface_toggle;   break;
-        case PLAYER_INVDISPTIME:        labelNum = ps.invdisptime;        break;
-        case PLAYER_INVEN_ICON:         labelNum = ps.inven_icon;         break;
-        case PLAYER_JETPACK_ON:         labelNum = ps.jetpack_on;         break;
-        case PLAYER_JUMPING_COUNTER:    labelNum = ps.jumping_counter;    break;
-        case PLAYER_JUMPING_TOGGLE:     labelNum = ps.jumping_toggle;     break;
-        case PLAYER_KICKBACK_PIC:       labelNum = ps.kickback_pic;       break;
-        case PLAYER_KNEE_INCS:          labelNum = ps.knee_incs;          break;
-        case PLAYER_KNUCKLE_INCS:       labelNum = ps.knuckle_incs;       break;
-        case PLAYER_LAST_EXTRA:         labelNum = ps.last_extra;         break;
-        case PLAYER_LAST_FULL_WEAPON:   labelNum = ps.last_full_weapon;   break;
-        case PLAYER_LAST_PISSED_TIME:   labelNum = ps.last_pissed_time;   break;
-        case PLAYER_LAST_QUICK_KICK:    labelNum = ps.last_quick_kick;    break;
-        case PLAYER_LAST_USED_WEAPON:   labelNum = ps.last_used_weapon;   break;
-        case PLAYER_LAST_WEAPON:        labelNum = ps.last_weapon;        break;
-        case PLAYER_LOOGCNT:            labelNum = ps.loogcnt;            break;
-        case PLAYER_LOOGIEX:            labelNum = ps.loogiex[lParm2];    break;
-        case PLAYER_LOOGIEY:            labelNum = ps.loogiey[lParm2];    break;
-        case PLAYER_LOOK_ANG:           labelNum = ps.look_ang;           break;
-        case PLAYER_MAX_ACTORS_KILLED:  labelNum = ps.max_actors_killed;  break;
-        case PLAYER_MAX_PLAYER_HEALTH:  labelNum = ps.max_player_health;  break;
-        case PLAYER_MAX_SECRET_ROOMS:   labelNum = ps.max_secret_rooms;   break;
-        case PLAYER_MAX_SHIELD_AMOUNT:  labelNum = ps.max_shield_amount;  break;
-        case PLAYER_MOVEMENT_LOCK:      labelNum = ps.movement_lock;      break;
-        case PLAYER_NEWOWNER:           labelNum = ps.newowner;           break;
-        case PLAYER_NUMLOOGS:           labelNum = ps.numloogs;           break;
-        case PLAYER_ON_CRANE:           labelNum = ps.on_crane;           break;
-        case PLAYER_ON_GROUND:          labelNum = ps.on_ground;          break;
-        case PLAYER_ON_WARPING_SECTOR:  labelNum = ps.on_warping_sector;  break;
-        case PLAYER_ONE_EIGHTY_COUNT:   labelNum = ps.one_eighty_count;   break;
-        case PLAYER_PARALLAX_SECTNUM:   labelNum = ps.parallax_sectnum;   break;
-        case PLAYER_OPOSX:              labelNum = ps.opos.x;             break;
-        case PLAYER_OPOSY:              labelNum = ps.opos.y;             break;
-        case PLAYER_OPOSZ:              labelNum = ps.opos.z;             break;
-        case PLAYER_OPYOFF:             labelNum = ps.opyoff;             break;
-        case PLAYER_OVER_SHOULDER_ON:   labelNum = ps.over_shoulder_on;   break;
-        case PLAYER_PALETTE:            labelNum = ps.palette;            break;
-        case PLAYER_PALOOKUP:           labelNum = ps.palookup;           break;
-        case PLAYER_PALS_TIME:          labelNum = ps.pals.f;             break;
-        case PLAYER_PLAYER_PAR:         labelNum = ps.player_par;         break;
-        case PLAYER_POSX:               labelNum = ps.pos.x;              break;
-        case PLAYER_POSXV:              labelNum = ps.vel.x;              break;
-        case PLAYER_POSY:               labelNum = ps.pos.y;              break;
-        case PLAYER_POSYV:              labelNum = ps.vel.y;              break;
-        case PLAYER_POSZ:               labelNum = ps.pos.z;              break;
-        case PLAYER_POSZV:              labelNum = ps.vel.z;              break;
-        case PLAYER_PYCOUNT:            labelNum = ps.pycount;            break;
-        case PLAYER_PYOFF:              labelNum = ps.pyoff;              break;
-        case PLAYER_QUICK_KICK:         labelNum = ps.quick_kick;         break;
-        case PLAYER_RANDOM_CLUB_FRAME:  labelNum = ps.random_club_frame;  break;
-        case PLAYER_RAPID_FIRE_HOLD:    labelNum = ps.rapid_fire_hold;    break;
-        case PLAYER_RELOADING:          labelNum = ps.reloading;          break;
-        case PLAYER_RETURN_TO_CENTER:   labelNum = ps.return_to_center;   break;
-        case PLAYER_ROTSCRNANG:         labelNum = ps.rotscrnang;         break;
-        case PLAYER_RUNSPEED:           labelNum = ps.runspeed;           break;
-        case PLAYER_SBS:                labelNum = ps.sbs;                break;
-        case PLAYER_SCREAM_VOICE:       labelNum = ps.scream_voice;       break;
-        case PLAYER_SCUBA_ON:           labelNum = ps.scuba_on;           break;
-        case PLAYER_SECRET_ROOMS:       labelNum = ps.secret_rooms;       break;
-        case PLAYER_SHOW_EMPTY_WEAPON:  labelNum = ps.show_empty_weapon;  break;
-        case PLAYER_SOMETHINGONPLAYER:  labelNum = ps.somethingonplayer;  break;
-        case PLAYER_SOUND_PITCH:        labelNum = ps.sound_pitch;        break;
-        case PLAYER_SPRITEBRIDGE:       labelNum = ps.spritebridge;       break;
-        case PLAYER_SUBWEAPON:          labelNum = ps.subweapon;          break;
-        case PLAYER_TEAM:               labelNum = ps.team;               break;
-        case PLAYER_TIMEBEFOREEXIT:     labelNum = ps.timebeforeexit;     break;
-        case PLAYER_TIPINCS:            labelNum = ps.tipincs;            break;
-        case PLAYER_TOGGLE_KEY_FLAG:    labelNum = ps.toggle_key_flag;    break;
-        case PLAYER_TRANSPORTER_HOLD:   labelNum = ps.transporter_hold;   break;
-        case PLAYER_TRUECZ:             labelNum = ps.truecz;             break;
-        case PLAYER_TRUEFZ:             labelNum = ps.truefz;             break;
-        case PLAYER_VISIBILITY:         labelNum = ps.visibility;         break;
-        case PLAYER_WACKEDBYACTOR:      labelNum = ps.wackedbyactor;      break;
-        case PLAYER_WALKING_SND_TOGGLE: labelNum = ps.walking_snd_toggle; break;
-        case PLAYER_WANTWEAPONFIRE:     labelNum = ps.wantweaponfire;     break;
-        case PLAYER_WEAPON_ANG:         labelNum = ps.weapon_ang;         break;
-        case PLAYER_WEAPON_POS:         labelNum = ps.weapon_pos;         break;
-        case PLAYER_WEAPON_SWAY:        labelNum = ps.weapon_sway;        break;
-        case PLAYER_WEAPONSWITCH:       labelNum = ps.weaponswitch;       break;
-        case PLAYER_WEAPRECCNT:         labelNum = ps.weapreccnt;         break;
-        case PLAYER_WEAPRECS:           labelNum = ps.weaprecs[lParm2];   break;
-        case PLAYER_ZOOM:               labelNum = ps.zoom;               break;
-
-        case PLAYER_BOOT_AMOUNT:     labelNum = ps.inv_amount[GET_BOOTS];    break;
-        case PLAYER_FIRSTAID_AMOUNT: labelNum = ps.inv_amount[GET_FIRSTAID]; break;
-        case PLAYER_HEAT_AMOUNT:     labelNum = ps.inv_amount[GET_HEATS];    break;
-        case PLAYER_HOLODUKE_AMOUNT: labelNum = ps.inv_amount[GET_HOLODUKE]; break;
-        case PLAYER_JETPACK_AMOUNT:  labelNum = ps.inv_amount[GET_JETPACK];  break;
-        case PLAYER_SCUBA_AMOUNT:    labelNum = ps.inv_amount[GET_SCUBA];    break;
-        case PLAYER_SHIELD_AMOUNT:   labelNum = ps.inv_amount[GET_SHIELD];   break;
-        case PLAYER_STEROIDS_AMOUNT: labelNum = ps.inv_amount[GET_STEROIDS]; break;
+        case PLAYER_HUDPAL:   labelNum = P_GetHudPal(&ps);    break;
+        case PLAYER_INDEX:    labelNum = playerNum;           break;
+        case PLAYER_LOOGIEX:  labelNum = ps.loogiex[lParm2];  break;
+        case PLAYER_LOOGIEY:  labelNum = ps.loogiey[lParm2];  break;
+        case PLAYER_WEAPRECS: labelNum = ps.weaprecs[lParm2]; break;
 
         case PLAYER_AMMO_AMOUNT:      labelNum = ps.ammo_amount[lParm2];     break;
         case PLAYER_MAX_AMMO_AMOUNT:  labelNum = ps.max_ammo_amount[lParm2]; break;
@@ -740,137 +625,9 @@ void __fastcall VM_SetPlayer(int const playerNum, int const labelNum, int const
         case PLAYER_ANGVEL:    ps.q16angvel    = fix16_from_int(newValue); break;
         case PLAYER_HORIZOFF:  ps.q16horizoff  = fix16_from_int(newValue); break;
 
-        case PLAYER_ACCESS_INCS:        ps.access_incs        = newValue; break;
-        case PLAYER_ACCESS_SPRITENUM:   ps.access_spritenum   = newValue; break;
-        case PLAYER_ACCESS_WALLNUM:     ps.access_wallnum     = newValue; break;
-        case PLAYER_ACTORS_KILLED:      ps.actors_killed      = newValue; break;
-        case PLAYER_ACTORSQU:           ps.actorsqu           = newValue; break;
-        case PLAYER_AIM_MODE:           ps.aim_mode           = newValue; break;
-        case PLAYER_AIRLEFT:            ps.airleft            = newValue; break;
-        case PLAYER_AUTO_AIM:           ps.auto_aim           = newValue; break;
-        case PLAYER_AUTOSTEP:           ps.autostep           = newValue; break;
-        case PLAYER_AUTOSTEP_SBW:       ps.autostep_sbw       = newValue; break;
-        case PLAYER_BOBCOUNTER:         ps.bobcounter         = newValue; break;
-        case PLAYER_BOBPOSX:            ps.bobpos.x           = newValue; break;
-        case PLAYER_BOBPOSY:            ps.bobpos.y           = newValue; break;
-        case PLAYER_BUTTONPALETTE:      ps.buttonpalette      = newValue; break;
-        case PLAYER_CHEAT_PHASE:        ps.cheat_phase        = newValue; break;
-        case PLAYER_CLIPDIST:           ps.clipdist           = newValue; break;
-        case PLAYER_CRACK_TIME:         ps.crack_time         = newValue; break;
-        case PLAYER_CURR_WEAPON:        ps.curr_weapon        = newValue; break;
-        case PLAYER_CURSECTNUM:         ps.cursectnum         = newValue; break;
-        case PLAYER_CUSTOMEXITSOUND:    ps.customexitsound    = newValue; break;
-        case PLAYER_DEAD_FLAG:          ps.dead_flag          = newValue; break;
-        case PLAYER_DUMMYPLAYERSPRITE:  ps.dummyplayersprite  = newValue; break;
-        case PLAYER_EXTRA_EXTRA8:       ps.extra_extra8       = newValue; break;
-        case PLAYER_FALLING_COUNTER:    ps.falling_counter    = newValue; break;
-        case PLAYER_FIST_INCS:          ps.fist_incs          = newValue; break;
-        case PLAYER_FOOTPRINTCOUNT:     ps.footprintcount     = newValue; break;
-        case PLAYER_FOOTPRINTPAL:       ps.footprintpal       = newValue; break;
-        case PLAYER_FOOTPRINTSHADE:     ps.footprintshade     = newValue; break;
-        case PLAYER_FRAG:               ps.frag               = newValue; break;
-        case PLAYER_FRAG_PS:            ps.frag_ps            = newValue; break;
-        case PLAYER_FRAGGEDSELF:        ps.fraggedself        = newValue; break;
-        case PLAYER_FTA:                ps.fta                = newValue; break;
-        case PLAYER_FTQ:                ps.ftq                = newValue; break;
-        case PLAYER_GOT_ACCESS:         ps.got_access         = newValue; break;
-        case PLAYER_HARD_LANDING:       ps.hard_landing       = newValue; break;
-        case PLAYER_HBOMB_HOLD_DELAY:   ps.hbomb_hold_delay   = newValue; break;
-        case PLAYER_HBOMB_ON:           ps.hbomb_on           = newValue; break;
-        case PLAYER_HOLODUKE_ON:        ps.holoduke_on        = newValue; break;
-        case PLAYER_HOLSTER_WEAPON:     ps.holster_weapon     = newValue; break;
-        case PLAYER_HURT_DELAY:         ps.hurt_delay         = newValue; break;
-        case PLAYER_I:                  ps.i                  = newValue; break;
-        case PLAYER_INTERFACE_TOGGLE:   ps.interface_toggle   = newValue; break;
-        case PLAYER_INVDISPTIME:        ps.invdisptime        = newValue; break;
-        case PLAYER_INVEN_ICON:         ps.inven_icon         = newValue; break;
-        case PLAYER_JETPACK_ON:         ps.jetpack_on         = newValue; break;
-        case PLAYER_JUMPING_COUNTER:    ps.jumping_counter    = newValue; break;
-        case PLAYER_JUMPING_TOGGLE:     ps.jumping_toggle     = newValue; break;
-        case PLAYER_KICKBACK_PIC:       ps.kickback_pic       = newValue; break;
-        case PLAYER_KNEE_INCS:          ps.knee_incs          = newValue; break;
-        case PLAYER_KNUCKLE_INCS:       ps.knuckle_incs       = newValue; break;
-        case PLAYER_LAST_EXTRA:         ps.last_extra         = newValue; break;
-        case PLAYER_LAST_FULL_WEAPON:   ps.last_full_weapon   = newValue; break;
-        case PLAYER_LAST_PISSED_TIME:   ps.last_pissed_time   = newValue; break;
-        case PLAYER_LAST_QUICK_KICK:    ps.last_quick_kick    = newValue; break;
-        case PLAYER_LAST_USED_WEAPON:   ps.last_used_weapon   = newValue; break;
-        case PLAYER_LAST_WEAPON:        ps.last_weapon        = newValue; break;
-        case PLAYER_LOOGCNT:            ps.loogcnt            = newValue; break;
-        case PLAYER_LOOGIEX:            ps.loogiex[lParm2]    = newValue; break;
-        case PLAYER_LOOGIEY:            ps.loogiey[lParm2]    = newValue; break;
-        case PLAYER_LOOK_ANG:           ps.look_ang           = newValue; break;
-        case PLAYER_MAX_ACTORS_KILLED:  ps.max_actors_killed  = newValue; break;
-        case PLAYER_MAX_PLAYER_HEALTH:  ps.max_player_health  = newValue; break;
-        case PLAYER_MAX_SECRET_ROOMS:   ps.max_secret_rooms   = newValue; break;
-        case PLAYER_MAX_SHIELD_AMOUNT:  ps.max_shield_amount  = newValue; break;
-        case PLAYER_MOVEMENT_LOCK:      ps.movement_lock      = newValue; break;
-        case PLAYER_NEWOWNER:           ps.newowner           = newValue; break;
-        case PLAYER_NUMLOOGS:           ps.numloogs           = newValue; break;
-        case PLAYER_ON_CRANE:           ps.on_crane           = newValue; break;
-        case PLAYER_ON_GROUND:          ps.on_ground          = newValue; break;
-        case PLAYER_ON_WARPING_SECTOR:  ps.on_warping_sector  = newValue; break;
-        case PLAYER_ONE_EIGHTY_COUNT:   ps.one_eighty_count   = newValue; break;
-        case PLAYER_PARALLAX_SECTNUM:   ps.parallax_sectnum   = newValue; break;
-        case PLAYER_OPOSX:              ps.opos.x             = newValue; break;
-        case PLAYER_OPOSY:              ps.opos.y             = newValue; break;
-        case PLAYER_OPOSZ:              ps.opos.z             = newValue; break;
-        case PLAYER_OPYOFF:             ps.opyoff             = newValue; break;
-        case PLAYER_OVER_SHOULDER_ON:   ps.over_shoulder_on   = newValue; break;
-        case PLAYER_PALOOKUP:           ps.palookup           = newValue; break;
-        case PLAYER_PALS_TIME:          ps.pals.f             = newValue; break;
-        case PLAYER_PLAYER_PAR:         ps.player_par         = newValue; break;
-        case PLAYER_POSX:               ps.pos.x              = newValue; break;
-        case PLAYER_POSXV:              ps.vel.x              = newValue; break;
-        case PLAYER_POSY:               ps.pos.y              = newValue; break;
-        case PLAYER_POSYV:              ps.vel.y              = newValue; break;
-        case PLAYER_POSZ:               ps.pos.z              = newValue; break;
-        case PLAYER_POSZV:              ps.vel.z              = newValue; break;
-        case PLAYER_PYCOUNT:            ps.pycount            = newValue; break;
-        case PLAYER_PYOFF:              ps.pyoff              = newValue; break;
-        case PLAYER_QUICK_KICK:         ps.quick_kick         = newValue; break;
-        case PLAYER_RANDOM_CLUB_FRAME:  ps.random_club_frame  = newValue; break;
-        case PLAYER_RAPID_FIRE_HOLD:    ps.rapid_fire_hold    = newValue; break;
-        case PLAYER_RELOADING:          ps.reloading          = newValue; break;
-        case PLAYER_RETURN_TO_CENTER:   ps.return_to_center   = newValue; break;
-        case PLAYER_ROTSCRNANG:         ps.rotscrnang         = newValue; break;
-        case PLAYER_RUNSPEED:           ps.runspeed           = newValue; break;
-        case PLAYER_SBS:                ps.sbs                = newValue; break;
-        case PLAYER_SCREAM_VOICE:       ps.scream_voice       = newValue; break;
-        case PLAYER_SCUBA_ON:           ps.scuba_on           = newValue; break;
-        case PLAYER_SECRET_ROOMS:       ps.secret_rooms       = newValue; break;
-        case PLAYER_SHOW_EMPTY_WEAPON:  ps.show_empty_weapon  = newValue; break;
-        case PLAYER_SOMETHINGONPLAYER:  ps.somethingonplayer  = newValue; break;
-        case PLAYER_SOUND_PITCH:        ps.sound_pitch        = newValue; break;
-        case PLAYER_SPRITEBRIDGE:       ps.spritebridge       = newValue; break;
-        case PLAYER_SUBWEAPON:          ps.subweapon          = newValue; break;
-        case PLAYER_TEAM:               ps.team               = newValue; break;
-        case PLAYER_TIMEBEFOREEXIT:     ps.timebeforeexit     = newValue; break;
-        case PLAYER_TIPINCS:            ps.tipincs            = newValue; break;
-        case PLAYER_TOGGLE_KEY_FLAG:    ps.toggle_key_flag    = newValue; break;
-        case PLAYER_TRANSPORTER_HOLD:   ps.transporter_hold   = newValue; break;
-        case PLAYER_TRUECZ:             ps.truecz             = newValue; break;
-        case PLAYER_TRUEFZ:             ps.truefz             = newValue; break;
-        case PLAYER_VISIBILITY:         ps.visibility         = newValue; break;
-        case PLAYER_WACKEDBYACTOR:      ps.wackedbyactor      = newValue; break;
-        case PLAYER_WALKING_SND_TOGGLE: ps.walking_snd_toggle = newValue; break;
-        case PLAYER_WANTWEAPONFIRE:     ps.wantweaponfire     = newValue; break;
-        case PLAYER_WEAPON_ANG:         ps.weapon_ang         = newValue; break;
-        case PLAYER_WEAPON_POS:         ps.weapon_pos         = newValue; break;
-        case PLAYER_WEAPON_SWAY:        ps.weapon_sway        = newValue; break;
-        case PLAYER_WEAPONSWITCH:       ps.weaponswitch       = newValue; break;
-        case PLAYER_WEAPRECCNT:         ps.weapreccnt         = newValue; break;
-        case PLAYER_WEAPRECS:           ps.weaprecs[lParm2]   = newValue; break;
-        case PLAYER_ZOOM:               ps.zoom               = newValue; break;
-
-        case PLAYER_BOOT_AMOUNT:     ps.inv_amount[GET_BOOTS]    = newValue; break;
-        case PLAYER_FIRSTAID_AMOUNT: ps.inv_amount[GET_FIRSTAID] = newValue; break;
-        case PLAYER_HEAT_AMOUNT:     ps.inv_amount[GET_HEATS]    = newValue; break;
-        case PLAYER_HOLODUKE_AMOUNT: ps.inv_amount[GET_HOLODUKE] = newValue; break;
-        case PLAYER_JETPACK_AMOUNT:  ps.inv_amount[GET_JETPACK]  = newValue; break;
-        case PLAYER_SCUBA_AMOUNT:    ps.inv_amount[GET_SCUBA]    = newValue; break;
-        case PLAYER_SHIELD_AMOUNT:   ps.inv_amount[GET_SHIELD]   = newValue; break;
-        case PLAYER_STEROIDS_AMOUNT: ps.inv_amount[GET_STEROIDS] = newValue; break;
+        case PLAYER_LOOGIEX:  ps.loogiex[lParm2]  = newValue; break;
+        case PLAYER_LOOGIEY:  ps.loogiey[lParm2]  = newValue; break;
+        case PLAYER_WEAPRECS: ps.weaprecs[lParm2] = newValue; break;
 
         case PLAYER_AMMO_AMOUNT:     ps.ammo_amount[lParm2]     = newValue; break;
         case PLAYER_MAX_AMMO_AMOUNT: ps.max_ammo_amount[lParm2] = newValue; break;
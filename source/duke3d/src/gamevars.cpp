@@ -229,31 +229,31 @@ corrupt:
 void Gv_WriteSave(FILE *fil)
 {
     //   AddLog("Saving Game Vars to File");
-    fwrite("BEG: EDuke32", 12, 1, fil);
+    sv_fwrite("BEG: EDuke32", 12, 1, fil);
 
-    dfwrite_LZ4(&g_gameVarCount,sizeof(g_gameVarCount),1,fil);
+    sv_dfwrite_LZ4(&g_gameVarCount,sizeof(g_gameVarCount),1,fil);
 
     for (bssize_t i = 0; i < g_gameVarCount; i++)
     {
-        dfwrite_LZ4(&(aGameVars[i]), sizeof(gamevar_t), 1, fil);
-        dfwrite_LZ4(aGameVars[i].szLabel, sizeof(uint8_t) * MAXVARLABEL, 1, fil);
+        sv_dfwrite_LZ4(&(aGameVars[i]), sizeof(gamevar_t), 1, fil);
+        sv_dfwrite_LZ4(aGameVars[i].szLabel, sizeof(uint8_t) * MAXVARLABEL, 1, fil);
 
         if (aGameVars[i].flags & GAMEVAR_PERPLAYER)
-            dfwrite_LZ4(aGameVars[i].pValues, sizeof(intptr_t) * MAXPLAYERS, 1, fil);
+            sv_dfwrite_LZ4(aGameVars[i].pValues, sizeof(intptr_t) * MAXPLAYERS, 1, fil);
         else if (aGameVars[i].flags & GAMEVAR_PERACTOR)
-            dfwrite_LZ4(aGameVars[i].pValues, sizeof(intptr_t) * MAXSPRITES, 1, fil);
+            sv_dfwrite_LZ4(aGameVars[i].pValues, sizeof(intptr_t) * MAXSPRITES, 1, fil);
     }
 
-    dfwrite_LZ4(&g_gameArrayCount,sizeof(g_gameArrayCount),1,fil);
+    sv_dfwrite_LZ4(&g_gameArrayCount,sizeof(g_gameArrayCount),1,fil);
 
     for (bssize_t i = 0; i < g_gameArrayCount; i++)
     {
         // write for .size and .dwFlags (the rest are pointers):
-        dfwrite_LZ4(&aGameArrays[i], sizeof(gamearray_t), 1, fil);
-        dfwrite_LZ4(aGameArrays[i].szLabel, sizeof(uint8_t) * MAXARRAYLABEL, 1, fil);
+        sv_dfwrite_LZ4(&aGameArrays[i], sizeof(gamearray_t), 1, fil);
+        sv_dfwrite_LZ4(aGameArrays[i].szLabel, sizeof(uint8_t) * MAXARRAYLABEL, 1, fil);
 
         if ((aGameArrays[i].flags & GAMEARRAY_SYSTEM) != GAMEARRAY_SYSTEM)
-            dfwrite_LZ4(aGameArrays[i].pValues, Gv_GetArrayAllocSize(i), 1, fil);
+            sv_dfwrite_LZ4(aGameArrays[i].pValues, Gv_GetArrayAllocSize(i), 1, fil);
     }
 
     uint8_t savedstate[MAXVOLUMES * MAXLEVELS];
@@ -263,7 +263,7 @@ void Gv_WriteSave(FILE *fil)
         if (g_mapInfo[i].savedstate != NULL)
             savedstate[i] = 1;
 
-    dfwrite_LZ4(savedstate, sizeof(savedstate), 1, fil);
+    sv_dfwrite_LZ4(savedstate, sizeof(savedstate), 1, fil);
 
     for (bssize_t i = 0; i < (MAXVOLUMES * MAXLEVELS); i++)
     {
@@ -271,27 +271,27 @@ void Gv_WriteSave(FILE *fil)
 
         mapstate_t &sv = *g_mapInfo[i].savedstate;
 
-        dfwrite_LZ4(g_mapInfo[i].savedstate, sizeof(mapstate_t), 1, fil);
+        sv_dfwrite_LZ4(g_mapInfo[i].savedstate, sizeof(mapstate_t), 1, fil);
 
         for (bssize_t j = 0; j < g_gameVarCount; j++)
         {
             if (aGameVars[j].flags & GAMEVAR_NORESET) continue;
             if (aGameVars[j].flags & GAMEVAR_PERPLAYER)
-                dfwrite_LZ4(sv.vars[j], sizeof(intptr_t) * MAXPLAYERS, 1, fil);
+                sv_dfwrite_LZ4(sv.vars[j], sizeof(intptr_t) * MAXPLAYERS, 1, fil);
             else if (aGameVars[j].flags & GAMEVAR_PERACTOR)
-                dfwrite_LZ4(sv.vars[j], sizeof(intptr_t) * MAXSPRITES, 1, fil);
+                sv_dfwrite_LZ4(sv.vars[j], sizeof(intptr_t) * MAXSPRITES, 1, fil);
         }
 
-        dfwrite_LZ4(sv.arraysiz, sizeof(sv.arraysiz), 1, fil);
+        sv_dfwrite_LZ4(sv.arraysiz, sizeof(sv.arraysiz), 1, fil);
 
         for (bssize_t j = 0; j < g_gameArrayCount; j++)
             if (aGameArrays[j].flags & GAMEARRAY_RESTORE)
             {
-                dfwrite_LZ4(sv.arrays[j], Gv_GetArrayAllocSizeForCount(j, sv.arraysiz[j]), 1, fil);
+                sv_dfwrite_LZ4(sv.arrays[j], Gv_GetArrayAllocSizeForCount(j, sv.arraysiz[j]), 1, fil);
             }
     }
 
-    fwrite("EOF: EDuke32", 12, 1, fil);
+    sv_fwrite("EOF: EDuke32", 12, 1, fil);
 }
 
 void Gv_DumpValues(void)
@@ -682,6 +682,13 @@ static int __fastcall Gv_GetArrayOrStruct(int gameVar, int spriteNum, int const
                 returnValue = VM_GetPlayer(arrayIndex, labelNum, arrayIndexVar);
                 break;
 
+            case STRUCT_PLAYER_INTERNAL__:
+                if (arrayIndexVar == g_thisActorVarID)
+                    arrayIndex = vm.playerNum;
+                CHECK_INDEX(g_mostConcurrentPlayers);
+                returnValue = VM_GetStruct(PlayerLabels[labelNum].flags, (intptr_t *)((char *)g_player[arrayIndex].ps + PlayerLabels[labelNum].offset));
+                break;
+
             // no THISACTOR check here because we convert those cases to setvarvar
             case STRUCT_ACTORVAR: returnValue = Gv_GetVar(labelNum, arrayIndex, vm.playerNum); break;
             case STRUCT_PLAYERVAR: returnValue = Gv_GetVar(labelNum, vm.spriteNum, arrayIndex); break;
@@ -1172,6 +1179,7 @@ static void Gv_AddSystemVars(void)
     Gv_NewVar("input",          -1, GAMEVAR_READONLY | GAMEVAR_SYSTEM | GAMEVAR_SPECIAL);
     Gv_NewVar("tiledata",       -1, GAMEVAR_READONLY | GAMEVAR_SYSTEM | GAMEVAR_SPECIAL);
     Gv_NewVar("paldata",        -1, GAMEVAR_READONLY | GAMEVAR_SYSTEM | GAMEVAR_SPECIAL);
+    Gv_NewVar("__player__",     -1, GAMEVAR_READONLY | GAMEVAR_SYSTEM | GAMEVAR_SPECIAL);
 #endif
 
     if (NAM_WW2GI)
@@ -1372,6 +1380,26 @@ void Gv_Init(void)
 }
 
 #if !defined LUNATIC
+// Throws away every variable and array, including what the script did to the
+// system ones, and sets them up again the way Gv_Init() does the first time.
+void Gv_Reinit(void)
+{
+    Gv_Free();
+
+    for (auto &gameVar : aGameVars)
+        gameVar.flags = 0;
+
+    for (auto &gameArray : aGameArrays)
+    {
+        gameArray.flags   = 0;
+        gameArray.pValues = NULL;
+    }
+
+    Gv_AddSystemVars();
+    Gv_InitWeaponPointers();
+    Gv_ResetSystemDefaults();
+}
+
 void Gv_InitWeaponPointers(void)
 {
     char aszBuf[64];
@@ -466,9 +466,50 @@ static netmapstate_t g_cl_InterpolatedMapStateHistory[NET_REVISIONS];
 
 // note that the map state number is not an index into here,
 // to get the index into this array out of a map state number, do <Map state number> % NET_REVISONS
+//
+// only the client uses this, see g_srv_MapState for the server's history
 static netmapstate_t g_mapStateHistory[NET_REVISIONS];
 static uint8_t       tempnetbuf[MAX_WORLDBUFFER];
 
+// The server doesn't keep NET_REVISIONS full map states. It keeps the current one, and for each revision
+// the walls, sectors and actors that changed in it together with their values in the revision before.
+// A client's state is the current one with those values put back for every revision since the one it
+// acknowledged, and only the entries in those lists can differ from the current state, so that's all
+// that a world update needs to look at.
+template <typename T>
+struct netchangelog_t
+{
+    int32_t  num, allocnum;
+    int32_t *index;
+    T *      old;
+
+    void add(int32_t i, T const &value)
+    {
+        if (num == allocnum)
+        {
+            allocnum = max(allocnum * 2, 64);
+            index    = (int32_t *)Xrealloc(index, allocnum * sizeof(int32_t));
+            old      = (T *)Xrealloc(old, allocnum * sizeof(T));
+        }
+
+        index[num] = i;
+        old[num++] = value;
+    }
+};
+
+typedef struct
+{
+    uint32_t                    revisionNumber;
+    int32_t                     prevMaxActorIndex;
+    netchangelog_t<netWall_t>   walls;
+    netchangelog_t<netSector_t> sectors;
+    netchangelog_t<netactor_t>  actors;
+} netrevision_t;
+
+static netmapstate_t g_srv_MapState;     // as of g_netMapRevisionNumber
+static netmapstate_t g_srv_NewMapState;  // scratch for building the next revision
+static netrevision_t g_srv_Revisions[NET_REVISIONS];
+
 // Remember that this constant needs to be one bit longer than a struct index, so it can't be mistaken for a valid wall, sprite, or sector index
 static const int32_t cSTOP_PARSING_CODE = ((1 << NETINDEX_BITS) - 1);
 
@@ -3477,6 +3518,195 @@ static void Net_WriteWorldToBuffer(NetBuffer_t* netBuffer, const netmapstate_t*
 }
 
 
+// Same output as Net_WriteWorldToBuffer() from the state as of fromRevisionNumber to g_srv_MapState, but
+// only visits the entries in the change logs since. Net_HaveRevisionHistory() must be true for it.
+static void Net_WriteWorldDeltaToBuffer(NetBuffer_t* netBuffer, uint32_t fromRevisionNumber)
+{
+    static netWall_t const*     fromWall[MAXWALLS];
+    static netSector_t const*   fromSector[MAXSECTORS];
+    static netactor_t const*    fromActor[MAXSPRITES];
+
+    static uint8_t  changedWalls[(MAXWALLS+7)>>3];
+    static uint8_t  changedSectors[(MAXSECTORS+7)>>3];
+    static uint8_t  changedActors[(MAXSPRITES+7)>>3];
+
+    netmapstate_t const* const toSnapshot = &g_srv_MapState;
+
+    int32_t fromMaxActorIndex = toSnapshot->maxActorIndex;
+
+    // newest first, so that each entry ends up with its value as of fromRevisionNumber
+    for (uint32_t revision = g_netMapRevisionNumber; revision != fromRevisionNumber; revision--)
+    {
+        netrevision_t const* const rev = &g_srv_Revisions[revision % NET_REVISIONS];
+
+        for (int32_t i = 0; i < rev->walls.num; i++)
+        {
+            fromWall[rev->walls.index[i]] = &rev->walls.old[i];
+            changedWalls[rev->walls.index[i]>>3] |= pow2char[rev->walls.index[i]&7];
+        }
+
+        for (int32_t i = 0; i < rev->sectors.num; i++)
+        {
+            fromSector[rev->sectors.index[i]] = &rev->sectors.old[i];
+            changedSectors[rev->sectors.index[i]>>3] |= pow2char[rev->sectors.index[i]&7];
+        }
+
+        for (int32_t i = 0; i < rev->actors.num; i++)
+        {
+            fromActor[rev->actors.index[i]] = &rev->actors.old[i];
+            changedActors[rev->actors.index[i]>>3] |= pow2char[rev->actors.index[i]&7];
+        }
+
+        fromMaxActorIndex = rev->prevMaxActorIndex;
+    }
+
+    for (int32_t index = 0; index < numwalls; index++)
+    {
+        if (changedWalls[index>>3] & pow2char[index&7])
+            NetBuffer_WriteDeltaNetWall(netBuffer, fromWall[index], &toSnapshot->wall[index]);
+    }
+
+    NetBuffer_WriteBits(netBuffer, cSTOP_PARSING_CODE, NETINDEX_BITS);
+
+    for (int32_t index = 0; index < numsectors; index++)
+    {
+        if (changedSectors[index>>3] & pow2char[index&7])
+            NetBuffer_WriteDeltaNetSector(netBuffer, fromSector[index], &toSnapshot->sector[index]);
+    }
+
+    NetBuffer_WriteBits(netBuffer, cSTOP_PARSING_CODE, NETINDEX_BITS);
+
+    int32_t const toMaxActorIndex = toSnapshot->maxActorIndex;
+
+    for (int32_t index = 0; index < max(toMaxActorIndex, fromMaxActorIndex); index++)
+    {
+        int32_t const changed = changedActors[index>>3] & pow2char[index&7];
+
+        // an actor that only one of the two states covers is always written
+        if (!changed && index < min(toMaxActorIndex, fromMaxActorIndex))
+            continue;
+
+        netactor_t const* fromPtr = changed ? fromActor[index] : &toSnapshot->actor[index];
+        netactor_t const* toPtr   = &toSnapshot->actor[index];
+
+        if (index >= fromMaxActorIndex || fromPtr->netIndex == cSTOP_PARSING_CODE)
+            fromPtr = NULL;
+
+        if (index >= toMaxActorIndex || toPtr->netIndex == cSTOP_PARSING_CODE)
+            toPtr = NULL;
+
+        NetBuffer_WriteDeltaNetActor(netBuffer, fromPtr, toPtr, 0);
+    }
+
+    NetBuffer_WriteBits(netBuffer, cSTOP_PARSING_CODE, NETINDEX_BITS); // end of actors/sprites
+
+    Bmemset(changedWalls, 0, sizeof(changedWalls));
+    Bmemset(changedSectors, 0, sizeof(changedSectors));
+    Bmemset(changedActors, 0, sizeof(changedActors));
+}
+
+// whether the change logs reach back from the current revision to fromRevisionNumber
+static bool Net_HaveRevisionHistory(uint32_t fromRevisionNumber)
+{
+    if (fromRevisionNumber > g_netMapRevisionNumber || g_netMapRevisionNumber - fromRevisionNumber > NET_REVISIONS)
+    {
+        return false;
+    }
+
+    for (uint32_t revision = g_netMapRevisionNumber; revision != fromRevisionNumber; revision--)
+    {
+        if (g_srv_Revisions[revision % NET_REVISIONS].revisionNumber != revision)
+            return false;
+    }
+
+    return true;
+}
+
+// Captures the game arrays as revision g_netMapRevisionNumber, logging what changed since the previous one.
+static void Net_AddRevisionToHistory(void)
+{
+    netrevision_t* const rev = &g_srv_Revisions[g_netMapRevisionNumber % NET_REVISIONS];
+
+    // no need to init the scratch state, everything below numwalls/numsectors and every actor is overwritten
+    Net_AddWorldToSnapshot(&g_srv_NewMapState);
+
+    rev->revisionNumber    = g_netMapRevisionNumber;
+    rev->prevMaxActorIndex = g_srv_MapState.maxActorIndex;
+
+    rev->walls.num = rev->sectors.num = rev->actors.num = 0;
+
+    for (int32_t index = 0; index < numwalls; index++)
+    {
+        if (Bmemcmp(&g_srv_NewMapState.wall[index], &g_srv_MapState.wall[index], sizeof(netWall_t)))
+        {
+            rev->walls.add(index, g_srv_MapState.wall[index]);
+            g_srv_MapState.wall[index] = g_srv_NewMapState.wall[index];
+        }
+    }
+
+    for (int32_t index = 0; index < numsectors; index++)
+    {
+        if (Bmemcmp(&g_srv_NewMapState.sector[index], &g_srv_MapState.sector[index], sizeof(netSector_t)))
+        {
+            rev->sectors.add(index, g_srv_MapState.sector[index]);
+            g_srv_MapState.sector[index] = g_srv_NewMapState.sector[index];
+        }
+    }
+
+    for (int32_t index = 0; index < MAXSPRITES; index++)
+    {
+        if (Bmemcmp(&g_srv_NewMapState.actor[index], &g_srv_MapState.actor[index], sizeof(netactor_t)))
+        {
+            rev->actors.add(index, g_srv_MapState.actor[index]);
+            g_srv_MapState.actor[index] = g_srv_NewMapState.actor[index];
+        }
+    }
+
+    g_srv_MapState.maxActorIndex  = g_srv_NewMapState.maxActorIndex;
+    g_srv_MapState.revisionNumber = g_netMapRevisionNumber;
+}
+
+// Puts the state as of fromRevisionNumber back together, only used to check and benchmark the above.
+static void Net_RebuildRevision(netmapstate_t* snapshot, uint32_t fromRevisionNumber)
+{
+    *snapshot = g_srv_MapState;
+
+    for (uint32_t revision = g_netMapRevisionNumber; revision != fromRevisionNumber; revision--)
+    {
+        netrevision_t const* const rev = &g_srv_Revisions[revision % NET_REVISIONS];
+
+        for (int32_t i = 0; i < rev->walls.num; i++)
+            snapshot->wall[rev->walls.index[i]] = rev->walls.old[i];
+
+        for (int32_t i = 0; i < rev->sectors.num; i++)
+            snapshot->sector[rev->sectors.index[i]] = rev->sectors.old[i];
+
+        for (int32_t i = 0; i < rev->actors.num; i++)
+            snapshot->actor[rev->actors.index[i]] = rev->actors.old[i];
+
+        snapshot->maxActorIndex = rev->prevMaxActorIndex;
+    }
+
+    snapshot->revisionNumber = fromRevisionNumber;
+}
+
+
+static void Net_InitRevisionHistory(void)
+{
+    // keep the change logs' allocations around for the next map
+    for (auto &rev : g_srv_Revisions)
+    {
+        rev.revisionNumber = cInitialMapStateRevisionNumber;
+        rev.walls.num = rev.sectors.num = rev.actors.num = 0;
+    }
+
+    Net_InitMapState(&g_srv_MapState);
+    Net_InitMapState(&g_srv_NewMapState);
+
+    g_srv_MapState.revisionNumber = cInitialMapStateRevisionNumber;
+}
+
+
 // buffer -> net struct functions
 //----------------------------------------------------------------------------------------------------------
 
@@ -4210,7 +4440,8 @@ static void Net_SendWorldUpdate(uint32_t fromRevisionNumber, uint32_t toRevision
     }
 
     Bassert(MAX_WORLDBUFFER == ARRAY_SIZE(tempnetbuf));
-    Bassert(NET_REVISIONS == ARRAY_SIZE(g_mapStateHistory));
+    Bassert(NET_REVISIONS == ARRAY_SIZE(g_srv_Revisions));
+    Bassert(toRevisionNumber == g_srv_MapState.revisionNumber);
 
     uint32_t        playerRevisionIsTooOld = (toRevisionNumber - fromRevisionNumber) > NET_REVISIONS;
 
@@ -4229,24 +4460,19 @@ static void Net_SendWorldUpdate(uint32_t fromRevisionNumber, uint32_t toRevision
 
     uint32_t        fromRevisionNumberToSend = 0x86753090;
 
-    netmapstate_t*  toMapState = &g_mapStateHistory[toRevisionNumber % NET_REVISIONS];
-    netmapstate_t*  fromMapState = NULL;
-
     NET_75_CHECK++; // during the rollover state it might be a good idea to init the map state history?
                     // maybe not? I do init map states before using them, so it might not be needed.
 
+    // the change logs can also have been overwritten by a newer map's revisions
+    uint32_t        useDeltaHistory = !playerRevisionIsTooOld && !revisionInRolloverState && Net_HaveRevisionHistory(fromRevisionNumber);
 
-    if (playerRevisionIsTooOld || revisionInRolloverState)
+    if (useDeltaHistory)
     {
-        fromMapState = &g_mapStartState;
-        fromRevisionNumberToSend = cInitialMapStateRevisionNumber;
+        fromRevisionNumberToSend = fromRevisionNumber;
     }
     else
     {
-        uint32_t tFromRevisionIndex = fromRevisionNumber % NET_REVISIONS;
-
-        fromMapState = &g_mapStateHistory[tFromRevisionIndex];
-        fromRevisionNumberToSend = fromRevisionNumber;
+        fromRevisionNumberToSend = cInitialMapStateRevisionNumber;
     }
 
 
@@ -4259,7 +4485,14 @@ static void Net_SendWorldUpdate(uint32_t fromRevisionNumber, uint32_t toRevision
     NetBuffer_WriteDword(bufferPtr, fromRevisionNumberToSend);
     NetBuffer_WriteDword(bufferPtr, toRevisionNumber);
 
-    Net_WriteWorldToBuffer(bufferPtr, fromMapState, toMapState);
+    if (useDeltaHistory)
+    {
+        Net_WriteWorldDeltaToBuffer(bufferPtr, fromRevisionNumber);
+    }
+    else
+    {
+        Net_WriteWorldToBuffer(bufferPtr, &g_mapStartState, &g_srv_MapState);
+    }
 
     if (sendToPlayerIndex > ((int32_t) g_netServer->peerCount))
     {
@@ -4612,12 +4845,7 @@ void Net_SendMapUpdate(void)
 
     g_netMapRevisionNumber = Net_GetNextRevisionNumber(g_netMapRevisionNumber);
 
-    netmapstate_t* toMapState = &g_mapStateHistory[g_netMapRevisionNumber % NET_REVISIONS];
-
-    Net_InitMapState(toMapState);
-    Net_AddWorldToSnapshot(toMapState);
-
-    toMapState->revisionNumber = g_netMapRevisionNumber;
+    Net_AddRevisionToHistory();
 
     int32_t playerIndex = 0;
 
@@ -4657,7 +4885,14 @@ void DumpMapStateHistory()
 
     fwrite(&g_mapStartState, sizeof(g_mapStartState), 1, mapStatesFile);
 
-    fwrite(&g_mapStateHistory[0], sizeof(g_mapStateHistory), 1, mapStatesFile);
+    if (g_netClient)
+    {
+        fwrite(&g_mapStateHistory[0], sizeof(g_mapStateHistory), 1, mapStatesFile);
+    }
+    else
+    {
+        fwrite(&g_srv_MapState, sizeof(g_srv_MapState), 1, mapStatesFile);
+    }
 
     OSD_Printf("Dumped map states to %s.\n", fileName);
 
@@ -4666,6 +4901,136 @@ void DumpMapStateHistory()
 }
 
 
+#define NET_BENCHCLIENTS 8
+
+static struct
+{
+    int32_t         numUpdates, updatesLeft;
+    netmapstate_t*  fromMapState;
+    uint8_t*        fullBuffer;
+
+    double          fullCaptureTime, deltaCaptureTime, fullWriteTime, deltaWriteTime;
+    int64_t         numBytes;
+    int32_t         numChanged, numMismatched;
+} g_netBench;
+
+///< summary>
+/// Starts timing the server's side of world updates over the next numUpdates map updates of a local game,
+/// as if NET_BENCHCLIENTS clients were connected that are 1 to NET_BENCHCLIENTS updates behind.
+///</summary>
+void Net_SnapshotBenchmark(int32_t numUpdates)
+{
+    if (g_netServer || g_netClient)
+    {
+        OSD_Printf("Can't benchmark world updates in a network game.\n");
+        return;
+    }
+
+    if (numsectors <= 0 || !(g_player[myconnectindex].ps->gm & MODE_GAME))
+    {
+        OSD_Printf("No map loaded.\n");
+        return;
+    }
+
+    if (g_netBench.updatesLeft)
+    {
+        OSD_Printf("World update benchmark already running.\n");
+        return;
+    }
+
+    Bmemset(&g_netBench, 0, sizeof(g_netBench));
+
+    g_netBench.numUpdates   = g_netBench.updatesLeft = numUpdates;
+    g_netBench.fromMapState = (netmapstate_t *)Xmalloc(sizeof(netmapstate_t));
+    g_netBench.fullBuffer   = (uint8_t *)Xmalloc(MAX_WORLDBUFFER);
+
+    Net_InitRevisionHistory();
+    Net_AddWorldToSnapshot(&g_srv_MapState);
+
+    g_netMapRevisionNumber = cInitialMapStateRevisionNumber;
+
+    OSD_Printf("Benchmarking world updates over the next %d map updates...\n", numUpdates);
+}
+
+void Net_SnapshotBenchmarkUpdate(void)
+{
+    if (!g_netBench.updatesLeft)
+    {
+        return;
+    }
+
+    NetBuffer_t buffer;
+    NetBuffer_t fullBuffer;
+
+    // what the server did before: capture a whole map state into the history
+    double t = timerGetHiTicks();
+
+    Net_InitMapState(g_netBench.fromMapState);
+    Net_AddWorldToSnapshot(g_netBench.fromMapState);
+
+    g_netBench.fullCaptureTime += timerGetHiTicks() - t;
+
+    g_netMapRevisionNumber = Net_GetNextRevisionNumber(g_netMapRevisionNumber);
+
+    t = timerGetHiTicks();
+    Net_AddRevisionToHistory();
+    g_netBench.deltaCaptureTime += timerGetHiTicks() - t;
+
+    netrevision_t const* const rev = &g_srv_Revisions[g_netMapRevisionNumber % NET_REVISIONS];
+    g_netBench.numChanged += rev->walls.num + rev->sectors.num + rev->actors.num;
+
+    for (int32_t client = 1; client <= NET_BENCHCLIENTS; client++)
+    {
+        uint32_t const fromRevisionNumber = g_netMapRevisionNumber - min<uint32_t>(client, g_netMapRevisionNumber);
+
+        Bmemset(tempnetbuf, 0, sizeof(tempnetbuf));
+        NetBuffer_Init(&buffer, tempnetbuf, MAX_WORLDBUFFER);
+
+        t = timerGetHiTicks();
+        Net_WriteWorldDeltaToBuffer(&buffer, fromRevisionNumber);
+        g_netBench.deltaWriteTime += timerGetHiTicks() - t;
+
+        Net_RebuildRevision(g_netBench.fromMapState, fromRevisionNumber);
+
+        Bmemset(g_netBench.fullBuffer, 0, MAX_WORLDBUFFER);
+        NetBuffer_Init(&fullBuffer, g_netBench.fullBuffer, MAX_WORLDBUFFER);
+
+        t = timerGetHiTicks();
+        Net_WriteWorldToBuffer(&fullBuffer, g_netBench.fromMapState, &g_srv_MapState);
+        g_netBench.fullWriteTime += timerGetHiTicks() - t;
+
+        g_netBench.numBytes += buffer.CurSize;
+        g_netBench.numMismatched += (buffer.CurSize != fullBuffer.CurSize || Bmemcmp(tempnetbuf, g_netBench.fullBuffer, buffer.CurSize));
+    }
+
+    if (--g_netBench.updatesLeft)
+    {
+        return;
+    }
+
+    int32_t const numUpdates = g_netBench.numUpdates;
+    int32_t const numWrites  = numUpdates * NET_BENCHCLIENTS;
+
+    OSD_Printf("World update benchmark, %d map updates to %d clients:\n", numUpdates, NET_BENCHCLIENTS);
+    OSD_Printf("  %.1f changed entries/update, %.1f bytes/client/update, %.1f bytes/client/tic\n",
+               (double)g_netBench.numChanged / numUpdates, (double)g_netBench.numBytes / numWrites,
+               (double)g_netBench.numBytes / (numWrites * 10));
+    OSD_Printf("  full states: %8.3f ms/update capture, %8.3f ms/client write\n",
+               g_netBench.fullCaptureTime / numUpdates, g_netBench.fullWriteTime / numWrites);
+    OSD_Printf("  change logs: %8.3f ms/update capture, %8.3f ms/client write\n",
+               g_netBench.deltaCaptureTime / numUpdates, g_netBench.deltaWriteTime / numWrites);
+
+    if (g_netBench.numMismatched)
+        OSD_Printf("  %d updates DISAGREE with the full state delta!\n", g_netBench.numMismatched);
+
+    DO_FREE_AND_NULL(g_netBench.fromMapState);
+    DO_FREE_AND_NULL(g_netBench.fullBuffer);
+
+    Net_InitRevisionHistory();
+    g_netMapRevisionNumber = cInitialMapStateRevisionNumber;
+}
+
+
 void Net_SpawnPlayer(int32_t player)
 {
     int32_t byteOffset    = 0;
@@ -4797,6 +5162,10 @@ void Net_Connect(const char *srvaddr)
 void Net_AddWorldToInitialSnapshot()
 {
     Net_AddWorldToSnapshot(&g_mapStartState);
+
+    // revision 0 is the initial snapshot, which is also what the client deltas it against
+    g_srv_MapState = g_mapStartState;
+    g_srv_MapState.revisionNumber = cInitialMapStateRevisionNumber;
 }
 
 void Net_SendClientInfo(void)
@@ -5171,7 +5540,8 @@ void Net_InitMapStateHistory()
 {
     int32_t mapStateIndex = 0;
 
-    for (mapStateIndex = 0; mapStateIndex < NET_REVISIONS; mapStateIndex++)
+    // the server never touches the client's full histories, and there's no point in paging them in
+    for (mapStateIndex = 0; mapStateIndex < NET_REVISIONS && !g_netServer; mapStateIndex++)
     {
         netmapstate_t *mapState = &g_mapStateHistory[mapStateIndex];
         netmapstate_t *clState  = &g_cl_InterpolatedMapStateHistory[mapStateIndex];
@@ -5181,6 +5551,8 @@ void Net_InitMapStateHistory()
         Net_InitMapState(clState);
     }
 
+    Net_InitRevisionHistory();
+
     Net_InitMapState(&g_mapStartState);
 
     g_mapStartState.revisionNumber = cInitialMapStateRevisionNumber;
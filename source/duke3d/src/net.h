@@ -292,6 +292,9 @@ int32_t Dbg_PacketSent(enum DukePacket_t iPacketType);
 
 void DumpMapStateHistory();
 
+void Net_SnapshotBenchmark(int32_t numUpdates);
+void Net_SnapshotBenchmarkUpdate(void);
+
 void Net_WaitForInitialSnapshot();
 
 #else
@@ -342,6 +345,7 @@ void Net_WaitForInitialSnapshot();
 #define Net_InitMapStateHistory(...) ((void)0)
 #define Net_AddWorldToInitialSnapshot(...) ((void)0)
 #define DumpMapStateHistory(...) ((void)0)
+#define Net_SnapshotBenchmarkUpdate(...) ((void)0)
 
 
 
@@ -391,6 +391,61 @@ static int osdcmd_restartsound(osdcmdptr_t UNUSED(parm))
     return OSDCMD_OK;
 }
 
+static int osdcmd_mixbench(osdcmdptr_t parm)
+{
+    if (parm->numparms > 1) return OSDCMD_SHOWHELP;
+
+    int32_t const numvoices = parm->numparms ? clamp(Batol(parm->parms[0]), 1, 1024) : 128;
+
+    S_SoundShutdown();
+    S_MusicShutdown();
+
+    FX_SetPrintf(OSD_Printf);
+    FX_MixBenchmark(numvoices, 2000);
+
+    S_MusicStartup();
+    S_SoundStartup();
+
+    FX_StopAllSounds();
+    S_ClearSoundLocks();
+
+    if (ud.config.MusicToggle)
+        S_RestartMusic();
+
+    return OSDCMD_OK;
+}
+
+static int osdcmd_soundstats(osdcmdptr_t parm)
+{
+    if (parm->numparms > 1 || (parm->numparms == 1 && Bstrcasecmp(parm->parms[0], "reset")))
+        return OSDCMD_SHOWHELP;
+
+    if (parm->numparms == 1)
+    {
+        FX_ResetStats();
+        return OSDCMD_OK;
+    }
+
+    mvstats_t stats;
+
+    if (FX_GetStats(&stats) != FX_Ok)
+    {
+        OSD_Printf("Sound is not initialized.\n");
+        return OSDCMD_OK;
+    }
+
+    double const pagems = stats.pageframes * 1000.0 / stats.mixrate;
+
+    OSD_Printf("Mixing: %d pages of %d frames, %.3f ms avg, %.3f ms max (%.1f%% of real time)\n", stats.pages,
+               stats.pageframes, stats.pages ? stats.mixms / stats.pages : 0.0, stats.maxmixms,
+               stats.pages ? stats.mixms * 100.0 / (stats.pages * pagems) : 0.0);
+    OSD_Printf("Buffer: %d frames%s, about %.1f ms latency, %d underruns\n", stats.bufferframes,
+               ud.config.AdaptiveBuffer ? " (adaptive)" : "",
+               (stats.bufferframes * 2 + stats.pageframes) * 1000.0 / stats.mixrate, stats.underruns);
+
+    return OSDCMD_OK;
+}
+
 static int osdcmd_music(osdcmdptr_t parm)
 {
     if (parm->numparms == 1)
@@ -1305,6 +1360,15 @@ static int osdcmd_purgesaves(osdcmdptr_t UNUSED(parm))
     return OSDCMD_OK;
 }
 
+static int osdcmd_savediffbench(osdcmdptr_t parm)
+{
+    if (parm->numparms > 1) return OSDCMD_SHOWHELP;
+
+    sv_diffbenchmark(parm->numparms ? clamp(Batol(parm->parms[0]), 1, 10000) : 100);
+
+    return OSDCMD_OK;
+}
+
 static int osdcmd_printtimes(osdcmdptr_t UNUSED(parm))
 {
     UNREFERENCED_CONST_PARAMETER(parm);
@@ -1372,6 +1436,43 @@ static int osdcmd_printtimes(osdcmdptr_t UNUSED(parm))
     return OSDCMD_OK;
 }
 
+#if !defined LUNATIC
+static int osdcmd_profilecon(osdcmdptr_t parm)
+{
+    if (parm->numparms == 0)
+    {
+        VM_ProfileStats();
+        return OSDCMD_OK;
+    }
+
+    if (!Bstrcasecmp(parm->parms[0], "start") && parm->numparms == 1)
+        VM_ProfileStart();
+    else if (!Bstrcasecmp(parm->parms[0], "stop") && parm->numparms == 1)
+        VM_ProfileStop();
+    else if (!Bstrcasecmp(parm->parms[0], "reset") && parm->numparms == 1)
+        VM_ProfileReset();
+    else if (!Bstrcasecmp(parm->parms[0], "dump") && parm->numparms <= 2)
+    {
+        char const *const fn = parm->numparms == 2 ? parm->parms[1] : "conprofile.folded";
+        int32_t const numlines = VM_ProfileDump(fn);
+
+        if (numlines == -1)
+            OSD_Printf("Nothing recorded yet.\n");
+        else if (numlines < 0)
+            OSD_Printf(OSD_ERROR "Unable to write CON profile to \"%s\"!\n", fn);
+        else
+            OSD_Printf("Wrote %d stacks to \"%s\".\n", numlines, fn);
+
+        return OSDCMD_OK;
+    }
+    else
+        return OSDCMD_SHOWHELP;
+
+    VM_ProfileStats();
+    return OSDCMD_OK;
+}
+#endif
+
 static int osdcmd_cvar_set_game(osdcmdptr_t parm)
 {
     int const r = osdcmd_cvar_set(parm);
@@ -1535,6 +1636,15 @@ static int32_t osdcmd_playerinfo(osdfuncparm_t const * const)
 
     return OSDCMD_OK;
 }
+
+static int osdcmd_netsnapbench(osdcmdptr_t parm)
+{
+    if (parm->numparms > 1) return OSDCMD_SHOWHELP;
+
+    Net_SnapshotBenchmark(parm->numparms ? clamp(Batol(parm->parms[0]), 1, 1000) : 50);
+
+    return OSDCMD_OK;
+}
 #endif
 
 int32_t registerosdcommands(void)
@@ -1651,10 +1761,13 @@ int32_t registerosdcommands(void)
 
         { "snd_ambience", "enables/disables ambient sounds", (void *)&ud.config.AmbienceToggle, CVAR_BOOL, 0, 1 },
         { "snd_enabled", "enables/disables sound effects", (void *)&ud.config.SoundToggle, CVAR_BOOL, 0, 1 },
+        { "snd_adaptive", "enables/disables growing and shrinking the sound buffer as playback skips or keeps up", (void *)&ud.config.AdaptiveBuffer, CVAR_BOOL, 0, 1 },
+        { "snd_buffersize", "frames of audio buffered ahead of the sound card, 0 for the driver's default (needs restartsound)", (void *)&ud.config.BufferSize, CVAR_INT, 0, 8192 },
         { "snd_fxvolume", "controls volume for sound effects", (void *)&ud.config.FXVolume, CVAR_INT, 0, 255 },
         { "snd_mixrate", "sound mixing rate", (void *)&ud.config.MixRate, CVAR_INT, 0, 48000 },
         { "snd_numchannels", "the number of sound channels", (void *)&ud.config.NumChannels, CVAR_INT, 0, 2 },
         { "snd_numvoices", "the number of concurrent sounds", (void *)&ud.config.NumVoices, CVAR_INT, 1, 128 },
+        { "snd_resamplecache", "enables/disables keeping copies of fixed-pitch sounds converted to the mixing rate", (void *)&ud.config.ResampleCache, CVAR_BOOL, 0, 1 },
         { "snd_reversestereo", "reverses the stereo channels", (void *)&ud.config.ReverseStereo, CVAR_BOOL, 0, 1 },
         { "snd_speech", "enables/disables player speech", (void *)&ud.config.VoiceToggle, CVAR_INT, 0, 5 },
 
@@ -1753,6 +1866,10 @@ int32_t registerosdcommands(void)
 
     OSD_RegisterFunction("printtimes", "printtimes: prints VM timing statistics", osdcmd_printtimes);
 
+#if !defined LUNATIC
+    OSD_RegisterFunction("profilecon", "profilecon [start|stop|reset|dump [file]]: CON profiler, dumps folded stacks for flame graphs", osdcmd_profilecon);
+#endif
+
     OSD_RegisterFunction("purgesaves", "purgesaves: deletes obsolete and unreadable save files", osdcmd_purgesaves);
 
     OSD_RegisterFunction("quicksave","quicksave: performs a quick save", osdcmd_quicksave);
@@ -1762,7 +1879,11 @@ int32_t registerosdcommands(void)
 
     OSD_RegisterFunction("restartmap", "restartmap: restarts the current map", osdcmd_restartmap);
     OSD_RegisterFunction("restartsound","restartsound: reinitializes the sound system",osdcmd_restartsound);
+    OSD_RegisterFunction("soundstats","soundstats [reset]: shows the sound mixer's timing, buffer size and underruns",osdcmd_soundstats);
+    OSD_RegisterFunction("mixbench","mixbench [voices]: times the sound mixer on the no-sound driver, restarting sound",osdcmd_mixbench);
     OSD_RegisterFunction("restartvid","restartvid: reinitializes the video mode",osdcmd_restartvid);
+
+    OSD_RegisterFunction("savediffbench", "savediffbench [iterations]: times the demo diff against the last snapshot", osdcmd_savediffbench);
 #if !defined LUNATIC
     OSD_RegisterFunction("addlogvar","addlogvar <gamevar>: prints the value of a gamevar", osdcmd_addlogvar);
     OSD_RegisterFunction("setvar","setvar <gamevar> <value>: sets the value of a gamevar", osdcmd_setvar);
@@ -1786,6 +1907,7 @@ int32_t registerosdcommands(void)
 #ifndef NETCODE_DISABLE
     OSD_RegisterFunction("dumpmapstates", "Dumps current snapshots to CL/Srv_MapStates.bin", osdcmd_dumpmapstate);
     OSD_RegisterFunction("playerinfo", "Prints information about the current player", osdcmd_playerinfo);
+    OSD_RegisterFunction("netsnapbench", "netsnapbench [updates]: times the server's world updates to 8 simulated clients in a local game", osdcmd_netsnapbench);
 #endif
 
     return 0;
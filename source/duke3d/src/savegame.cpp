@@ -21,9 +21,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 //-------------------------------------------------------------------------
 
 #include "duke3d.h"
+#include "lz4.h"
 #include "premap.h"
 #include "prlights.h"
 #include "savegame.h"
+#include "sectgrid.h"
+#include "threadpool.h"
+#include <atomic>
 #ifdef LUNATIC
 # include "lunatic_game.h"
 static int32_t g_savedOK;
@@ -145,20 +149,205 @@ uint16_t g_nummenusaves;
 static menusave_t * g_internalsaves;
 static uint16_t g_numinternalsaves;
 
-static void ReadSaveGameHeaders_CACHE1D(CACHE1D_FIND_REC *f)
+// Save index
+//
+// The save and load menus need the header of every savegame. Instead of
+// opening all of them each time, the headers are kept in SAVEINDEX_FILE
+// together with the size and modification time of the file each came from,
+// and only savegames that are new or have changed since are read again.
+// G_SavePlayer() and G_DeleteSave() drop the entries of the files they touch,
+// since a save overwritten within a second can keep both its size and time.
+// An index written with a different SAVEINDEX_VERSION or entry size is thrown
+// away and rebuilt from the savegames.
+
+#define SAVEINDEX_FILE    "saveindex.dat"
+#define SAVEINDEX_VERSION 1  // bump when saveindex_t or savehead_t change
+
+static char const saveindex_magic[] = "EDuke32SaveIndex";
+
+typedef struct
+{
+    char       path[BMAX_PATH];
+    int64_t    size, mtime;
+    int32_t    readok;  // the full header could be read
+    savehead_t h;
+} saveindex_t;
+
+static saveindex_t *svindex;
+static int32_t      svindexcnt = -1;  // not loaded yet
+
+static int32_t sv_checkheader(int32_t spot, savehead_t *h);
+
+static void sv_loadindex(void)
+{
+    if (svindexcnt >= 0)
+        return;
+
+    svindexcnt = 0;
+
+    char fn[BMAX_PATH];
+
+    if (G_ModDirSnprintf(fn, sizeof(fn), SAVEINDEX_FILE))
+        return;
+
+    FILE *fil = Bfopen(fn, "rb");
+
+    if (!fil)
+        return;
+
+    char    magic[sizeof(saveindex_magic)];
+    int32_t version, entrysize, cnt;
+
+    if (fread(magic, sizeof(magic), 1, fil) == 1 && !Bmemcmp(magic, saveindex_magic, sizeof(magic))
+        && fread(&version, sizeof(version), 1, fil) == 1 && version == SAVEINDEX_VERSION
+        && fread(&entrysize, sizeof(entrysize), 1, fil) == 1 && entrysize == (int32_t)sizeof(saveindex_t)
+        && fread(&cnt, sizeof(cnt), 1, fil) == 1 && cnt > 0 && cnt <= 65535)
+    {
+        svindex = (saveindex_t *)Xrealloc(svindex, cnt * sizeof(saveindex_t));
+
+        if (fread(svindex, sizeof(saveindex_t), cnt, fil) == (size_t)cnt)
+        {
+            svindexcnt = cnt;
+
+            for (bssize_t i=0; i<cnt; i++)
+                svindex[i].path[BMAX_PATH-1] = '\0';
+        }
+    }
+
+    Bfclose(fil);
+}
+
+static void sv_writeindex(void)
+{
+    char fn[BMAX_PATH];
+
+    if (G_ModDirSnprintf(fn, sizeof(fn), SAVEINDEX_FILE))
+        return;
+
+    FILE *fil = Bfopen(fn, "wb");
+
+    if (!fil)
+        return;
+
+    int32_t const version   = SAVEINDEX_VERSION;
+    int32_t const entrysize = sizeof(saveindex_t);
+    int32_t const cnt       = max(svindexcnt, 0);
+
+    fwrite(saveindex_magic, sizeof(saveindex_magic), 1, fil);
+    fwrite(&version, sizeof(version), 1, fil);
+    fwrite(&entrysize, sizeof(entrysize), 1, fil);
+    fwrite(&cnt, sizeof(cnt), 1, fil);
+    fwrite(svindex, sizeof(saveindex_t), cnt, fil);
+
+    Bfclose(fil);
+}
+
+static saveindex_t *sv_findindex(char const *path)
+{
+    for (bssize_t i=0; i<svindexcnt; i++)
+        if (!Bstrcmp(svindex[i].path, path))
+            return &svindex[i];
+
+    return NULL;
+}
+
+static void sv_dropindex(char const *path)
+{
+    sv_loadindex();
+
+    saveindex_t *const e = sv_findindex(path);
+
+    if (e)
+    {
+        *e = svindex[--svindexcnt];
+        sv_writeindex();
+    }
+}
+
+// Looks for the savegame where kopen4loadfrommod() would.
+static bool sv_statsave(char const *path, int64_t *size, int64_t *mtime)
+{
+    char modpath[BMAX_PATH];
+    char *where = NULL;
+
+    bool const inmod = (g_modDir[0] != '/' || g_modDir[1] != 0)
+                       && Bsnprintf(modpath, sizeof(modpath), "%s/%s", g_modDir, path) < (int32_t)sizeof(modpath)-1
+                       && findfrompath(modpath, &where) == 0;
+
+    if (!inmod && findfrompath(path, &where) < 0)
+        return false;
+
+    struct Bstat st;
+    bool const ok = (Bstat(where, &st) == 0);
+
+    if (ok)
+    {
+        *size  = st.st_size;
+        *mtime = st.st_mtime;
+    }
+
+    Bfree(where);
+
+    return ok;
+}
+
+// Like sv_loadheader() on the savegame, going through *newentry. Returns INT32_MIN if it can't be opened.
+static int32_t sv_loadindexedheader(char const *path, savehead_t *h, saveindex_t *newentry)
+{
+    saveindex_t e;
+
+    Bmemset(&e, 0, sizeof(e));
+
+    bool const havestat = sv_statsave(path, &e.size, &e.mtime);
+    saveindex_t const *const olde = havestat ? sv_findindex(path) : NULL;
+
+    if (olde && olde->size == e.size && olde->mtime == e.mtime)
+        e = *olde;
+    else
+    {
+        int32_t const fil = kopen4loadfrommod(path, 0);
+
+        if (fil == -1)
+            return INT32_MIN;
+
+        e.readok = (kread(fil, &e.h, sizeof(savehead_t)) == sizeof(savehead_t));
+        Bstrncpyz(e.path, path, sizeof(e.path));
+
+        kclose(fil);
+    }
+
+    *h = e.h;
+
+    if (havestat)
+        *newentry = e;
+    else
+        newentry->path[0] = '\0';
+
+    if (!e.readok)
+    {
+        OSD_Printf("Savegame \"%s\" header corrupt.\n", path);
+        Bmemset(h->headerstr, 0, sizeof(h->headerstr));
+        return -1;
+    }
+
+    return sv_checkheader(0, h);
+}
+
+static void ReadSaveGameHeaders_CACHE1D(CACHE1D_FIND_REC *f, saveindex_t *newindex)
 {
     savehead_t h;
 
     for (; f != nullptr; f = f->next)
     {
         char const * fn = f->name;
-        int32_t fil = kopen4loadfrommod(fn, 0);
-        if (fil == -1)
+        saveindex_t & newentry = newindex[g_numinternalsaves];
+
+        int32_t k = sv_loadindexedheader(fn, &h, &newentry);
+        if (k == INT32_MIN)
             continue;
 
         menusave_t & msv = g_internalsaves[g_numinternalsaves];
 
-        int32_t k = sv_loadheader(fil, 0, &h);
         if (k)
         {
             if (k < 0)
@@ -179,8 +368,6 @@ static void ReadSaveGameHeaders_CACHE1D(CACHE1D_FIND_REC *f)
         }
         else
             msv.isUnreadable = 1;
-
-        kclose(fil);
     }
 }
 
@@ -207,10 +394,36 @@ static void ReadSaveGameHeaders_Internal(void)
     for (int x = 0; x < numfiles; ++x)
         g_internalsaves[x].clear();
 
+    sv_loadindex();
+
+    auto newindex = (saveindex_t *)Xmalloc(max(numfiles, 1) * sizeof(saveindex_t));
+
     g_numinternalsaves = 0;
-    ReadSaveGameHeaders_CACHE1D(findfiles_default);
+    ReadSaveGameHeaders_CACHE1D(findfiles_default, newindex);
     klistfree(findfiles_default);
 
+    // only keep entries of the savegames that were found, and rewrite the index if anything changed
+    int32_t newcnt = 0;
+
+    for (int x = 0; x < g_numinternalsaves; ++x)
+        if (newindex[x].path[0])
+            newindex[newcnt++] = newindex[x];
+
+    bool changed = (newcnt != svindexcnt);
+
+    for (int x = 0; x < newcnt && !changed; ++x)
+    {
+        saveindex_t const *const olde = sv_findindex(newindex[x].path);
+        changed = (olde == NULL || Bmemcmp(olde, &newindex[x], sizeof(saveindex_t)));
+    }
+
+    Bfree(svindex);
+    svindex    = newindex;
+    svindexcnt = newcnt;
+
+    if (changed)
+        sv_writeindex();
+
     g_nummenusaves = 0;
     for (int x = g_numinternalsaves-1; x >= 0; --x)
     {
@@ -257,6 +470,8 @@ static void ReadSaveGameHeaders_Internal(void)
 
 void ReadSaveGameHeaders(void)
 {
+    G_WaitForSaveGame();
+
     ReadSaveGameHeaders_Internal();
 
     if (!ud.autosavedeletion)
@@ -331,6 +546,8 @@ static int different_user_map;
 // XXX: keyboard input 'blocked' after load fail? (at least ESC?)
 int32_t G_LoadPlayer(savebrief_t & sv)
 {
+    G_WaitForSaveGame();
+
     int const fil = kopen4loadfrommod(sv.path, 0);
 
     if (fil == -1)
@@ -481,6 +698,8 @@ void G_DeleteSave(savebrief_t const & sv)
     if (!sv.isValid())
         return;
 
+    G_WaitForSaveGame();
+
     char temp[BMAX_PATH];
 
     if (G_ModDirSnprintf(temp, sizeof(temp), "%s", sv.path))
@@ -490,6 +709,7 @@ void G_DeleteSave(savebrief_t const & sv)
     }
 
     unlink(temp);
+    sv_dropindex(sv.path);
 }
 
 void G_DeleteOldSaves(void)
@@ -519,8 +739,150 @@ uint16_t G_CountOldSaves(void)
     return bad;
 }
 
+// Savegames are written in the background: G_SavePlayer() writes the header
+// and screenshot directly, but the rest of the state goes through sv_fwrite()
+// and sv_dfwrite_LZ4(), which copy it into memory instead of compressing and
+// writing it. A thread of its own then compresses and writes the copy in order
+// and closes the file, and G_CheckSaveGame() reports the result on the main
+// thread. Only one save is in flight at a time: starting another one, reading
+// the save headers or loading waits for it first.
+
+typedef struct
+{
+    uint32_t size;
+    uint32_t compress;
+} svchunk_t;
+
+static struct
+{
+    FILE *   fil;
+    bool     deferring;  // while the main thread is serializing
+    uint8_t *buf;
+    size_t   size, allocsize;
+
+    void *               thread;
+    std::atomic<int32_t> done;
+    int32_t              failed;
+    char                 path[BMAX_PATH];
+} svasync;
+
+static void sv_deferwrite(void const *ptr, uint32_t size, uint32_t compress)
+{
+    size_t const newsize = svasync.size + sizeof(svchunk_t) + size;
+
+    if (newsize > svasync.allocsize)
+    {
+        svasync.allocsize = max(newsize, svasync.allocsize * 2);
+        svasync.buf = (uint8_t *)Xrealloc(svasync.buf, svasync.allocsize);
+    }
+
+    svchunk_t const chunk = { size, compress };
+
+    Bmemcpy(svasync.buf + svasync.size, &chunk, sizeof(svchunk_t));
+    Bmemcpy(svasync.buf + svasync.size + sizeof(svchunk_t), ptr, size);
+    svasync.size = newsize;
+}
+
+void sv_fwrite(void const *ptr, bsize_t size, bsize_t cnt, FILE *fil)
+{
+    if (svasync.deferring && fil == svasync.fil)
+        sv_deferwrite(ptr, size * cnt, 0);
+    else
+        fwrite(ptr, size, cnt, fil);
+}
+
+void sv_dfwrite_LZ4(void const *ptr, bsize_t size, bsize_t cnt, FILE *fil)
+{
+    if (svasync.deferring && fil == svasync.fil)
+        sv_deferwrite(ptr, size * cnt, 1);
+    else
+        dfwrite_LZ4(ptr, size, cnt, fil);
+}
+
+// Same output as dfwrite_LZ4(), which can't be used here because it shares
+// its compression buffer with everything else on the main thread.
+static void sv_asyncjob(int32_t UNUSED(part), int32_t UNUSED(numparts), void *UNUSED(data))
+{
+    UNREFERENCED_CONST_PARAMETER(part);
+    UNREFERENCED_CONST_PARAMETER(numparts);
+    UNREFERENCED_CONST_PARAMETER(data);
+
+    char *  comp     = NULL;
+    int32_t compsize = 0;
+
+    for (size_t ofs = 0; ofs < svasync.size;)
+    {
+        svchunk_t chunk;
+
+        Bmemcpy(&chunk, svasync.buf + ofs, sizeof(svchunk_t));
+
+        char const *const ptr = (char const *)svasync.buf + ofs + sizeof(svchunk_t);
+
+        if (chunk.compress)
+        {
+            int32_t const bound = LZ4_compressBound(chunk.size);
+
+            if (bound > compsize)
+                comp = (char *)Xrealloc(comp, compsize = bound);
+
+            int32_t const leng   = LZ4_compress_fast(ptr, comp, chunk.size, bound, lz4CompressionLevel);
+            int32_t const swleng = B_LITTLE32(leng);
+
+            fwrite(&swleng, sizeof(swleng), 1, svasync.fil);
+            fwrite(comp, leng, 1, svasync.fil);
+        }
+        else
+            fwrite(ptr, chunk.size, 1, svasync.fil);
+
+        ofs += sizeof(svchunk_t) + chunk.size;
+    }
+
+    Bfree(comp);
+
+    svasync.failed |= ferror(svasync.fil);
+    svasync.failed |= fclose(svasync.fil);
+    svasync.done = 1;
+}
+
+static void G_FinishSaveGame(void)
+{
+    if (svasync.thread)
+        threadpool_join(svasync.thread);
+
+    if (svasync.failed)
+        OSD_Printf("G_SavePlayer: failed writing \"%s\"\n", svasync.path);
+
+    if (!g_netServer && ud.multimode < 2)
+    {
+        Bstrcpy(apStrings[QUOTE_RESERVED4], svasync.failed ? "^10Failed Saving Game" : "Game Saved");
+        P_DoQuote(QUOTE_RESERVED4, g_player[myconnectindex].ps);
+    }
+
+    svasync.fil    = NULL;
+    svasync.thread = NULL;
+    svasync.done   = 0;
+    svasync.failed = 0;
+    svasync.size   = 0;
+    DO_FREE_AND_NULL(svasync.buf);
+    svasync.allocsize = 0;
+}
+
+void G_CheckSaveGame(void)
+{
+    if (svasync.fil && svasync.done)
+        G_FinishSaveGame();
+}
+
+void G_WaitForSaveGame(void)
+{
+    if (svasync.fil)
+        G_FinishSaveGame();
+}
+
 int32_t G_SavePlayer(savebrief_t & sv, bool isAutoSave)
 {
+    G_WaitForSaveGame();
+
 #ifdef __ANDROID__
     G_SavePalette();
 #endif
@@ -577,20 +939,22 @@ int32_t G_SavePlayer(savebrief_t & sv, bool isAutoSave)
 
     VM_OnEvent(EVENT_SAVEGAME, g_player[screenpeek].ps->i, screenpeek);
 
+    sv_dropindex(sv.path);
+
     // SAVE!
+    svasync.fil = fil;
+    svasync.deferring = true;
     sv_saveandmakesnapshot(fil, sv.name, 0, 0, 0, 0, isAutoSave);
-
-    fclose(fil);
-
-    if (!g_netServer && ud.multimode < 2)
-    {
+    svasync.deferring = false;
 #ifdef LUNATIC
-        if (!g_savedOK)
-            Bstrcpy(apStrings[QUOTE_RESERVED4], "^10Failed Saving Game");
-        else
+    svasync.failed = !g_savedOK;
 #endif
-            Bstrcpy(apStrings[QUOTE_RESERVED4], "Game Saved");
-        P_DoQuote(QUOTE_RESERVED4, g_player[myconnectindex].ps);
+    Bstrncpyz(svasync.path, temp, sizeof(svasync.path));
+
+    if ((svasync.thread = threadpool_spawn(sv_asyncjob, NULL)) == NULL)
+    {
+        sv_asyncjob(0, 1, NULL);
+        G_FinishSaveGame();
     }
 
     ready2send = 1;
@@ -721,7 +1085,7 @@ static uint8_t *writespecdata(const dataspec_t *spec, FILE *fil, uint8_t *dump)
             continue;
         else if (spec->flags & DS_STRING)
         {
-            fwrite(spec->ptr, Bstrlen((const char *)spec->ptr), 1, fil);  // not null-terminated!
+            sv_fwrite(spec->ptr, Bstrlen((const char *)spec->ptr), 1, fil);  // not null-terminated!
             continue;
         }
 
@@ -742,9 +1106,9 @@ static uint8_t *writespecdata(const dataspec_t *spec, FILE *fil, uint8_t *dump)
         if (fil)
         {
             if ((spec->flags & DS_CMP) || ((spec->flags & DS_CNTMASK) == 0 && spec->size * cnt <= savegame_comprthres))
-                fwrite(ptr, spec->size, cnt, fil);
+                sv_fwrite(ptr, spec->size, cnt, fil);
             else
-                dfwrite_LZ4((void *)ptr, spec->size, cnt, fil);
+                sv_dfwrite_LZ4(ptr, spec->size, cnt, fil);
         }
 
         if (dump && (spec->flags & (DS_NOCHK|DS_CMP)) == 0)
@@ -849,7 +1213,12 @@ static int32_t readspecdata(const dataspec_t *spec, int32_t fil, uint8_t **dumpv
 #define VAL(bits,p) (*(UINT(bits) const *)(p))
 #define WVAL(bits,p) (*(UINT(bits) *)(p))
 
-static void docmpsd(const void *ptr, void *dump, uint32_t size, uint32_t cnt, uint8_t **diffvar)
+// Most of the state is unchanged from one diff to the next, so docmpsd() first
+// compares it a block at a time with memcmp() and only looks at the elements of
+// the blocks that differ. The diff written is the same either way.
+#define SV_DIFFBLOCKSIZ 128
+
+static void docmpsd(const void *ptr, void *dump, uint32_t size, uint32_t cnt, uint8_t **diffvar, bool blockcmp = true)
 {
     uint8_t *retdiff = *diffvar;
 
@@ -870,24 +1239,34 @@ static void docmpsd(const void *ptr, void *dump, uint32_t size, uint32_t cnt, ui
             case 1: CPSINGLEVAL(8); return;
         }
 
-#define CPELTS(Idxbits, Datbits)             \
-    do                                       \
-    {                                        \
-        for (int i = 0; i < nelts; i++)      \
-        {                                    \
-            if (*p != *op)                   \
-            {                                \
-                *op = *p;                    \
-                WVAL(Idxbits, retdiff) = i;  \
-                retdiff += BYTES(Idxbits);   \
-                WVAL(Datbits, retdiff) = *p; \
-                retdiff += BYTES(Datbits);   \
-            }                                \
-            p++;                             \
-            op++;                            \
-        }                                    \
-        WVAL(Idxbits, retdiff) = -1;         \
-        retdiff += BYTES(Idxbits);           \
+#define CPELTS(Idxbits, Datbits)                                           \
+    do                                                                     \
+    {                                                                      \
+        int const blockelts = SV_DIFFBLOCKSIZ / BYTES(Datbits);            \
+        for (int i = 0; i < nelts;)                                        \
+        {                                                                  \
+            int const n = min(nelts - i, blockelts);                       \
+            if (blockcmp && !Bmemcmp(p, op, n * BYTES(Datbits)))           \
+            {                                                              \
+                i += n, p += n, op += n;                                   \
+                continue;                                                  \
+            }                                                              \
+            for (int const end = i + n; i < end; i++)                      \
+            {                                                              \
+                if (*p != *op)                                             \
+                {                                                          \
+                    *op = *p;                                              \
+                    WVAL(Idxbits, retdiff) = i;                            \
+                    retdiff += BYTES(Idxbits);                             \
+                    WVAL(Datbits, retdiff) = *p;                           \
+                    retdiff += BYTES(Datbits);                             \
+                }                                                          \
+                p++;                                                       \
+                op++;                                                      \
+            }                                                              \
+        }                                                                  \
+        WVAL(Idxbits, retdiff) = -1;                                       \
+        retdiff += BYTES(Idxbits);                                         \
     } while (0)
 
 #define CPDATA(Datbits)                                                  \
@@ -931,7 +1310,7 @@ static int32_t getnumvar(const dataspec_t *spec)
 }
 
 // update dump at *dumpvar with new state and write diff to *diffvar
-static void cmpspecdata(const dataspec_t *spec, uint8_t **dumpvar, uint8_t **diffvar)
+static void cmpspecdata(const dataspec_t *spec, uint8_t **dumpvar, uint8_t **diffvar, bool blockcmp = true)
 {
     uint8_t * dump   = *dumpvar;
     uint8_t * diff   = *diffvar;
@@ -971,7 +1350,7 @@ static void cmpspecdata(const dataspec_t *spec, uint8_t **dumpvar, uint8_t **dif
 
         uint8_t * const tmptr = diff;
 
-        docmpsd(ptr, dump, spec->size, cnt, &diff);
+        docmpsd(ptr, dump, spec->size, cnt, &diff, blockcmp);
 
         if (diff != tmptr)
             (*diffvar + slen)[eltnum>>3] |= 1<<(eltnum&7);
@@ -1212,6 +1591,7 @@ static const dataspec_t svgm_secwsp[] =
     { DS_NOCHK, &numsectors, sizeof(numsectors), 1 },
     { DS_MAINAR|DS_CNT(numsectors), &sector, sizeof(sectortype), (intptr_t)&numsectors },
     { DS_MAINAR, &sprite, sizeof(spritetype), MAXSPRITES },
+    { DS_LOADFN|DS_PROTECTFN, (void *)&sectgrid_invalidate, 0, 1 },
 #ifdef YAX_ENABLE
     { DS_NOCHK, &numyaxbunches, sizeof(numyaxbunches), 1 },
 # if !defined NEW_MAP_FORMAT
@@ -1564,6 +1944,13 @@ int32_t sv_loadheader(int32_t fil, int32_t spot, savehead_t *h)
         return -1;
     }
 
+    return sv_checkheader(spot, h);
+}
+
+static int32_t sv_checkheader(int32_t spot, savehead_t *h)
+{
+    int32_t havedemo = (spot < 0);
+
     if (Bmemcmp(h->headerstr, "E32SAVEGAME", 11)
 #if 1
         && Bmemcmp(h->headerstr, "EDuke32SAVE", 11)
@@ -1697,23 +2084,28 @@ int32_t sv_loadsnapshot(int32_t fil, int32_t spot, savehead_t *h)
 }
 
 
-uint32_t sv_writediff(FILE *fil)
+// update the snapshot at dump with the current state, returns the end of the diff written to diff
+static uint8_t *sv_makediff(uint8_t *dump, uint8_t *diff, bool blockcmp)
 {
-    uint8_t *p = svsnapshot;
-    uint8_t *d = svdiff;
+    uint8_t *p = dump;
 
-    cmpspecdata(svgm_udnetw, &p, &d);
-    cmpspecdata(svgm_secwsp, &p, &d);
-    cmpspecdata(svgm_script, &p, &d);
-    cmpspecdata(svgm_anmisc, &p, &d);
+    cmpspecdata(svgm_udnetw, &p, &diff, blockcmp);
+    cmpspecdata(svgm_secwsp, &p, &diff, blockcmp);
+    cmpspecdata(svgm_script, &p, &diff, blockcmp);
+    cmpspecdata(svgm_anmisc, &p, &diff, blockcmp);
 #if !defined LUNATIC
-    cmpspecdata((const dataspec_t *)svgm_vars, &p, &d);
+    cmpspecdata((const dataspec_t *)svgm_vars, &p, &diff, blockcmp);
 #endif
 
-    if (p != svsnapshot+svsnapsiz)
-        OSD_Printf("sv_writediff: dump+siz=%p, p=%p!\n", svsnapshot+svsnapsiz, p);
+    if (p != dump+svsnapsiz)
+        OSD_Printf("sv_writediff: dump+siz=%p, p=%p!\n", dump+svsnapsiz, p);
 
-    uint32_t const diffsiz = d - svdiff;
+    return diff;
+}
+
+uint32_t sv_writediff(FILE *fil)
+{
+    uint32_t const diffsiz = sv_makediff(svsnapshot, svdiff, true) - svdiff;
 
     fwrite("dIfF",4,1,fil);
     fwrite(&diffsiz, sizeof(diffsiz), 1, fil);
@@ -1726,6 +2118,50 @@ uint32_t sv_writediff(FILE *fil)
     return diffsiz;
 }
 
+// Times the diff of the current state against the demo snapshot, i.e. the state
+// as of the last diff, with and without the block comparison. Neither the
+// snapshot nor the demo are touched.
+void sv_diffbenchmark(int32_t numiters)
+{
+    if (!svsnapshot)
+    {
+        OSD_Printf("Only available while recording or playing back a demo with diffs.\n");
+        return;
+    }
+
+    uint8_t *const dump[2] = { (uint8_t *)Xmalloc(svsnapsiz), (uint8_t *)Xmalloc(svsnapsiz) };
+    uint8_t *const diff[2] = { (uint8_t *)Xmalloc(svdiffsiz), (uint8_t *)Xmalloc(svdiffsiz) };
+    uint32_t diffsiz[2] = {};
+    double time[2] = {};
+
+    for (bssize_t i=0; i<numiters; i++)
+    {
+        for (bssize_t j=0; j<2; j++)
+        {
+            Bmemcpy(dump[j], svsnapshot, svsnapsiz);
+
+            double const t = timerGetHiTicks();
+            diffsiz[j] = sv_makediff(dump[j], diff[j], j) - diff[j];
+            time[j] += timerGetHiTicks() - t;
+        }
+    }
+
+    OSD_Printf("Demo diff benchmark, %d iterations over a %u byte snapshot (%u byte diff):\n",
+               numiters, svsnapsiz, diffsiz[1]);
+    OSD_Printf("  element compare: %8.3f ms/diff\n", time[0] / numiters);
+    OSD_Printf("  block compare:   %8.3f ms/diff, %.2fx\n", time[1] / numiters,
+               time[1] > 0.0 ? time[0] / time[1] : 0.0);
+
+    if (diffsiz[0] != diffsiz[1] || Bmemcmp(diff[0], diff[1], diffsiz[0]) || Bmemcmp(dump[0], dump[1], svsnapsiz))
+        OSD_Printf("  the two diffs DISAGREE!\n");
+
+    for (bssize_t j=0; j<2; j++)
+    {
+        Bfree(dump[j]);
+        Bfree(diff[j]);
+    }
+}
+
 int32_t sv_readdiff(int32_t fil)
 {
     int32_t diffsiz;
@@ -2019,10 +2455,10 @@ static uint8_t *dosaveplayer2(FILE *fil, uint8_t *mem)
             return mem;
         }
 
-        fwrite("\0\1LunaGVAR\3\4", 12, 1, fil);
+        sv_fwrite("\0\1LunaGVAR\3\4", 12, 1, fil);
         slen_ext = B_LITTLE32(slen);
-        fwrite(&slen_ext, sizeof(slen_ext), 1, fil);
-        dfwrite_LZ4(svcode, 1, slen, fil);  // cnt and sz swapped
+        sv_fwrite(&slen_ext, sizeof(slen_ext), 1, fil);
+        sv_dfwrite_LZ4(svcode, 1, slen, fil);  // cnt and sz swapped
 
         g_savedOK = 1;
     }
@@ -119,6 +119,7 @@ extern uint16_t g_nummenusaves;
 int32_t sv_updatestate(int32_t frominit);
 int32_t sv_readdiff(int32_t fil);
 uint32_t sv_writediff(FILE *fil);
+void sv_diffbenchmark(int32_t numiters);
 int32_t sv_loadheader(int32_t fil, int32_t spot, savehead_t *h);
 int32_t sv_loadsnapshot(int32_t fil, int32_t spot, savehead_t *h);
 int32_t sv_saveandmakesnapshot(FILE *fil, char const *name, int8_t spot, int8_t recdiffsp, int8_t diffcompress, int8_t synccompress, bool isAutoSave = false);
@@ -127,6 +128,10 @@ void G_DeleteSave(savebrief_t const & sv);
 void G_DeleteOldSaves(void);
 uint16_t G_CountOldSaves(void);
 int32_t G_SavePlayer(savebrief_t & sv, bool isAutoSave);
+void G_CheckSaveGame(void);
+void G_WaitForSaveGame(void);
+void sv_fwrite(void const *ptr, bsize_t size, bsize_t cnt, FILE *fil);
+void sv_dfwrite_LZ4(void const *ptr, bsize_t size, bsize_t cnt, FILE *fil);
 int32_t G_LoadPlayer(savebrief_t & sv);
 int32_t G_LoadSaveHeaderNew(char const *fn, savehead_t *saveh);
 void ReadSaveGameHeaders(void);
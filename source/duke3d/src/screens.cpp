@@ -705,7 +705,7 @@ static void G_PrintCoords(int32_t snum)
 
 #if !defined DEBUG_ALLOCACHE_AS_MALLOC
 extern int32_t cacnum;
-extern cactype cac [];
+extern cactype *caclast;
 #endif
 
 static void G_ShowCacheLocks(void)
@@ -716,14 +716,15 @@ static void G_ShowCacheLocks(void)
     int k = 0;
 
 #if !defined DEBUG_ALLOCACHE_AS_MALLOC
-    for (int i=cacnum-1; i>=0; i--)
+    int i = cacnum-1;
+    for (cactype const *blk = caclast; blk; blk = blk->prev, i--)
     {
-        if ((*cac[i].lock) != 200 && (*cac[i].lock) != 1)
+        if ((*blk->lock) != 200 && (*blk->lock) != 1)
         {
             if (k >= ydim-12)
                 break;
 
-            Bsprintf(tempbuf, "Locked- %d: Leng:%d, Lock:%d", i, cac[i].leng, *cac[i].lock);
+            Bsprintf(tempbuf, "Locked- %d: Leng:%d, Lock:%d", i, blk->leng, *blk->lock);
             printext256(0L, k, COLOR_WHITE, -1, tempbuf, 1);
             k += 6;
         }
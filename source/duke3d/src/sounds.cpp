@@ -28,6 +28,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #define DQSIZE 256
 
+// voices handed to the mixer at once by S_Update()
+#define S_UPDATEBATCH 64
+
 int32_t g_numEnvSoundsPlaying, g_highestSoundIdx = 0;
 
 static int32_t MusicIsWaveform = 0;
@@ -40,6 +43,67 @@ std::atomic<uint32_t> dnum;
 uint32_t dq[DQSIZE];
 static mutex_t m_callback;
 
+// Sound slots holding a voice, as sndnum*MAXSOUNDINSTANCES + slot like the
+// callback values, so that walking the playing sounds does not mean walking
+// every defined one. Slots are added as they are filled by S_PlaySound() and
+// S_PlaySound3D() and removed when S_Cleanup() picks up their S_Callback().
+static uint16_t ActiveSlots[MAXSOUNDS*MAXSOUNDINSTANCES];
+static uint16_t ActiveSlotIndex[MAXSOUNDS*MAXSOUNDINSTANCES];
+static int32_t  NumActiveSlots;
+
+// Sounds that always play at the same pitch are converted on first use to
+// 16-bit PCM at the mixing rate, which the mixer reads straight through rather
+// than resampling. The copies are cache blocks with lock bytes of their own,
+// raised above 199 while a voice plays from them like g_soundlocks, so that
+// they are evicted in favour of anything else once idle and converted again
+// when next needed.
+typedef struct
+{
+    char *      ptr;
+    char const *src;         // the sound data it was converted from
+    int32_t     siz, alloc;  // siz < 0: can't be converted, 0: not converted yet
+    int16_t     pitch;
+    uint8_t     slots;       // voices playing from ptr
+} soundcvt_t;
+
+static soundcvt_t SoundCvt[MAXSOUNDS];
+static char       SoundCvtLocks[MAXSOUNDS];
+
+// larger sounds stay as they are, rather than take up several times the memory
+#define S_CVTMAXSIZE (256<<10)
+
+static inline bool S_SlotIsActive(int slotNum)
+{
+    int const i = ActiveSlotIndex[slotNum];
+    return i < NumActiveSlots && ActiveSlots[i] == slotNum;
+}
+
+static void S_AddActiveSlot(int slotNum)
+{
+    if (S_SlotIsActive(slotNum))
+        return;
+
+    ActiveSlotIndex[slotNum] = NumActiveSlots;
+    ActiveSlots[NumActiveSlots++] = slotNum;
+}
+
+static void S_RemoveActiveSlot(int slotNum)
+{
+    if (!S_SlotIsActive(slotNum))
+        return;
+
+    int const i    = ActiveSlotIndex[slotNum];
+    int const last = ActiveSlots[--NumActiveSlots];
+
+    ActiveSlots[i]        = last;
+    ActiveSlotIndex[last] = i;
+}
+
+static inline assvoice_t &S_SlotVoice(int slotNum)
+{
+    return g_sounds[slotNum / MAXSOUNDINSTANCES].voices[slotNum & (MAXSOUNDINSTANCES - 1)];
+}
+
 void S_SoundStartup(void)
 {
 #ifdef MIXERTYPEWIN
@@ -50,6 +114,8 @@ void S_SoundStartup(void)
 
     initprintf("Initializing sound... ");
 
+    FX_SetBufferFrames(ud.config.BufferSize, ud.config.AdaptiveBuffer);
+
     if (FX_Init(ud.config.NumVoices, ud.config.NumChannels, ud.config.MixRate, initdata) != FX_Ok)
     {
         initprintf("failed! %s\n", FX_ErrorString(FX_Error));
@@ -73,6 +139,19 @@ void S_SoundStartup(void)
         g_soundlocks[i] = 199;
     }
 
+    NumActiveSlots = 0;
+
+    // the mixing rate may have changed
+    for (int i = 0; i < MAXSOUNDS; ++i)
+    {
+        SoundCvt[i].src   = NULL;
+        SoundCvt[i].siz   = 0;
+        SoundCvt[i].slots = 0;
+
+        if (SoundCvt[i].ptr)
+            SoundCvtLocks[i] = 1;
+    }
+
     cacheAllSounds();
 
     FX_SetVolume(ud.config.FXVolume);
@@ -117,6 +196,20 @@ void S_MusicShutdown(void)
         initprintf("%s\n", MUSIC_ErrorString(MUSIC_ErrorCode));
 }
 
+void S_UpdateBuffer(void)
+{
+    FX_SetBufferFrames(ud.config.BufferSize, ud.config.AdaptiveBuffer);
+
+    if (!FX_Update())
+        return;
+
+#ifndef MIXERTYPEWIN
+    // SDL_mixer's MIDI playback stopped along with the device it shares
+    if (!MusicIsWaveform && ud.config.MusicToggle)
+        S_RestartMusic();
+#endif
+}
+
 void S_PauseMusic(bool paused)
 {
     if (MusicPaused == paused || (MusicIsWaveform && MusicVoice < 0))
@@ -143,11 +236,12 @@ void S_PauseSounds(bool paused)
 
     SoundPaused = paused;
 
-    for (int i = 0; i <= g_highestSoundIdx; ++i)
+    for (int i = 0; i < NumActiveSlots; ++i)
     {
-        for (auto & voice : g_sounds[i].voices)
-            if (voice.id > 0)
-                FX_PauseVoice(voice.id, paused);
+        auto const &voice = S_SlotVoice(ActiveSlots[i]);
+
+        if (voice.id > 0)
+            FX_PauseVoice(voice.id, paused);
     }
 }
 
@@ -402,8 +496,16 @@ void S_Cleanup(void)
 
         int const vidx = num & (MAXSOUNDINSTANCES - 1);
 
+        S_RemoveActiveSlot(num);
+
         num = (num - vidx) / MAXSOUNDINSTANCES;
 
+        if (SoundCvt[num].slots & (1 << vidx))
+        {
+            SoundCvt[num].slots &= ~(1 << vidx);
+            --SoundCvtLocks[num];
+        }
+
         auto &snd   = g_sounds[num];
         auto &voice = g_sounds[num].voices[vidx];
 
@@ -445,11 +547,27 @@ int32_t S_LoadSound(int num)
         return 0;
     }
 
-    int32_t l = kfilelength(fp);
+    int32_t l;
+    char const * const mapped = kfilemapping(fp, &l);
+
     g_soundlocks[num] = 200;
+
+    if (mapped)
+    {
+        // The mixer only reads sound data and group files stay mapped until
+        // uninitgroupfile() at shutdown, so play straight out of the mapping.
+        // The sound is never registered with the cache and can't be evicted.
+        snd.siz = l;
+        snd.ptr = (char *)(intptr_t)mapped;
+        kclose(fp);
+        return l;
+    }
+
+    l = kfilelength(fp);
     snd.siz = l;
     cacheAllocateBlock((intptr_t *)&snd.ptr, l, (char *)&g_soundlocks[num]);
     l = kread(fp, snd.ptr, l);
+
     kclose(fp);
 
     return l;
@@ -468,6 +586,54 @@ void cacheAllSounds(void)
         }
 }
 
+// returns whether sound num is to be played at pitch from its converted copy
+static bool S_UseConvertedSound(int num, int pitch)
+{
+    auto const &snd = g_sounds[num];
+    auto &      cvt = SoundCvt[num];
+
+    // converting at every random pitch would cost more than resampling
+    if (!ud.config.ResampleCache || snd.ps != snd.pe || pitch != snd.ps)
+        return false;
+
+    // converted, not convertible, or waiting for a block too small for it to go
+    if (cvt.src == snd.ptr && cvt.pitch == pitch && (cvt.siz < 0 || cvt.ptr != NULL))
+        return cvt.siz > 0;
+
+    // still playing from a conversion made for different sound data
+    if (cvt.ptr != NULL && SoundCvtLocks[num] >= 200)
+        return false;
+
+    cvt.src   = snd.ptr;
+    cvt.pitch = pitch;
+    cvt.siz   = FX_ConvertSound(snd.ptr, snd.siz, pitch, NULL);
+
+    if (cvt.siz <= 0 || cvt.siz > S_CVTMAXSIZE)
+    {
+        cvt.siz = -1;
+        return false;
+    }
+
+    // A block that's still registered with the cache can't be allocated
+    // again. Play resampled until the cache drops it, then convert anew.
+    if (cvt.ptr != NULL && cvt.alloc < cvt.siz)
+    {
+        cvt.siz = 0;
+        return false;
+    }
+
+    if (cvt.ptr == NULL)
+    {
+        SoundCvtLocks[num] = 199;
+        cvt.alloc = cvt.siz;
+        cacheAllocateBlock((intptr_t *)&cvt.ptr, cvt.alloc, &SoundCvtLocks[num]);
+    }
+
+    FX_ConvertSound(snd.ptr, snd.siz, pitch, cvt.ptr);
+
+    return true;
+}
+
 static inline int S_GetPitch(int num)
 {
     auto const &snd   = g_sounds[num];
@@ -640,8 +806,8 @@ int S_PlaySound3D(int num, int spriteNum, const vec3_t *pos)
             return -1;
 
         // don't play if any Duke talk sounds are already playing
-        for (j = 0; j <= g_highestSoundIdx; ++j)
-            if ((g_sounds[j].m & SF_TALK) && g_sounds[j].num > 0)
+        for (j = 0; j < NumActiveSlots; ++j)
+            if (g_sounds[ActiveSlots[j] / MAXSOUNDINSTANCES].m & SF_TALK)
                 return -1;
     }
     else if (snd.m & SF_DTAG)  // Duke-Tag sound
@@ -722,12 +888,19 @@ int S_PlaySound3D(int num, int spriteNum, const vec3_t *pos)
         return -1;
     }
 
+    bool const cvtp = S_UseConvertedSound(sndNum, pitch);
+    char *const ptr  = cvtp ? SoundCvt[sndNum].ptr : snd.ptr;
+    int const   siz  = cvtp ? SoundCvt[sndNum].siz : snd.siz;
+
+    if (cvtp)
+        pitch = 0;
+
     // XXX: why is 'right' 0?
     // Ambient MUSICANDSFX always start playing using the 3D routines!
     int const ambsfxp = S_IsAmbientSFX(spriteNum);
-    int const voice = (repeatp && !ambsfxp) ? FX_Play(snd.ptr, snd.siz, 0, -1, pitch, sndist >> 6, sndist >> 6, 0, snd.pr,
+    int const voice = (repeatp && !ambsfxp) ? FX_Play(ptr, siz, 0, -1, pitch, sndist >> 6, sndist >> 6, 0, snd.pr,
                                                       snd.volume, (sndNum * MAXSOUNDINSTANCES) + sndSlot)
-                                            : FX_Play3D(snd.ptr, snd.siz, repeatp ? FX_LOOP : FX_ONESHOT, pitch, sndang >> 4, sndist >> 6,
+                                            : FX_Play3D(ptr, siz, repeatp ? FX_LOOP : FX_ONESHOT, pitch, sndang >> 4, sndist >> 6,
                                                         snd.pr, snd.volume, (sndNum * MAXSOUNDINSTANCES) + sndSlot);
 
     if (voice <= FX_Ok)
@@ -736,12 +909,22 @@ int S_PlaySound3D(int num, int spriteNum, const vec3_t *pos)
         return -1;
     }
 
+    if (cvtp)
+    {
+        if (++SoundCvtLocks[sndNum] < 200)
+            SoundCvtLocks[sndNum] = 200;
+
+        SoundCvt[sndNum].slots |= 1 << sndSlot;
+    }
+
     snd.num++;
     snd.voices[sndSlot].owner = spriteNum;
     snd.voices[sndSlot].id    = voice;
     snd.voices[sndSlot].dist  = sndist >> 6;
     snd.voices[sndSlot].clock = 0;
 
+    S_AddActiveSlot((sndNum * MAXSOUNDINSTANCES) + sndSlot);
+
     return voice;
 }
 
@@ -765,7 +948,7 @@ int S_PlaySound(int num)
     if ((!(ud.config.VoiceToggle & 1) && (snd.m & SF_TALK)) || ((snd.m & SF_ADULT) && ud.lockout) || !FX_VoiceAvailable(snd.pr))
         return -1;
 
-    int const pitch = S_GetPitch(num);
+    int pitch = S_GetPitch(num);
 
     if (++g_soundlocks[num] < 200)
         g_soundlocks[num] = 200;
@@ -778,9 +961,16 @@ int S_PlaySound(int num)
         return -1;
     }
 
-    int const voice = (snd.m & SF_LOOP) ? FX_Play(snd.ptr, snd.siz, 0, -1, pitch, LOUDESTVOLUME, LOUDESTVOLUME,
+    bool const cvtp = S_UseConvertedSound(num, pitch);
+    char *const ptr  = cvtp ? SoundCvt[num].ptr : snd.ptr;
+    int const   siz  = cvtp ? SoundCvt[num].siz : snd.siz;
+
+    if (cvtp)
+        pitch = 0;
+
+    int const voice = (snd.m & SF_LOOP) ? FX_Play(ptr, siz, 0, -1, pitch, LOUDESTVOLUME, LOUDESTVOLUME,
                                                   LOUDESTVOLUME, snd.siz, snd.volume, (num * MAXSOUNDINSTANCES) + sndnum)
-                                        : FX_Play3D(snd.ptr, snd.siz, FX_ONESHOT, pitch, 0, 255 - LOUDESTVOLUME, snd.pr, snd.volume,
+                                        : FX_Play3D(ptr, siz, FX_ONESHOT, pitch, 0, 255 - LOUDESTVOLUME, snd.pr, snd.volume,
                                                     (num * MAXSOUNDINSTANCES) + sndnum);
 
     if (voice <= FX_Ok)
@@ -789,12 +979,22 @@ int S_PlaySound(int num)
         return -1;
     }
 
+    if (cvtp)
+    {
+        if (++SoundCvtLocks[num] < 200)
+            SoundCvtLocks[num] = 200;
+
+        SoundCvt[num].slots |= 1 << sndnum;
+    }
+
     snd.num++;
     snd.voices[sndnum].owner = -1;
     snd.voices[sndnum].id    = voice;
     snd.voices[sndnum].dist  = 255 - LOUDESTVOLUME;
     snd.voices[sndnum].clock = 0;
 
+    S_AddActiveSlot((num * MAXSOUNDINSTANCES) + sndnum);
+
     return voice;
 }
 
@@ -856,7 +1056,11 @@ void S_ChangeSoundPitch(int soundNum, int spriteNum, int pitchoffset)
             if (EDUKE32_PREDICT_FALSE(spriteNum >= 0 && voice.id <= FX_Ok))
                 initprintf(OSD_ERROR "S_ChangeSoundPitch(): bad voice %d for sound ID %d!\n", voice.id, soundNum);
             else if (voice.id > FX_Ok && FX_SoundActive(voice.id))
-                FX_SetPitch(voice.id, pitchoffset);
+            {
+                // a converted copy already has its pitch applied
+                int const slot = &voice - g_sounds[soundNum].voices;
+                FX_SetPitch(voice.id, (SoundCvt[soundNum].slots & (1 << slot)) ? pitchoffset - SoundCvt[soundNum].pitch : pitchoffset);
+            }
             break;
         }
     }
@@ -885,36 +1089,45 @@ void S_Update(void)
         ca = sprite[ud.camerasprite].ang;
     }
 
-    int       sndnum  = 0;
-    int const highest = g_highestSoundIdx;
+    S_Cleanup();
 
-    do
+    // Voices that ended since S_Cleanup() are skipped by FX_Pan3DVoices().
+    int32_t handles[S_UPDATEBATCH], angles[S_UPDATEBATCH], distances[S_UPDATEBATCH];
+    int     numbatched = 0;
+
+    for (int i = 0; i < NumActiveSlots; ++i)
     {
-        if (g_sounds[sndnum].num == 0)
+        int const slotNum   = ActiveSlots[i];
+        auto &    voice     = S_SlotVoice(slotNum);
+        int const spriteNum = voice.owner;
+
+        if ((unsigned)spriteNum >= MAXSPRITES || voice.id <= FX_Ok)
             continue;
 
-        S_Cleanup();
+        int32_t sndist, sndang;
 
-        for (auto &voice : g_sounds[sndnum].voices)
-        {
-            int const spriteNum = voice.owner;
+        S_CalcDistAndAng(spriteNum, slotNum / MAXSOUNDINSTANCES, cs, ca, c, (const vec3_t *)&sprite[spriteNum], &sndist, &sndang);
 
-            if ((unsigned)spriteNum >= MAXSPRITES || voice.id <= FX_Ok || !FX_SoundActive(voice.id))
-                continue;
+        if (S_IsAmbientSFX(spriteNum))
+            g_numEnvSoundsPlaying++;
 
-            int32_t sndist, sndang;
+        // AMBIENT_SOUND
+        handles[numbatched]   = voice.id;
+        angles[numbatched]    = sndang >> 4;
+        distances[numbatched] = sndist >> 6;
 
-            S_CalcDistAndAng(spriteNum, sndnum, cs, ca, c, (const vec3_t *)&sprite[spriteNum], &sndist, &sndang);
+        if (++numbatched == S_UPDATEBATCH)
+        {
+            FX_Pan3DVoices(handles, angles, distances, numbatched);
+            numbatched = 0;
+        }
 
-            if (S_IsAmbientSFX(spriteNum))
-                g_numEnvSoundsPlaying++;
+        voice.dist = sndist >> 6;
+        voice.clock++;
+    }
 
-            // AMBIENT_SOUND
-            FX_Pan3D(voice.id, sndang >> 4, sndist >> 6);
-            voice.dist = sndist >> 6;
-            voice.clock++;
-        }
-    } while (++sndnum <= highest);
+    if (numbatched)
+        FX_Pan3DVoices(handles, angles, distances, numbatched);
 }
 
 // S_Callback() can be called from either the audio thread when a sound ends, or the main thread
@@ -966,14 +1179,9 @@ bool A_CheckSoundPlaying(int spriteNum, int soundNum)
 // Check if actor <i> is playing any sound.
 bool A_CheckAnySoundPlaying(int spriteNum)
 {
-    int const msp = g_highestSoundIdx;
-
-    for (int j = 0; j <= msp; ++j)
-    {
-        for (auto &voice : g_sounds[j].voices)
-            if (voice.owner == spriteNum)
-                return 1;
-    }
+    for (int j = 0; j < NumActiveSlots; ++j)
+        if (S_SlotVoice(ActiveSlots[j]).owner == spriteNum)
+            return 1;
 
     return 0;
 }
@@ -92,6 +92,7 @@ void S_StopEnvSound(int32_t num,int32_t i);
 void S_StopAllSounds(void);
 void S_StopMusic(void);
 void S_Update(void);
+void S_UpdateBuffer(void);
 void S_ChangeSoundPitch(int soundNum, int spriteNum, int pitchoffset);
 int32_t S_GetMusicPosition(void);
 void S_SetMusicPosition(int32_t position);
@@ -27,6 +27,7 @@ Prepared for public release: 03/28/2005 - Charlie Wiederhold, 3D Realms
 #define MAIN
 #define QUIET
 #include "build.h"
+#include "sectgrid.h"
 
 #include "keys.h"
 #include "names2.h"
@@ -890,6 +891,7 @@ int LoadGame(short save_num)
 
     MREAD(&numwalls,sizeof(numwalls),1,fil);
     MREAD(wall,sizeof(WALL),numwalls,fil);
+    sectgrid_invalidate();
 
     //Store all sprites to preserve indeces
     MREAD(&i, sizeof(i),1,fil);
@@ -24,6 +24,7 @@ Prepared for public release: 03/28/2005 - Charlie Wiederhold, 3D Realms
 */
 //-------------------------------------------------------------------------
 #include "build.h"
+#include "sectgrid.h"
 
 #include "names2.h"
 #include "panel.h"
@@ -401,6 +402,10 @@ int DoSlidorMoveWalls(short SpriteNum, int amt)
                 wall[pw].x -= amt;
                 wall[wall[w].point2].x -= amt;
                 wall[wall[wall[w].point2].point2].x -= amt;
+                sectgrid_movedwall(w);
+                sectgrid_movedwall(pw);
+                sectgrid_movedwall(wall[w].point2);
+                sectgrid_movedwall(wall[wall[w].point2].point2);
             }
             else
             {
@@ -425,6 +430,10 @@ int DoSlidorMoveWalls(short SpriteNum, int amt)
                 wall[pw].x += amt;
                 wall[wall[w].point2].x += amt;
                 wall[wall[wall[w].point2].point2].x += amt;
+                sectgrid_movedwall(w);
+                sectgrid_movedwall(pw);
+                sectgrid_movedwall(wall[w].point2);
+                sectgrid_movedwall(wall[wall[w].point2].point2);
             }
             else
             {
@@ -448,6 +457,10 @@ int DoSlidorMoveWalls(short SpriteNum, int amt)
                 wall[pw].y -= amt;
                 wall[wall[w].point2].y -= amt;
                 wall[wall[wall[w].point2].point2].y -= amt;
+                sectgrid_movedwall(w);
+                sectgrid_movedwall(pw);
+                sectgrid_movedwall(wall[w].point2);
+                sectgrid_movedwall(wall[wall[w].point2].point2);
             }
             else
             {
@@ -470,6 +483,10 @@ int DoSlidorMoveWalls(short SpriteNum, int amt)
                 wall[pw].y += amt;
                 wall[wall[w].point2].y += amt;
                 wall[wall[wall[w].point2].point2].y += amt;
+                sectgrid_movedwall(w);
+                sectgrid_movedwall(pw);
+                sectgrid_movedwall(wall[w].point2);
+                sectgrid_movedwall(wall[wall[w].point2].point2);
             }
             else
             {
@@ -24,6 +24,7 @@ Prepared for public release: 03/28/2005 - Charlie Wiederhold, 3D Realms
 */
 //-------------------------------------------------------------------------
 #include "build.h"
+#include "sectgrid.h"
 
 #include "keys.h"
 #include "names2.h"
@@ -1669,6 +1670,9 @@ void PreMapCombineFloors(void)
 
     }
 
+    // whole floors were moved
+    sectgrid_invalidate();
+
     // get rid of the sprites used
     TRAVERSE_SPRITE_STAT(headspritestat[STAT_FAF], SpriteNum, NextSprite)
     {
@@ -24,6 +24,7 @@ Prepared for public release: 03/28/2005 - Charlie Wiederhold, 3D Realms
 */
 //-------------------------------------------------------------------------
 #include "build.h"
+#include "sectgrid.h"
 
 #include "names2.h"
 #include "panel.h"
@@ -1752,6 +1753,7 @@ MovePoints(SECTOR_OBJECTp sop, short delta_ang, int nx, int ny)
             {
                 wp->x = rxy.x;
                 wp->y = rxy.y;
+                sectgrid_movedwall(k);
             }
         }
 
@@ -1989,6 +1991,7 @@ RefreshPoints(SECTOR_OBJECTp sop, int nx, int ny, SWBOOL dynamic)
                     {
                         wp->x = dx;
                         wp->y = dy;
+                        sectgrid_movedwall(k);
                     }
                 }
 
@@ -2155,6 +2158,7 @@ CollapseSectorObject(SECTOR_OBJECTp sop, int nx, int ny)
                 {
                     wp->x = nx;
                     wp->y = ny;
+                    sectgrid_movedwall(k);
                 }
             }
         }
@@ -24,6 +24,7 @@ Prepared for public release: 03/28/2005 - Charlie Wiederhold, 3D Realms
 */
 //-------------------------------------------------------------------------
 #include "build.h"
+#include "sectgrid.h"
 
 //#include "keys.h"
 #include "names2.h"
@@ -123,6 +124,7 @@ int DoWallMove(SPRITEp sp)
             {
                 wallp->x = sp->x + nx;
                 wallp->y = sp->y + ny;
+                sectgrid_movedwall(wallp - wall);
             }
 
             if (shade1)